@@ -12,6 +12,10 @@ extern const int TerminusBold18x10_glyph_bytes;
 extern const GlyphPointerMap TerminusBold18x10_glyph_ptr_map[];
 extern const int TerminusBold18x10_glyph_ptr_map_count;
 
+extern const int16_t TerminusBold18x10_glyph_ascii_lookup[];
+extern const uint16_t TerminusBold18x10_glyph_sorted_lookup[];
+extern const int TerminusBold18x10_glyph_sorted_lookup_count;
+
 extern const int TerminusBold18x10_glyph_widths[];
 extern const int TerminusBold18x10_glyph_heights[];
 extern const int TerminusBold18x10_glyph_vertical_offsets[];
@@ -19,4 +23,4 @@ extern const int TerminusBold18x10_glyph_horizontal_offsets[];
 
 extern const RasterFont TerminusBold18x10_font;
 
-#endif // z9_H
+#endif // TerminusBold18x10_H
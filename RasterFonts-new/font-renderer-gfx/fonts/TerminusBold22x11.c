@@ -3836,6 +3836,35 @@ const GlyphPointerMap TerminusBold22x11_glyph_ptr_map[] = {
     {0x04F9, TerminusBold22x11_glyph_1EB},
 };
 
+const int16_t TerminusBold22x11_glyph_ascii_lookup[128] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 
+    16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 
+    32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 
+    48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 
+    64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79, 
+    80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, -1
+};
+
+const uint16_t TerminusBold22x11_glyph_sorted_lookup[150] = {
+    128, 122, 129, 130, 131, 106, 100, 123, 101, 132, 133, 134, 
+    135, 136, 137, 138, 95, 139, 96, 124, 140, 98, 141, 142, 
+    143, 144, 102, 145, 103, 99, 104, 146, 105, 97, 107, 147, 
+    125, 108, 148, 149, 150, 151, 152, 153, 154, 155, 156, 157, 
+    110, 158, 159, 160, 161, 112, 162, 163, 164, 165, 166, 167, 
+    168, 169, 115, 170, 116, 111, 171, 119, 172, 118, 173, 174, 
+    175, 176, 177, 178, 179, 180, 181, 182, 183, 120, 184, 185, 
+    186, 117, 113, 121, 114, 187, 188, 189, 190, 191, 192, 193, 
+    194, 195, 196, 197, 198, 199, 200, 201, 202, 203, 204, 205, 
+    206, 207, 208, 209, 210, 211, 212, 213, 214, 215, 109, 216, 
+    217, 218, 219, 220, 221, 222, 223, 224, 126, 127, 225, 226, 
+    227, 228, 229, 230, 231, 232, 233, 234, 235, 236, 237, 238, 
+    239, 240, 241, 242, 243, 244
+};
+
+const int TerminusBold22x11_glyph_sorted_lookup_count = 150;
+
 const int TerminusBold22x11_glyph_widths[512] = {
     11,
     11,
@@ -5896,7 +5925,7 @@ const int TerminusBold22x11_glyph_horizontal_offsets[512] = {
     0
 };
 
-const int TerminusBold22x11_glyph_ptr_map_count = 512;
+const int TerminusBold22x11_glyph_ptr_map_count = 245;
 
 const RasterFont TerminusBold22x11_font = {
     .name = "TerminusBold22x11",
@@ -5908,5 +5937,8 @@ const RasterFont TerminusBold22x11_font = {
     .glyph_widths = TerminusBold22x11_glyph_widths,
     .glyph_heights = TerminusBold22x11_glyph_heights,
     .glyph_vertical_offsets = TerminusBold22x11_glyph_vertical_offsets,
-    .glyph_horizontal_offsets = TerminusBold22x11_glyph_horizontal_offsets
+    .glyph_horizontal_offsets = TerminusBold22x11_glyph_horizontal_offsets,
+    .glyph_ascii_lookup = TerminusBold22x11_glyph_ascii_lookup,
+    .glyph_sorted_lookup = TerminusBold22x11_glyph_sorted_lookup,
+    .glyph_sorted_count = TerminusBold22x11_glyph_sorted_lookup_count
 };
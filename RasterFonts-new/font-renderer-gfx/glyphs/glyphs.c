@@ -1,60 +1,15 @@
 // glyphs.c
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "glyphs.h"    // структури RasterFont та glyph_map
+#include "text_cache.h"
 #include "graphics.h"  // DrawRectangle, тощо
 #include "gfx.h"       // DrawPixel
-
-/*
- * utf8_strlen - підрахунок кількості Unicode символів у UTF-8 рядку.
- * Стандартна strlen рахує байти, а не символи, що може спотворювати довжину тексту,
- * особливо для кирилиці та інших багатобайтових символів.
- */
-int utf8_strlen(const char* s) {
-    int len = 0;
-    // Проходимо по рядку, декодуючи кожен UTF-8 символ
-    while (*s) {
-        uint32_t codepoint = 0;
-        int bytes = utf8_decode(s, &codepoint); // розпаковуємо один символ
-        s += bytes; // переходимо до наступного символу
-        len++; // лічильник символів
-    }
-    return len;
-}
-
-/*
- * utf8_decode - декодування одного UTF-8 символу з початку рядка str.
- * Записує decodед Unicode код символу у out_codepoint.
- * Повертає довжину символу у байтах (1-4).
- * Якщо символ некоректний, повертає 1 і код 0.
- */
-int utf8_decode(const char* str, uint32_t* out_codepoint) {
-    unsigned char c = (unsigned char)str[0];
-    if (c < 0x80) {
-        // Однобайтовий ASCII символ
-        *out_codepoint = c;
-        return 1;
-    } else if ((c & 0xE0) == 0xC0) {
-        // Дво-байтовий UTF-8 символ
-        *out_codepoint = ((str[0] & 0x1F) << 6) | (str[1] & 0x3F);
-        return 2;
-    } else if ((c & 0xF0) == 0xE0) {
-        // Трибайтовий UTF-8 символ
-        *out_codepoint = ((str[0] & 0x0F) << 12) | ((str[1] & 0x3F) << 6) | (str[2] & 0x3F);
-        return 3;
-    } else if ((c & 0xF8) == 0xF0) {
-        // Чотири байтовий UTF-8 символ
-        *out_codepoint = ((str[0] & 0x07) << 18) | ((str[1] & 0x3F) << 12) |
-        ((str[2] & 0x3F) << 6) | (str[3] & 0x3F);
-        return 4;
-    }
-    // Некоректний символ
-    *out_codepoint = 0;
-    return 1;
-}
-
+#include "render_pool.h" // RenderPool_Run
+#include "clip.h"      // GetVisibleRect, GetClipRect
 
 // Малюємо один гліф з урахуванням зсувів і масштабу
 // glyph - масив байтів гліфа (монохромний)
@@ -64,36 +19,40 @@ int utf8_decode(const char* str, uint32_t* out_codepoint) {
 // scale - масштаб (розмір пікселя)
 // vert_offset, horiz_offset - вертикальний і горизонтальний зсуви гліфа (пікселі)
 // color - колір пікселя
+// Кожен рядок гліфа розбивається на серії встановлених бітів, і кожна серія
+// малюється одним прямокутником (див. DrawBitmapSpans) замість scale*scale пікселів.
 void DrawGlyphWithOffsets(const uint8_t* glyph, int width, int height, int bytes_per_glyph,
                           int x, int y, int scale, int vert_offset, int horiz_offset, uint32_t color)
 {
-    int bytes_per_row = (width + 7) / 8;
+    (void)bytes_per_glyph;
     int draw_y = y + vert_offset * scale;
     int draw_x_base = x + horiz_offset * scale;
 
-    for (int row = 0; row < height; ++row) {
-        for (int byte = 0; byte < bytes_per_row; ++byte) {
-            uint8_t byte_val = glyph[row * bytes_per_row + byte];
-            for (int bit = 0; bit < 8; ++bit) {
-                int px = byte * 8 + bit;
-                if (px >= width) break;
-                if (byte_val & (0x80 >> bit)) {
-                    int draw_x = draw_x_base + px * scale;
-                    int draw_y_pixel = draw_y + row * scale;
-                    for (int dx = 0; dx < scale; ++dx) {
-                        for (int dy = 0; dy < scale; ++dy) {
-                            DrawPixel(draw_x + dx, draw_y_pixel + dy, color);
-                        }
-                    }
-                }
-            }
-        }
-    }
+    DrawBitmapSpans(glyph, width, height, draw_x_base, draw_y, scale, color);
 }
 
 // Пошук гліфа за Unicode кодом із вашого шрифту
 const GlyphPointerMap* FindGlyph(const RasterFont font, uint32_t unicode)
 {
+    if (font.glyph_ascii_lookup && font.glyph_sorted_lookup) {
+        // ASCII - пряма таблиця
+        if (unicode < 128) {
+            int index = font.glyph_ascii_lookup[unicode];
+            return (index >= 0) ? &font.glyph_map[index] : NULL;
+        }
+        // Решта - бінарний пошук по відсортованих індексах
+        int lo = 0, hi = font.glyph_sorted_count - 1;
+        while (lo <= hi) {
+            int mid = (lo + hi) / 2;
+            const GlyphPointerMap* entry = &font.glyph_map[font.glyph_sorted_lookup[mid]];
+            if (entry->unicode == unicode) return entry;
+            if (entry->unicode < unicode) lo = mid + 1;
+            else hi = mid - 1;
+        }
+        return NULL;
+    }
+
+    // Шрифт без таблиць пошуку - лінійний пошук
     for (int i = 0; i < font.glyph_count; ++i) {
         if (font.glyph_map[i].unicode == unicode) {
             return &font.glyph_map[i];
@@ -102,6 +61,186 @@ const GlyphPointerMap* FindGlyph(const RasterFont font, uint32_t unicode)
     return NULL;
 }
 
+// Таблиця ширин гліфів шрифту для вимірювання тексту. Будується один раз при першому
+// вимірюванні: коди до U+FFFF - сторінки по 256 кодів (як у таблиці Unicode PSF),
+// старші коди - через FindGlyph
+typedef struct {
+    const GlyphPointerMap* glyph_map; // Ключ: масив гліфів шрифту
+    int16_t* pages[256];              // Ширини для кодів сторінки, NULL - у сторінці немає гліфів
+    int16_t fallback;                 // Ширина для коду без гліфа (ширина пробілу, -1 - немає)
+    int top, bottom;                  // Рядки всіх гліфів відносно рядка тексту (без масштабу):
+                                      // від найменшого вертикального зсуву до найнижчого краю
+} RasterFontAdvances;
+
+// Таблиці всіх шрифтів, які вже вимірювались (шрифти - статичні дані, тож таблиці не звільняються)
+static RasterFontAdvances** advance_tables = NULL;
+static int advance_table_count = 0;
+
+// Ширина коду без таблиці: гліф, пробіл замість відсутнього гліфа, або -1
+static int FindGlyphAdvance(const RasterFont font, uint32_t codepoint)
+{
+    const GlyphPointerMap* glyph = FindGlyph(font, codepoint);
+    if (!glyph) glyph = FindGlyph(font, 32);
+    return glyph ? font.glyph_widths[glyph - font.glyph_map] : -1;
+}
+
+// Звільняє таблицю ширин (лише при невдалій побудові)
+static void FreeRasterFontAdvances(RasterFontAdvances* adv)
+{
+    for (int p = 0; p < 256; ++p) free(adv->pages[p]);
+    free(adv);
+}
+
+// Таблиця ширин шрифту (створюється при першому зверненні), NULL - не вдалося виділити пам’ять
+static const RasterFontAdvances* GetRasterFontAdvances(const RasterFont font)
+{
+    for (int i = 0; i < advance_table_count; ++i) {
+        if (advance_tables[i]->glyph_map == font.glyph_map) return advance_tables[i];
+    }
+
+    RasterFontAdvances** tables = realloc(advance_tables, (advance_table_count + 1) * sizeof(*tables));
+    if (!tables) return NULL;
+    advance_tables = tables;
+
+    RasterFontAdvances* adv = calloc(1, sizeof(RasterFontAdvances));
+    if (!adv) return NULL;
+    adv->glyph_map = font.glyph_map;
+    adv->fallback = (int16_t)FindGlyphAdvance(font, 32);
+
+    for (int i = 0; i < font.glyph_count; ++i) {
+        int top = font.glyph_vertical_offsets[i];
+        int bottom = top + font.glyph_heights[i];
+        if (i == 0 || top < adv->top) adv->top = top;
+        if (i == 0 || bottom > adv->bottom) adv->bottom = bottom;
+
+        uint32_t unicode = font.glyph_map[i].unicode;
+        if (unicode > 0xFFFF) continue;
+
+        int16_t** page = &adv->pages[unicode >> 8];
+        if (!*page) {
+            *page = malloc(256 * sizeof(int16_t));
+            if (!*page) {
+                FreeRasterFontAdvances(adv);
+                return NULL;
+            }
+            for (int c = 0; c < 256; ++c) (*page)[c] = adv->fallback;
+        }
+        // Повторні коди - так само, як їх знайде FindGlyph при малюванні
+        (*page)[unicode & 0xFF] = (int16_t)FindGlyphAdvance(font, unicode);
+    }
+
+    advance_tables[advance_table_count++] = adv;
+    return adv;
+}
+
+// Ширина коду з таблиці (або через FindGlyph, якщо таблиці немає), -1 - код не малюється
+static inline int LookupAdvance(const RasterFontAdvances* adv, const RasterFont font, uint32_t codepoint)
+{
+    if (adv && codepoint <= 0xFFFF) {
+        const int16_t* page = adv->pages[codepoint >> 8];
+        return page ? page[codepoint & 0xFF] : adv->fallback;
+    }
+    return FindGlyphAdvance(font, codepoint);
+}
+
+int GetRasterGlyphAdvance(const RasterFont font, uint32_t codepoint)
+{
+    return LookupAdvance(GetRasterFontAdvances(font), font, codepoint);
+}
+
+int GetRasterFontVerticalExtent(const RasterFont font, int* top, int* bottom)
+{
+    const RasterFontAdvances* adv = GetRasterFontAdvances(font);
+    if (!adv) return 0;
+    *top = adv->top;
+    *bottom = adv->bottom;
+    return 1;
+}
+
+// Один прохід по тексту: межі і ширина кожного рядка (у lines та/або lineWidths,
+// не більше maxLines) і найбільша ширина (у maxWidth). Повертає кількість рядків
+static int MeasureRasterLines(const RasterFont font, const char* text, int spacing, int scale,
+                              TextLine* lines, int* lineWidths, int maxLines, int* maxWidth)
+{
+    *maxWidth = 0;
+    if (!text || !*text) return 0;
+
+    const RasterFontAdvances* adv = GetRasterFontAdvances(font);
+    const char* base = text;
+    const char* lineStart = text;
+    const char* end = text + strlen(text);
+    const char* ascii = text;
+    int lineCount = 0;
+    int lineWidth = 0;
+
+    for (;;) {
+        if (*text == '\n' || *text == '\0') {
+            if (lineWidth > 0) lineWidth -= spacing; // прибираємо зайвий інтервал у кінці
+            if (lineCount < maxLines) {
+                if (lines) {
+                    lines[lineCount].start = (int)(lineStart - base);
+                    lines[lineCount].length = (int)(text - lineStart);
+                    lines[lineCount].width = lineWidth;
+                }
+                if (lineWidths) lineWidths[lineCount] = lineWidth;
+            }
+            if (lineWidth > *maxWidth) *maxWidth = lineWidth;
+            lineCount++;
+            lineWidth = 0;
+            if (*text == '\0') break;
+            text++;
+            lineStart = text;
+            continue;
+        }
+
+        uint32_t codepoint = 0;
+        int bytes = utf8_next(text, end, &ascii, &codepoint);
+        int advance = LookupAdvance(adv, font, codepoint);
+        if (advance >= 0) lineWidth += advance * scale + spacing;
+        text += bytes;
+    }
+    return lineCount;
+}
+
+/*
+ * MeasureRasterTextLines - ширина кожного рядка тексту в пікселях так, як його
+ * малює DrawTextScaled: сума (ширина гліфа * scale + spacing) без останнього spacing.
+ * Рядки розділяються '\n'; у lineWidths записується не більше maxLines значень.
+ * Повертає кількість рядків (0 для порожнього тексту).
+ */
+int MeasureRasterTextLines(const RasterFont font, const char* text, int spacing, int scale,
+                           int* lineWidths, int maxLines)
+{
+    int maxWidth;
+    return MeasureRasterLines(font, text, spacing, scale, NULL, lineWidths, maxLines, &maxWidth);
+}
+
+/*
+ * MeasureRasterText - розмір тексту в пікселях: ширина найширшого рядка,
+ * висота всіх рядків (з інтервалом spacing між рядками) і кількість рядків.
+ */
+TextMetrics MeasureRasterText(const RasterFont font, const char* text, int spacing, int scale)
+{
+    TextMetrics metrics = { 0, 0, 0 };
+    metrics.lineCount = MeasureRasterLines(font, text, spacing, scale, NULL, NULL, 0, &metrics.width);
+    if (metrics.lineCount > 0)
+        metrics.height = metrics.lineCount * font.glyph_height * scale + (metrics.lineCount - 1) * spacing;
+    return metrics;
+}
+
+/*
+ * LayoutRasterTextLines - розкладка тексту на рядки за один прохід: для кожного рядка
+ * зсув і довжина в байтах (без '\n') та ширина в пікселях. Текст не копіюється,
+ * порожні рядки зберігаються. У lines записується не більше maxLines рядків;
+ * повертає повну кількість рядків, тож при нестачі місця буфер можна збільшити.
+ */
+int LayoutRasterTextLines(const RasterFont font, const char* text, int spacing, int scale,
+                          TextLine* lines, int maxLines)
+{
+    int maxWidth;
+    return MeasureRasterLines(font, text, spacing, scale, lines, NULL, maxLines, &maxWidth);
+}
+
 // Малювання символу з урахуванням індивідуальних розмірів і зсувів
 void DrawChar(const RasterFont font, int x, int y, uint32_t codepoint,
               uint32_t color, int scale)
@@ -121,20 +260,125 @@ void DrawChar(const RasterFont font, int x, int y, uint32_t codepoint,
                          scale, 0, 0, color);
 }
 
+// Малювання рядка [text, end) без '\n' з відкиданням невидимих гліфів: рядок вище або
+// нижче видимої області не декодується зовсім, гліфи ліворуч від неї лише зсувають
+// позицію (ширина з таблиці, без пошуку гліфа), а праворуч від неї рядок закінчується
+static void DrawRasterLine(const RasterFont font, const RasterFontAdvances* adv, RenderRect visible,
+                           int x, int y, const char* text, const char* end,
+                           int spacing, int scale, uint32_t color)
+{
+    if (adv && (y + adv->bottom * scale <= visible.y0 || y + adv->top * scale >= visible.y1)) return;
+
+    const char* ascii = text;
+    int xpos = x;
+    while (text < end) {
+        // Ширини гліфів невід’ємні: з невід’ємним spacing далі гліфи лише правіше
+        if (xpos >= visible.x1 && spacing >= 0) return;
+
+        uint32_t codepoint = 0;
+        int bytes = utf8_next(text, end, &ascii, &codepoint);
+        text += bytes;
+
+        if (adv && xpos < visible.x0) {
+            int advance = LookupAdvance(adv, font, codepoint);
+            if (advance < 0) continue;
+            if (xpos + advance * scale <= visible.x0) {
+                xpos += advance * scale + spacing;
+                continue;
+            }
+        }
+
+        const GlyphPointerMap* glyph = FindGlyph(font, codepoint);
+        if (!glyph) glyph = FindGlyph(font, 32); // заміна на пробіл, якщо не знайдено
+
+        if (glyph) {
+            int glyph_index = (int)(glyph - font.glyph_map);
+            int w = font.glyph_widths[glyph_index];
+            int h = font.glyph_heights[glyph_index];
+            int vo = font.glyph_vertical_offsets[glyph_index];
+
+            DrawGlyphWithOffsets(glyph->glyph, w, h, font.glyph_bytes,
+                                 xpos, y, scale, vo, 0, color);
+
+            xpos += (w * scale) + spacing;
+        }
+    }
+}
+
 void DrawTextScaled(const RasterFont font, int x, int y, const char* text,
                     int spacing, int scale, uint32_t color)
 {
-    int xpos = x;
+    // Повторюваний рядок малюється однією маскою з кешу (якщо кеш увімкнено)
+    if (TextCache_DrawText(font, x, y, text, spacing, scale, color)) return;
+
+    RenderRect visible = GetVisibleRect();
+    if (visible.x0 >= visible.x1 || visible.y0 >= visible.y1) return;
+
+    const RasterFontAdvances* adv = GetRasterFontAdvances(font);
+    int lineStep = font.glyph_height * scale + spacing;
     int ypos = y;
+    for (;;) {
+        // Рядки йдуть донизу: якщо цей нижче видимої області, то й решта
+        if (adv && lineStep > 0 && ypos + adv->top * scale >= visible.y1) return;
+
+        const char* end = text + strcspn(text, "\n");
+        DrawRasterLine(font, adv, visible, x, ypos, text, end, spacing, scale, color);
+        if (*end == '\0') return;
+        text = end + 1;
+        ypos += lineStep;
+    }
+}
+
+// Малювання одного рядка тексту довжиною length байтів (без '\n'), наприклад
+// рядка з розкладки LayoutRasterTextLines - без копіювання і завершального нуля
+void DrawTextLineScaled(const RasterFont font, int x, int y, const char* text, int length,
+                        int spacing, int scale, uint32_t color)
+{
+    RenderRect visible = GetVisibleRect();
+    if (visible.x0 >= visible.x1 || visible.y0 >= visible.y1) return;
+
+    DrawRasterLine(font, GetRasterFontAdvances(font), visible, x, y, text, text + length, spacing, scale, color);
+}
+
+// Чи є в бітмапі гліфа хоч один встановлений піксель
+static int GlyphHasPixels(const uint8_t* glyph, int bytes)
+{
+    for (int i = 0; i < bytes; i++) {
+        if (glyph[i]) return 1;
+    }
+    return 0;
+}
+
+/*
+ * CreateGlyphRun - розбирає текст один раз: декодує UTF-8, шукає гліфи (відсутні
+ * замінюються пробілом) і рахує позиції так само, як DrawTextScaled.
+ * Порожні гліфи (пробіли) лише зсувають позицію і в GlyphRun не потрапляють.
+ * Якщо пам’яті не вистачило, повертається порожній GlyphRun (count = 0).
+ */
+GlyphRun CreateGlyphRun(const RasterFont font, const char* text, int spacing, int scale)
+{
+    GlyphRun run = { 0 };
+    run.scale = scale;
+    run.metrics = MeasureRasterText(font, text, spacing, scale);
+
+    int maxGlyphs = utf8_strlen(text);
+    if (maxGlyphs <= 0) return run;
+    run.glyphs = malloc(maxGlyphs * sizeof(GlyphRunGlyph));
+    if (!run.glyphs) return run;
+
+    const char* end = text + strlen(text);
+    const char* ascii = text;
+    int xpos = 0;
+    int ypos = 0;
     while (*text) {
         if (*text == '\n') {
-            xpos = x;
+            xpos = 0;
             ypos += font.glyph_height * scale + spacing;
             text++;
             continue;
         }
         uint32_t codepoint = 0;
-        int bytes = utf8_decode(text, &codepoint);
+        int bytes = utf8_next(text, end, &ascii, &codepoint);
 
         const GlyphPointerMap* glyph = FindGlyph(font, codepoint);
         if (!glyph) glyph = FindGlyph(font, 32); // заміна на пробіл, якщо не знайдено
@@ -142,17 +386,351 @@ void DrawTextScaled(const RasterFont font, int x, int y, const char* text,
         if (glyph) {
             int glyph_index = (int)(glyph - font.glyph_map);
             int w = font.glyph_widths[glyph_index];
-            int h = font.glyph_heights[glyph_index];
-            int vo = font.glyph_vertical_offsets[glyph_index];
-            int ho = 0; // Додайте горизонтальний зсув, якщо є
 
-            DrawGlyphWithOffsets(glyph->glyph, w, h, font.glyph_bytes,
-                                 xpos, ypos, scale, vo, ho, color);
+            if (GlyphHasPixels(glyph->glyph, font.glyph_bytes)) {
+                GlyphRunGlyph* placed = &run.glyphs[run.count++];
+                placed->bitmap = glyph->glyph;
+                placed->width = w;
+                placed->height = font.glyph_heights[glyph_index];
+                placed->x = xpos;
+                placed->y = ypos + font.glyph_vertical_offsets[glyph_index] * scale;
 
+                RenderRect g = { placed->x, placed->y, placed->x + w * scale, placed->y + placed->height * scale };
+                if (run.count == 1) {
+                    run.bounds = g;
+                } else {
+                    if (g.x0 < run.bounds.x0) run.bounds.x0 = g.x0;
+                    if (g.y0 < run.bounds.y0) run.bounds.y0 = g.y0;
+                    if (g.x1 > run.bounds.x1) run.bounds.x1 = g.x1;
+                    if (g.y1 > run.bounds.y1) run.bounds.y1 = g.y1;
+                }
+            }
             xpos += (w * scale) + spacing;
         }
         text += bytes;
     }
+    return run;
+}
+
+void UnloadGlyphRun(GlyphRun run)
+{
+    free(run.glyphs);
+}
+
+void DrawGlyphRun(const GlyphRun* run, int x, int y, uint32_t color)
+{
+    RenderRect visible = GetVisibleRect();
+    if (run->count == 0 || !ClipRect_Overlaps(visible, x + run->bounds.x0, y + run->bounds.y0,
+                                              x + run->bounds.x1, y + run->bounds.y1)) return;
+
+    int scale = run->scale;
+    for (int i = 0; i < run->count; i++) {
+        const GlyphRunGlyph* glyph = &run->glyphs[i];
+        int gx = x + glyph->x;
+        int gy = y + glyph->y;
+        if (!ClipRect_Overlaps(visible, gx, gy, gx + glyph->width * scale, gy + glyph->height * scale)) continue;
+        DrawBitmapSpans(glyph->bitmap, glyph->width, glyph->height, gx, gy, scale, color);
+    }
+}
+
+// Смуги DrawGlyphRunParallel: до PARALLEL_BANDS_PER_THREAD смуг на потік, щоб потоку,
+// що звільнився, було що забрати, але не нижчі за PARALLEL_MIN_BAND_ROWS рядків
+#define PARALLEL_BANDS_PER_THREAD 4
+#define PARALLEL_MIN_BAND_ROWS 16
+
+// Спільні дані смуг DrawGlyphRunParallel (лише читаються потоками, крім bandTargets[band])
+typedef struct {
+    RenderTarget* target;
+    const GlyphRun* run;
+    int x, y;
+    uint32_t color;
+    RenderRect visible;         // видима частина цілі (з прямокутником відсікання)
+    int top;                    // перший рядок першої смуги
+    int bandRows;               // висота смуги
+    const int* bandStart;       // гліфи смуги b: bandGlyphs[bandStart[b] .. bandStart[b + 1])
+    const int* bandGlyphs;
+    RenderTarget* bandTargets;  // ціль кожної смуги (змінена область потім переноситься в target)
+} GlyphRunBands;
+
+static void DrawGlyphRunBand(int band, void* user)
+{
+    GlyphRunBands* p = (GlyphRunBands*)user;
+    int y0 = p->top + band * p->bandRows;
+    RenderTarget* bandTarget = &p->bandTargets[band];
+    *bandTarget = RenderTarget_Band(p->target, y0, y0 + p->bandRows);
+
+    RenderRect clip = { p->visible.x0, p->visible.y0 - y0, p->visible.x1, p->visible.y1 - y0 };
+    for (int i = p->bandStart[band]; i < p->bandStart[band + 1]; i++) {
+        const GlyphRunGlyph* glyph = &p->run->glyphs[p->bandGlyphs[i]];
+        RenderTarget_DrawBitmapClipped(bandTarget, clip, glyph->bitmap, glyph->width, glyph->height,
+                                       p->x + glyph->x, p->y + glyph->y - y0, p->run->scale, p->color);
+    }
+}
+
+// Смуги [first, last], які перетинає гліф, або 0, якщо гліф поза рядками [top, bottom)
+// або поза стовпцями видимої області
+static int GlyphRunGlyphBands(const GlyphRunGlyph* glyph, int x, int y, int scale, RenderRect visible,
+                              int top, int bottom, int bandRows, int* first, int* last)
+{
+    int gx = x + glyph->x;
+    if (gx >= visible.x1 || gx + glyph->width * scale <= visible.x0) return 0;
+
+    int gy0 = y + glyph->y;
+    int gy1 = gy0 + glyph->height * scale;
+    if (gy0 < top) gy0 = top;
+    if (gy1 > bottom) gy1 = bottom;
+    if (gy0 >= gy1) return 0;
+    *first = (gy0 - top) / bandRows;
+    *last = (gy1 - 1 - top) / bandRows;
+    return 1;
+}
+
+void DrawGlyphRunParallel(RenderTarget* target, const GlyphRun* run, int x, int y, uint32_t color)
+{
+    if (!target) target = GetActiveRenderTarget();
+    if (!target) {
+        DrawGlyphRun(run, x, y, color);
+        return;
+    }
+
+    // Видима частина цілі і її рядки, які займає текст
+    int scale = run->scale;
+    RenderRect visible = { 0, 0, target->width, target->height };
+    visible = ClipRect_Intersect(visible, GetClipRect());
+    if (run->count == 0 || !ClipRect_Overlaps(visible, x + run->bounds.x0, y + run->bounds.y0,
+                                              x + run->bounds.x1, y + run->bounds.y1)) return;
+    int top = (y + run->bounds.y0 > visible.y0) ? y + run->bounds.y0 : visible.y0;
+    int bottom = (y + run->bounds.y1 < visible.y1) ? y + run->bounds.y1 : visible.y1;
+
+    int threads = RenderPool_GetThreadCount();
+    int rows = bottom - top;
+    int bandRows = (rows + threads * PARALLEL_BANDS_PER_THREAD - 1) / (threads * PARALLEL_BANDS_PER_THREAD);
+    if (bandRows < PARALLEL_MIN_BAND_ROWS) bandRows = PARALLEL_MIN_BAND_ROWS;
+    int bands = (rows + bandRows - 1) / bandRows;
+
+    // Гліфи по смугах (гліф на межі смуг потрапляє в кожну): підрахунок, зсуви, розкладка
+    int* bandStart = NULL;
+    int* bandGlyphs = NULL;
+    RenderTarget* bandTargets = NULL;
+    int first, last;
+    if (bands > 1 && threads > 1) {
+        bandStart = calloc(bands + 1, sizeof(int));
+        bandTargets = malloc(bands * sizeof(RenderTarget));
+    }
+    if (bandStart && bandTargets) {
+        for (int i = 0; i < run->count; i++) {
+            if (!GlyphRunGlyphBands(&run->glyphs[i], x, y, scale, visible, top, bottom, bandRows, &first, &last)) continue;
+            for (int b = first; b <= last; b++) bandStart[b + 1]++;
+        }
+        for (int b = 0; b < bands; b++) bandStart[b + 1] += bandStart[b];
+        bandGlyphs = malloc((bandStart[bands] + bands) * sizeof(int));
+    }
+
+    if (!bandGlyphs) {
+        // Одна смуга, один потік або немає пам’яті - малюємо в цьому потоці
+        for (int i = 0; i < run->count; i++) {
+            const GlyphRunGlyph* glyph = &run->glyphs[i];
+            RenderTarget_DrawBitmapClipped(target, visible, glyph->bitmap, glyph->width, glyph->height,
+                                           x + glyph->x, y + glyph->y, scale, color);
+        }
+        free(bandTargets);
+        free(bandStart);
+        return;
+    }
+
+    // Хвіст bandGlyphs - позиції заповнення кожної смуги
+    int* bandFill = bandGlyphs + bandStart[bands];
+    for (int b = 0; b < bands; b++) bandFill[b] = bandStart[b];
+    for (int i = 0; i < run->count; i++) {
+        if (!GlyphRunGlyphBands(&run->glyphs[i], x, y, scale, visible, top, bottom, bandRows, &first, &last)) continue;
+        for (int b = first; b <= last; b++) bandGlyphs[bandFill[b]++] = i;
+    }
+
+    GlyphRunBands p = { target, run, x, y, color, visible, top, bandRows, bandStart, bandGlyphs, bandTargets };
+    RenderPool_Run(bands, DrawGlyphRunBand, &p);
+
+    // Змінені області смуг - у змінену область цілі
+    for (int b = 0; b < bands; b++) {
+        const RenderTarget* band = &bandTargets[b];
+        if (band->dirty_x0 >= band->dirty_x1) continue;
+        int y0 = top + b * bandRows;
+        RenderTarget_MarkDirty(target, band->dirty_x0, y0 + band->dirty_y0, band->dirty_x1, y0 + band->dirty_y1);
+    }
+
+    free(bandGlyphs);
+    free(bandTargets);
+    free(bandStart);
+}
+
+void DrawTextScaledParallel(RenderTarget* target, const RasterFont font, int x, int y, const char* text,
+                            int spacing, int scale, uint32_t color)
+{
+    GlyphRun run = CreateGlyphRun(font, text, spacing, scale);
+    DrawGlyphRunParallel(target, &run, x, y, color);
+    UnloadGlyphRun(run);
+}
+
+// Клітинка гліфа в непрозорому режимі: стовпці [x, x + width * scale) рядка тексту
+// [y, y + cellHeight * scale). Рядки гліфа, що потрапляють у клітинку, малюються
+// непрозоро, решта клітинки над і під ними заливається фоном
+static void DrawGlyphCellOpaque(const uint8_t* glyph, int width, int height, int vert_offset,
+                                int cellHeight, int x, int y, int scale, uint32_t fg, uint32_t bg)
+{
+    int row0 = (vert_offset < 0) ? -vert_offset : 0;
+    int row1 = (vert_offset + height > cellHeight) ? cellHeight - vert_offset : height;
+    int top = vert_offset + row0;       // рядки клітинки [top, bottom) - гліф
+    int bottom = vert_offset + row1;
+    if (row0 >= row1) top = bottom = cellHeight;
+
+    if (top > 0) DrawRectangle(x, y, width * scale, top * scale, bg);
+    if (row0 < row1) {
+        DrawBitmapOpaque(glyph + row0 * ((width + 7) / 8), width, row1 - row0,
+                         x, y + top * scale, scale, fg, bg);
+    }
+    if (bottom < cellHeight) DrawRectangle(x, y + bottom * scale, width * scale, (cellHeight - bottom) * scale, bg);
+}
+
+// Непрозорий рядок [text, end) без '\n': клітинки гліфів, проміжки spacing між ними і
+// залишок рядка до right заливаються за один прохід (кожен піксель рядка [y, y + висота
+// шрифту) пишеться один раз). Невидимі частини відкидаються так само, як у DrawRasterLine
+static void DrawRasterLineOpaque(const RasterFont font, const RasterFontAdvances* adv, RenderRect visible,
+                                 int x, int y, int right, const char* text, const char* end,
+                                 int spacing, int scale, uint32_t fg, uint32_t bg)
+{
+    int cellHeight = font.glyph_height * scale;
+    if (y + cellHeight <= visible.y0 || y >= visible.y1) return;
+
+    int xpos = x;
+    int filled = x; // рядок уже залито до цього стовпця
+    const char* ascii = text;
+    while (text < end) {
+        if (xpos >= visible.x1 && spacing >= 0) break;
+
+        uint32_t codepoint = 0;
+        int bytes = utf8_next(text, end, &ascii, &codepoint);
+        text += bytes;
+
+        if (adv && xpos < visible.x0) {
+            int advance = LookupAdvance(adv, font, codepoint);
+            if (advance < 0) continue;
+            if (xpos + advance * scale <= visible.x0) {
+                filled = xpos + advance * scale;
+                xpos = filled + spacing;
+                continue;
+            }
+        }
+
+        const GlyphPointerMap* glyph = FindGlyph(font, codepoint);
+        if (!glyph) glyph = FindGlyph(font, 32); // заміна на пробіл, якщо не знайдено
+        if (!glyph) continue;
+
+        int glyph_index = (int)(glyph - font.glyph_map);
+        int w = font.glyph_widths[glyph_index];
+        if (xpos > filled) DrawRectangle(filled, y, xpos - filled, cellHeight, bg);
+        if (w > 0) {
+            DrawGlyphCellOpaque(glyph->glyph, w, font.glyph_heights[glyph_index],
+                                font.glyph_vertical_offsets[glyph_index], font.glyph_height,
+                                xpos, y, scale, fg, bg);
+        }
+        filled = xpos + w * scale;
+        xpos = filled + spacing;
+    }
+    if (right > filled) DrawRectangle(filled, y, right - filled, cellHeight, bg);
+}
+
+// Частини гліфів рядка [text, end), що виходять за рядок тексту вгору чи вниз (вертикальні
+// зсуви), малюються прозоро поверх уже залитих клітинок
+static void DrawRasterLineOverhang(const RasterFont font, RenderRect visible, int x, int y,
+                                   const char* text, const char* end, int spacing, int scale, uint32_t color)
+{
+    const char* ascii = text;
+    int xpos = x;
+    while (text < end) {
+        if (xpos >= visible.x1 && spacing >= 0) return;
+
+        uint32_t codepoint = 0;
+        int bytes = utf8_next(text, end, &ascii, &codepoint);
+        text += bytes;
+
+        const GlyphPointerMap* glyph = FindGlyph(font, codepoint);
+        if (!glyph) glyph = FindGlyph(font, 32);
+        if (!glyph) continue;
+
+        int glyph_index = (int)(glyph - font.glyph_map);
+        int w = font.glyph_widths[glyph_index];
+        int h = font.glyph_heights[glyph_index];
+        int vo = font.glyph_vertical_offsets[glyph_index];
+        int bytes_per_row = (w + 7) / 8;
+
+        // Рядки гліфа над рядком тексту [0, above) і під ним [below, h)
+        int above = (vo < 0) ? ((-vo < h) ? -vo : h) : 0;
+        int below = (vo + h > font.glyph_height) ? font.glyph_height - vo : h;
+        if (below < above) below = above;
+        if (above > 0) DrawBitmapSpans(glyph->glyph, w, above, xpos, y + vo * scale, scale, color);
+        if (below < h) {
+            DrawBitmapSpans(glyph->glyph + below * bytes_per_row, w, h - below,
+                            xpos, y + (vo + below) * scale, scale, color);
+        }
+        xpos += w * scale + spacing;
+    }
+}
+
+// Непрозорий блок тексту [x, x + width) x [y, y + висота тексту): рядки клітинками
+// (DrawRasterLineOpaque), проміжки spacing між рядками - фоном. Частини гліфів, що
+// виходять за свій рядок, домальовуються після всіх рядків, щоб наступний рядок їх не затер
+static void DrawRasterBlockOpaque(const RasterFont font, int x, int y, int width, const char* text,
+                                  int spacing, int scale, uint32_t fg, uint32_t bg)
+{
+    RenderRect visible = GetVisibleRect();
+    if (visible.x0 >= visible.x1 || visible.y0 >= visible.y1) return;
+
+    const RasterFontAdvances* adv = GetRasterFontAdvances(font);
+    int cellHeight = font.glyph_height * scale;
+    int lineStep = cellHeight + spacing;
+    int ypos = y;
+    for (const char* line = text;;) {
+        if (lineStep > 0 && ypos >= visible.y1) break;
+
+        const char* end = line + strcspn(line, "\n");
+        DrawRasterLineOpaque(font, adv, visible, x, ypos, x + width, line, end, spacing, scale, fg, bg);
+        if (*end == '\0') break;
+        if (spacing > 0) DrawRectangle(x, ypos + cellHeight, width, spacing, bg);
+        line = end + 1;
+        ypos += lineStep;
+    }
+
+    // Гліфи всіх шрифтів із таблиць лежать у межах рядка, крім зсунутих вище чи нижче
+    if (adv && adv->top >= 0 && adv->bottom <= font.glyph_height) return;
+    int top = adv ? adv->top * scale : -cellHeight;
+    int bottom = adv ? adv->bottom * scale : 2 * cellHeight;
+    ypos = y;
+    for (const char* line = text;;) {
+        if (lineStep > 0 && ypos + top >= visible.y1) return;
+
+        const char* end = line + strcspn(line, "\n");
+        if (ypos + bottom > visible.y0 && ypos + top < visible.y1)
+            DrawRasterLineOverhang(font, visible, x, ypos, line, end, spacing, scale, fg);
+        if (*end == '\0') return;
+        line = end + 1;
+        ypos += lineStep;
+    }
+}
+
+/*
+ * DrawTextOpaque - малює текст непрозоро, як термінал: кожен піксель прямокутника тексту
+ * (MeasureRasterText) отримує колір тексту fg або фону bg за один прохід по гліфах,
+ * без окремої заливки фону і повторного запису пікселів тексту.
+ * Фоном заливаються клітинки гліфів (ширина гліфа x висота шрифту), проміжки spacing
+ * і залишок коротших рядків. З від’ємним spacing клітинки перекриваються, і пізніша
+ * клітинка затирає попередню.
+ */
+void DrawTextOpaque(const RasterFont font, int x, int y, const char* text,
+                    int spacing, int scale, uint32_t fg, uint32_t bg)
+{
+    if (!text || !*text || scale < 1) return;
+
+    TextMetrics metrics = MeasureRasterText(font, text, spacing, scale);
+    DrawRasterBlockOpaque(font, x, y, metrics.width, text, spacing, scale, fg, bg);
 }
 
 /*
@@ -160,7 +738,7 @@ void DrawTextScaled(const RasterFont font, int x, int y, const char* text,
  * Параметри:
  * - font: шрифт для малювання
  * - x, y: позиція початку тексту
- * - text: текст для малювання (підтримує \n)
+ * - text: текст для малювання (підтримує \n, довжина і кількість рядків не обмежені)
  * - spacing: відступ між символами
  * - scale: масштаб символів
  * - textColor, bgColor, borderColor: кольори тексту, фону і рамки
@@ -172,49 +750,26 @@ void DrawTextWithBackground(const RasterFont font, int x, int y, const char* tex
                             uint32_t bgColor, uint32_t borderColor,
                             int padding, int borderThickness)
 {
-    // Розбиваємо текст на рядки для посторочного малювання
-    const char* lines[20];
-    int lineCount = 0;
-    char tempText[512];
-    strncpy(tempText, text, sizeof(tempText) - 1);
-    tempText[sizeof(tempText) - 1] = '\0';
-
-    char* line = strtok(tempText, "\n");
-    while (line != NULL && lineCount < 20) {
-        lines[lineCount++] = line;
-        line = strtok(NULL, "\n");
-    }
-
-    // Обчислюємо максимальну ширину рядка в пікселях з урахуванням ширини кожного гліфа
-    int maxLineWidth = 0;
-    for (int i = 0; i < lineCount; i++) {
-        int lineWidth = 0;
-        const char* ptr = lines[i];
-        while (*ptr) {
-            uint32_t cp = 0;
-            int bytes = utf8_decode(ptr, &cp);
-            const GlyphPointerMap* glyph = FindGlyph(font, cp);
-            if (!glyph) glyph = FindGlyph(font, 32); // пропуск, якщо не знайдений
-
-            if (glyph) {
-                int glyph_index = glyph - font.glyph_map;
-                int gw = font.glyph_widths[glyph_index];
-                lineWidth += (gw * scale) + spacing;
-            }
-            ptr += bytes;
-        }
-        if (lineWidth > 0) lineWidth -= spacing; // прибираємо зайвий інтервал у кінці
-        if (lineWidth > maxLineWidth) maxLineWidth = lineWidth;
-    }
+    // Розмір тексту одним проходом: ширина найширшого рядка і висота всіх рядків
+    TextMetrics metrics = MeasureRasterText(font, text, spacing, scale);
 
-    // Обчислюємо висоту фону із урахуванням рядків, масштабу, паддінгу, отступів і товщини рамки
-    int lineHeight = font.glyph_height * scale;
-    int totalHeight = (lineHeight * lineCount) + (spacing * (lineCount - 1));
-    int bgWidth = maxLineWidth + 2 * padding + 2 * borderThickness;
-    int bgHeight = totalHeight + 2 * padding + 2 * borderThickness;
+    // Обчислюємо розмір фону із урахуванням паддінгу і товщини рамки
+    int bgWidth = metrics.width + 2 * padding + 2 * borderThickness;
+    int bgHeight = metrics.height + 2 * padding + 2 * borderThickness;
 
-    // Малюємо залитий фон
-    DrawRectangle(x - padding - borderThickness, y - padding - borderThickness, bgWidth, bgHeight, bgColor);
+    // Непрозорий текст (DrawTextOpaque) сам заливає свій прямокутник, тож фоном
+    // заливається лише поле padding навколо нього, і кожен піксель пишеться один раз.
+    // Від’ємні відступи перекривають текст - тоді фон під текстом і текст поверх нього
+    int opaque = text && spacing >= 0 && padding >= 0 && borderThickness >= 0 && scale >= 1;
+    if (opaque) {
+        int innerWidth = metrics.width + 2 * padding;
+        DrawRectangle(x - padding, y - padding, innerWidth, padding, bgColor);
+        DrawRectangle(x - padding, y + metrics.height, innerWidth, padding, bgColor);
+        DrawRectangle(x - padding, y, padding, metrics.height, bgColor);
+        DrawRectangle(x + metrics.width, y, padding, metrics.height, bgColor);
+    } else {
+        DrawRectangle(x - padding - borderThickness, y - padding - borderThickness, bgWidth, bgHeight, bgColor);
+    }
 
     // Малюємо рамку товщиною borderThickness
     for (int i = 0; i < borderThickness; i++) {
@@ -222,12 +777,14 @@ void DrawTextWithBackground(const RasterFont font, int x, int y, const char* tex
                            bgWidth - 2 * i, bgHeight - 2 * i, borderColor);
     }
 
-    // Малюємо текст поверх фону і рамки по рядках
-    int ypos = y;
-    for (int i = 0; i < lineCount; i++) {
-        DrawTextScaled(font, x, ypos, lines[i], spacing, scale, textColor);
-        ypos += lineHeight + spacing;
+    if (opaque) {
+        DrawRasterBlockOpaque(font, x, y, metrics.width, text, spacing, scale, textColor, bgColor);
+        return;
     }
+
+    // Малюємо текст поверх фону і рамки (через DrawTextScaled, щоб постійні підписи
+    // бралися з кешу рядків)
+    DrawTextScaled(font, x, y, text, spacing, scale, textColor);
 }
 
 /*
@@ -244,3 +801,270 @@ void DrawTextWithAutoInvertedBackground(const RasterFont font, int x, int y, con
     DrawTextWithBackground(font, x, y, text, spacing, scale, textColor, bgColor, textColor, padding, borderThickness);
 }
 
+
+// Поля RasterFont, потрібні для малювання, без байтів вирівнювання: DamageTracker
+// порівнює команди memcmp, а присвоєння цілої структури не визначає вміст її
+// вирівнювання. Спершу вказівники, потім int (з явним доповненням до парної кількості)
+typedef struct {
+    const GlyphPointerMap* glyph_map;
+    const int* glyph_widths;
+    const int* glyph_heights;
+    const int* glyph_vertical_offsets;
+    const int* glyph_horizontal_offsets;
+    const int16_t* glyph_ascii_lookup;
+    const uint16_t* glyph_sorted_lookup;
+    int glyph_width, glyph_height, glyph_bytes, glyph_count, glyph_sorted_count;
+    int reserved;                       // завжди 0
+} RecordedFont;
+
+_Static_assert(sizeof(RecordedFont) == 7 * sizeof(void*) + 6 * sizeof(int),
+               "RecordedFont must not contain padding");
+
+static void RecordFont(RecordedFont* r, const RasterFont* font)
+{
+    r->glyph_map = font->glyph_map;
+    r->glyph_widths = font->glyph_widths;
+    r->glyph_heights = font->glyph_heights;
+    r->glyph_vertical_offsets = font->glyph_vertical_offsets;
+    r->glyph_horizontal_offsets = font->glyph_horizontal_offsets;
+    r->glyph_ascii_lookup = font->glyph_ascii_lookup;
+    r->glyph_sorted_lookup = font->glyph_sorted_lookup;
+    r->glyph_width = font->glyph_width;
+    r->glyph_height = font->glyph_height;
+    r->glyph_bytes = font->glyph_bytes;
+    r->glyph_count = font->glyph_count;
+    r->glyph_sorted_count = font->glyph_sorted_count;
+    r->reserved = 0;
+}
+
+static RasterFont RecordedFont_Get(const RecordedFont* r)
+{
+    RasterFont font = { 0 };
+    font.glyph_map = r->glyph_map;
+    font.glyph_widths = r->glyph_widths;
+    font.glyph_heights = r->glyph_heights;
+    font.glyph_vertical_offsets = r->glyph_vertical_offsets;
+    font.glyph_horizontal_offsets = r->glyph_horizontal_offsets;
+    font.glyph_ascii_lookup = r->glyph_ascii_lookup;
+    font.glyph_sorted_lookup = r->glyph_sorted_lookup;
+    font.glyph_width = r->glyph_width;
+    font.glyph_height = r->glyph_height;
+    font.glyph_bytes = r->glyph_bytes;
+    font.glyph_count = r->glyph_count;
+    font.glyph_sorted_count = r->glyph_sorted_count;
+    return font;
+}
+
+// Параметри тексту, записаного в кадр DamageTracker (рядок копіюється слідом)
+typedef struct {
+    RecordedFont font;
+    int x, y;
+    int spacing, scale;
+    uint32_t textColor, bgColor, borderColor;
+    int padding, borderThickness;
+    char text[];
+} RecordedText;
+
+static void DrawRecordedText(const void* data, int dx, int dy)
+{
+    const RecordedText* t = (const RecordedText*)data;
+    DrawTextScaled(RecordedFont_Get(&t->font), t->x + dx, t->y + dy, t->text, t->spacing, t->scale, t->textColor);
+}
+
+static void DrawRecordedTextOpaque(const void* data, int dx, int dy)
+{
+    const RecordedText* t = (const RecordedText*)data;
+    DrawTextOpaque(RecordedFont_Get(&t->font), t->x + dx, t->y + dy, t->text, t->spacing, t->scale, t->textColor, t->bgColor);
+}
+
+static void DrawRecordedTextWithBackground(const void* data, int dx, int dy)
+{
+    const RecordedText* t = (const RecordedText*)data;
+    DrawTextWithBackground(RecordedFont_Get(&t->font), t->x + dx, t->y + dy, t->text, t->spacing, t->scale,
+                           t->textColor, t->bgColor, t->borderColor, t->padding, t->borderThickness);
+}
+
+// Межі пікселів тексту так, як його малює DrawTextScaled (з вертикальними зсувами гліфів,
+// які можуть виходити за висоту рядка)
+static RenderRect RasterTextBounds(const RasterFont font, int x, int y, const char* text,
+                                   int spacing, int scale)
+{
+    RenderRect bounds = { 0, 0, 0, 0 };
+    int empty = 1;
+    const char* end = text + strlen(text);
+    const char* ascii = text;
+    int xpos = x;
+    int ypos = y;
+    while (*text) {
+        if (*text == '\n') {
+            xpos = x;
+            ypos += font.glyph_height * scale + spacing;
+            text++;
+            continue;
+        }
+        uint32_t codepoint = 0;
+        int bytes = utf8_next(text, end, &ascii, &codepoint);
+
+        const GlyphPointerMap* glyph = FindGlyph(font, codepoint);
+        if (!glyph) glyph = FindGlyph(font, 32);
+
+        if (glyph) {
+            int glyph_index = (int)(glyph - font.glyph_map);
+            int w = font.glyph_widths[glyph_index];
+            int h = font.glyph_heights[glyph_index];
+            if (w > 0 && h > 0) {
+                RenderRect g = { xpos, ypos + font.glyph_vertical_offsets[glyph_index] * scale, 0, 0 };
+                g.x1 = g.x0 + w * scale;
+                g.y1 = g.y0 + h * scale;
+                if (empty) {
+                    bounds = g;
+                    empty = 0;
+                } else {
+                    if (g.x0 < bounds.x0) bounds.x0 = g.x0;
+                    if (g.y0 < bounds.y0) bounds.y0 = g.y0;
+                    if (g.x1 > bounds.x1) bounds.x1 = g.x1;
+                    if (g.y1 > bounds.y1) bounds.y1 = g.y1;
+                }
+            }
+            xpos += (w * scale) + spacing;
+        }
+        text += bytes;
+    }
+    return bounds;
+}
+
+// Параметри тексту і копія рядка (length байтів без нуля) у буфері команди
+static void FillRecordedText(RecordedText* t, const RasterFont font, int x, int y, const char* text,
+                             size_t length, int spacing, int scale, uint32_t textColor)
+{
+    RecordFont(&t->font, &font);
+    t->x = x;
+    t->y = y;
+    t->spacing = spacing;
+    t->scale = scale;
+    t->textColor = textColor;
+    memcpy(t->text, text, length + 1);
+}
+
+// Запис тексту в кадр: параметри і копія рядка
+static RecordedText* RecordText(DamageTracker* tracker, RenderRect bounds, DamageDrawFunc draw,
+                                const RasterFont font, int x, int y, const char* text,
+                                int spacing, int scale, uint32_t textColor)
+{
+    size_t length = strlen(text);
+    RecordedText* t = DamageTracker_Record(tracker, bounds, draw, sizeof(RecordedText) + length + 1);
+    if (!t) return NULL;
+    FillRecordedText(t, font, x, y, text, length, spacing, scale, textColor);
+    return t;
+}
+
+// Запис тексту в список малювання. NULL - список уже виконано, і текст треба намалювати одразу
+static RecordedText* QueueText(DrawList* list, RenderRect bounds, uint64_t state, DamageDrawFunc draw,
+                               const RasterFont font, int x, int y, const char* text,
+                               int spacing, int scale, uint32_t textColor)
+{
+    size_t length = strlen(text);
+    RecordedText* t = DrawList_Record(list, bounds, state, draw, sizeof(RecordedText) + length + 1);
+    if (!t) return NULL;
+    FillRecordedText(t, font, x, y, text, length, spacing, scale, textColor);
+    return t;
+}
+
+void RecordTextScaled(DamageTracker* tracker, const RasterFont font, int x, int y, const char* text,
+                      int spacing, int scale, uint32_t color)
+{
+    RenderRect bounds = RasterTextBounds(font, x, y, text, spacing, scale);
+    if (bounds.x0 >= bounds.x1) return; // у тексті немає гліфів
+
+    RecordText(tracker, bounds, DrawRecordedText, font, x, y, text, spacing, scale, color);
+}
+
+// Межі непрозорого тексту: прямокутник тексту разом з гліфами, що можуть за нього виходити
+static RenderRect RasterOpaqueTextBounds(const RasterFont font, int x, int y, const char* text,
+                                         int spacing, int scale)
+{
+    TextMetrics metrics = MeasureRasterText(font, text, spacing, scale);
+    RenderRect bounds = { x, y, x + metrics.width, y + metrics.height };
+    RenderRect ink = RasterTextBounds(font, x, y, text, spacing, scale);
+    if (ink.x0 < ink.x1) {
+        if (ink.x0 < bounds.x0) bounds.x0 = ink.x0;
+        if (ink.y0 < bounds.y0) bounds.y0 = ink.y0;
+        if (ink.x1 > bounds.x1) bounds.x1 = ink.x1;
+        if (ink.y1 > bounds.y1) bounds.y1 = ink.y1;
+    }
+    return bounds;
+}
+
+void RecordTextOpaque(DamageTracker* tracker, const RasterFont font, int x, int y, const char* text,
+                      int spacing, int scale, uint32_t fg, uint32_t bg)
+{
+    if (!text || !*text || scale < 1) return;
+
+    RenderRect bounds = RasterOpaqueTextBounds(font, x, y, text, spacing, scale);
+    if (bounds.x0 >= bounds.x1 || bounds.y0 >= bounds.y1) return;
+
+    RecordedText* t = RecordText(tracker, bounds, DrawRecordedTextOpaque, font, x, y, text, spacing, scale, fg);
+    if (t) t->bgColor = bg;
+}
+
+void RecordTextWithBackground(DamageTracker* tracker, const RasterFont font, int x, int y, const char* text,
+                              int spacing, int scale, uint32_t textColor,
+                              uint32_t bgColor, uint32_t borderColor,
+                              int padding, int borderThickness)
+{
+    // Фон з рамкою (як у DrawTextWithBackground) разом з гліфами, що можуть за нього виходити
+    TextMetrics metrics = MeasureRasterText(font, text, spacing, scale);
+    RenderRect bounds = { x - padding - borderThickness, y - padding - borderThickness, 0, 0 };
+    bounds.x1 = bounds.x0 + metrics.width + 2 * padding + 2 * borderThickness;
+    bounds.y1 = bounds.y0 + metrics.height + 2 * padding + 2 * borderThickness;
+
+    RenderRect ink = RasterTextBounds(font, x, y, text, spacing, scale);
+    if (ink.x0 < ink.x1) {
+        if (ink.x0 < bounds.x0) bounds.x0 = ink.x0;
+        if (ink.y0 < bounds.y0) bounds.y0 = ink.y0;
+        if (ink.x1 > bounds.x1) bounds.x1 = ink.x1;
+        if (ink.y1 > bounds.y1) bounds.y1 = ink.y1;
+    }
+
+    RecordedText* t = RecordText(tracker, bounds, DrawRecordedTextWithBackground,
+                                 font, x, y, text, spacing, scale, textColor);
+    if (!t) return;
+    t->bgColor = bgColor;
+    t->borderColor = borderColor;
+    t->padding = padding;
+    t->borderThickness = borderThickness;
+}
+
+void RecordTextWithAutoInvertedBackground(DamageTracker* tracker, const RasterFont font, int x, int y,
+                                          const char* text, int spacing, int scale, uint32_t textColor,
+                                          int padding, int borderThickness)
+{
+    RecordTextWithBackground(tracker, font, x, y, text, spacing, scale, textColor,
+                             GetContrastInvertColor(textColor), textColor, padding, borderThickness);
+}
+
+void QueueTextScaled(DrawList* list, const RasterFont font, int x, int y, const char* text,
+                     int spacing, int scale, uint32_t color)
+{
+    RenderRect bounds = RasterTextBounds(font, x, y, text, spacing, scale);
+    if (bounds.x0 >= bounds.x1) return; // у тексті немає гліфів
+
+    if (!QueueText(list, bounds, DrawList_State(font.glyph_map, color), DrawRecordedText,
+                   font, x, y, text, spacing, scale, color))
+        DrawTextScaled(font, x, y, text, spacing, scale, color);
+}
+
+void QueueTextOpaque(DrawList* list, const RasterFont font, int x, int y, const char* text,
+                     int spacing, int scale, uint32_t fg, uint32_t bg)
+{
+    if (!text || !*text || scale < 1) return;
+
+    RenderRect bounds = RasterOpaqueTextBounds(font, x, y, text, spacing, scale);
+    if (bounds.x0 >= bounds.x1 || bounds.y0 >= bounds.y1) return;
+
+    // Обидва кольори - частина стану
+    uint64_t state = DrawList_State(font.glyph_map, fg) ^ ((uint64_t)(bg & 0xFFFFFF) << 32);
+    RecordedText* t = QueueText(list, bounds, state, DrawRecordedTextOpaque, font, x, y, text, spacing, scale, fg);
+    if (t) t->bgColor = bg;
+    else DrawTextOpaque(font, x, y, text, spacing, scale, fg, bg);
+}
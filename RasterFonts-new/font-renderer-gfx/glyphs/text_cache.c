@@ -0,0 +1,274 @@
+// text_cache.c
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "text_cache.h"
+#include "graphics.h"  // DrawBitmapSpans
+
+// Початкова кількість кошиків хеш-таблиці (степінь двійки)
+#define TEXT_CACHE_INITIAL_BUCKETS 64
+
+// Рядок у кеші
+typedef struct TextCacheEntry {
+    const GlyphPointerMap* font;    // шрифт (таблиця гліфів визначає його однозначно)
+    int spacing;
+    int scale;
+    uint64_t hash;
+    char* text;                     // копія рядка для перевірки збігу
+    size_t length;
+    int rasterized;                 // 0 - рядок зустрівся лише раз і маски ще немає
+    uint8_t* mask;                  // рядок, 1 біт на піксель (NULL - у рядку немає пікселів)
+    int width, height;              // розмір маски
+    int offset_x, offset_y;         // зсув маски від точки малювання
+    size_t bytes;                   // пам’ять запису
+    struct TextCacheEntry* bucket_next;
+    struct TextCacheEntry* newer;   // список LRU: від найновішого до найдавнішого
+    struct TextCacheEntry* older;
+} TextCacheEntry;
+
+static TextCacheEntry** g_buckets = NULL;
+static int g_bucket_count = 0;
+static TextCacheEntry* g_newest = NULL;
+static TextCacheEntry* g_oldest = NULL;
+static size_t g_budget = 0;
+static TextCacheStats g_stats = { 0 };
+
+// FNV-1a по байтах рядка з домішаними шрифтом, масштабом і відступом
+static uint64_t TextCache_Hash(const GlyphPointerMap* font, int spacing, int scale,
+                               const char* text, size_t length)
+{
+    uint64_t hash = 1469598103934665603ULL;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)text[i];
+        hash *= 1099511628211ULL;
+    }
+    hash ^= (uint64_t)(uintptr_t)font;
+    hash *= 1099511628211ULL;
+    hash ^= ((uint64_t)(uint32_t)scale << 32) | (uint32_t)spacing;
+    hash *= 1099511628211ULL;
+    return hash;
+}
+
+static TextCacheEntry** TextCache_Bucket(uint64_t hash)
+{
+    return &g_buckets[(hash ^ (hash >> 32)) & (uint64_t)(g_bucket_count - 1)];
+}
+
+static TextCacheEntry* TextCache_Find(const GlyphPointerMap* font, int spacing, int scale,
+                                      const char* text, size_t length, uint64_t hash)
+{
+    if (!g_buckets) return NULL;
+    for (TextCacheEntry* e = *TextCache_Bucket(hash); e; e = e->bucket_next) {
+        if (e->hash == hash && e->font == font && e->spacing == spacing && e->scale == scale &&
+            e->length == length && memcmp(e->text, text, length) == 0)
+            return e;
+    }
+    return NULL;
+}
+
+static void TextCache_LinkNewest(TextCacheEntry* e)
+{
+    e->newer = NULL;
+    e->older = g_newest;
+    if (g_newest) g_newest->newer = e;
+    else g_oldest = e;
+    g_newest = e;
+}
+
+static void TextCache_UnlinkLRU(TextCacheEntry* e)
+{
+    if (e->newer) e->newer->older = e->older;
+    else g_newest = e->older;
+    if (e->older) e->older->newer = e->newer;
+    else g_oldest = e->newer;
+}
+
+static void TextCache_Remove(TextCacheEntry* e)
+{
+    TextCacheEntry** link = TextCache_Bucket(e->hash);
+    while (*link != e) link = &(*link)->bucket_next;
+    *link = e->bucket_next;
+    TextCache_UnlinkLRU(e);
+
+    g_stats.bytes -= e->bytes;
+    g_stats.entries--;
+    free(e->mask);
+    free(e->text);
+    free(e);
+}
+
+// Подвоєння кількості кошиків, коли записів стає вдвічі більше за кошики
+static void TextCache_Grow(void)
+{
+    int count = g_bucket_count ? g_bucket_count * 2 : TEXT_CACHE_INITIAL_BUCKETS;
+    TextCacheEntry** buckets = calloc(count, sizeof(TextCacheEntry*));
+    if (!buckets) return; // лишаємо старі кошики - пошук просто довший
+
+    TextCacheEntry** old = g_buckets;
+    int oldCount = g_bucket_count;
+    g_buckets = buckets;
+    g_bucket_count = count;
+    for (int i = 0; i < oldCount; i++) {
+        for (TextCacheEntry* e = old[i]; e; ) {
+            TextCacheEntry* next = e->bucket_next;
+            TextCacheEntry** bucket = TextCache_Bucket(e->hash);
+            e->bucket_next = *bucket;
+            *bucket = e;
+            e = next;
+        }
+    }
+    free(old);
+}
+
+// Витіснення найдавніших рядків до ліміту. Рядок keep витісняється останнім;
+// повертає 0, якщо довелося витіснити і його
+static int TextCache_EvictToBudget(TextCacheEntry* keep)
+{
+    while (g_stats.bytes > g_budget && g_oldest) {
+        TextCacheEntry* victim = g_oldest;
+        if (victim == keep) {
+            if (!victim->newer) break;
+            victim = victim->newer;
+        }
+        TextCache_Remove(victim);
+        g_stats.evictions++;
+    }
+    if (keep && g_stats.bytes > g_budget) {
+        TextCache_Remove(keep);
+        g_stats.evictions++;
+        return 0;
+    }
+    return 1;
+}
+
+// Розтеризація рядка в маску: ті самі гліфи і позиції, що й у DrawTextScaled
+static int TextCache_Rasterize(TextCacheEntry* e, const RasterFont font, const char* text)
+{
+    GlyphRun run = CreateGlyphRun(font, text, e->spacing, e->scale);
+    // Без масиву гліфів для непорожнього рядка - malloc не вдався, а не рядок без пікселів
+    if (!run.glyphs && text[0] != '\0') return 0;
+    if (run.count == 0) {
+        UnloadGlyphRun(run);
+        e->rasterized = 1;
+        return 1;
+    }
+
+    int scale = e->scale;
+    int x0 = run.bounds.x0, y0 = run.bounds.y0, x1 = run.bounds.x1, y1 = run.bounds.y1;
+
+    int stride = (x1 - x0 + 7) / 8;
+    uint8_t* mask = calloc((size_t)stride * (y1 - y0), 1);
+    if (!mask) {
+        UnloadGlyphRun(run);
+        return 0;
+    }
+
+    for (int i = 0; i < run.count; i++) {
+        const GlyphRunGlyph* g = &run.glyphs[i];
+        int glyphStride = (g->width + 7) / 8;
+        for (int row = 0; row < g->height; row++) {
+            const uint8_t* bits = g->bitmap + row * glyphStride;
+            for (int col = 0; col < g->width; col++) {
+                if (!(bits[col >> 3] & (0x80 >> (col & 7)))) continue;
+                int px = g->x - x0 + col * scale;
+                int py = g->y - y0 + row * scale;
+                for (int dy = 0; dy < scale; dy++) {
+                    uint8_t* line = mask + (size_t)(py + dy) * stride;
+                    for (int dx = 0; dx < scale; dx++) line[(px + dx) >> 3] |= 0x80 >> ((px + dx) & 7);
+                }
+            }
+        }
+    }
+    UnloadGlyphRun(run);
+
+    e->mask = mask;
+    e->width = x1 - x0;
+    e->height = y1 - y0;
+    e->offset_x = x0;
+    e->offset_y = y0;
+    e->bytes += (size_t)stride * e->height;
+    g_stats.bytes += (size_t)stride * e->height;
+    e->rasterized = 1;
+    return 1;
+}
+
+int TextCache_DrawText(const RasterFont font, int x, int y, const char* text,
+                       int spacing, int scale, uint32_t color)
+{
+    if (g_budget == 0 || !text || !*text) return 0;
+
+    size_t length = strlen(text);
+    uint64_t hash = TextCache_Hash(font.glyph_map, spacing, scale, text, length);
+    TextCacheEntry* e = TextCache_Find(font.glyph_map, spacing, scale, text, length, hash);
+
+    if (e && e->rasterized) {
+        g_stats.hits++;
+        TextCache_UnlinkLRU(e);
+        TextCache_LinkNewest(e);
+        if (e->mask) DrawBitmapSpans(e->mask, e->width, e->height, x + e->offset_x, y + e->offset_y, 1, color);
+        return 1;
+    }
+    g_stats.misses++;
+
+    if (!e) {
+        // Перша зустріч: лише запам’ятовуємо рядок, малюється він по гліфах
+        e = calloc(1, sizeof(TextCacheEntry));
+        char* copy = malloc(length + 1);
+        if (!e || !copy) {
+            free(e);
+            free(copy);
+            return 0;
+        }
+        memcpy(copy, text, length + 1);
+        e->font = font.glyph_map;
+        e->spacing = spacing;
+        e->scale = scale;
+        e->hash = hash;
+        e->text = copy;
+        e->length = length;
+        e->bytes = sizeof(TextCacheEntry) + length + 1;
+
+        if (g_stats.entries >= g_bucket_count * 2) TextCache_Grow();
+        if (!g_buckets) {
+            free(copy);
+            free(e);
+            return 0;
+        }
+        TextCacheEntry** bucket = TextCache_Bucket(hash);
+        e->bucket_next = *bucket;
+        *bucket = e;
+        TextCache_LinkNewest(e);
+        g_stats.entries++;
+        g_stats.bytes += e->bytes;
+        TextCache_EvictToBudget(NULL);
+        return 0;
+    }
+
+    // Друга зустріч: розтеризуємо рядок і далі малюємо його з кешу
+    TextCache_UnlinkLRU(e);
+    TextCache_LinkNewest(e);
+    if (!TextCache_Rasterize(e, font, text) || !TextCache_EvictToBudget(e)) return 0;
+    if (e->mask) DrawBitmapSpans(e->mask, e->width, e->height, x + e->offset_x, y + e->offset_y, 1, color);
+    return 1;
+}
+
+void TextCache_SetBudget(size_t bytes)
+{
+    g_budget = bytes;
+    if (bytes == 0) TextCache_Clear();
+    else TextCache_EvictToBudget(NULL);
+}
+
+void TextCache_Clear(void)
+{
+    while (g_oldest) TextCache_Remove(g_oldest);
+    free(g_buckets);
+    g_buckets = NULL;
+    g_bucket_count = 0;
+}
+
+TextCacheStats TextCache_GetStats(void)
+{
+    return g_stats;
+}
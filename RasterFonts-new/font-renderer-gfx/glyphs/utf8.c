@@ -0,0 +1,118 @@
+// utf8.c
+
+#include <string.h>
+
+#include "utf8.h"
+
+// SSE2 є на всіх x86-64; на інших платформах - ті самі перевірки по 8 байтів у uint64_t
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define UTF8_USE_SSE2 1
+#endif
+
+#define UTF8_HIGH_BITS 0x8080808080808080ULL
+
+/*
+ * Декодування одного символу з не більше ніж avail байтів (avail >= 1).
+ * Другий байт перевіряється за вужчим діапазоном там, де інакше можливе надлишкове
+ * кодування (E0, F0), сурогати (ED) або коди понад U+10FFFF (F4).
+ */
+static inline int utf8_decode_n(const unsigned char* s, size_t avail, uint32_t* out)
+{
+    unsigned char c = s[0];
+    if (c < 0x80) {
+        *out = c;
+        return 1;
+    }
+
+    int length;
+    uint32_t codepoint;
+    unsigned char lo = 0x80, hi = 0xBF; // допустимий діапазон наступного байта
+    if (c >= 0xC2 && c <= 0xDF) {
+        length = 2;
+        codepoint = c & 0x1F;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+        length = 3;
+        codepoint = c & 0x0F;
+        if (c == 0xE0) lo = 0xA0;
+        else if (c == 0xED) hi = 0x9F;
+    } else if (c >= 0xF0 && c <= 0xF4) {
+        length = 4;
+        codepoint = c & 0x07;
+        if (c == 0xF0) lo = 0x90;
+        else if (c == 0xF4) hi = 0x8F;
+    } else {
+        // Байт продовження без початку, C0/C1 або F5-FF
+        *out = UTF8_REPLACEMENT;
+        return 1;
+    }
+
+    for (int i = 1; i < length; i++) {
+        if ((size_t)i >= avail || s[i] < lo || s[i] > hi) {
+            *out = UTF8_REPLACEMENT;
+            return 1;
+        }
+        codepoint = (codepoint << 6) | (s[i] & 0x3F);
+        lo = 0x80;
+        hi = 0xBF;
+    }
+    *out = codepoint;
+    return length;
+}
+
+// Чи всі 16 байтів з s - ASCII
+static inline int utf8_is_ascii16(const unsigned char* s)
+{
+#ifdef UTF8_USE_SSE2
+    return _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)s)) == 0;
+#else
+    uint64_t a, b;
+    memcpy(&a, s, 8);
+    memcpy(&b, s + 8, 8);
+    return ((a | b) & UTF8_HIGH_BITS) == 0;
+#endif
+}
+
+int utf8_decode(const char* str, uint32_t* out_codepoint)
+{
+    // Перевірка байтів продовження зупиняється на нулі, тож більше 4 байтів не треба
+    return utf8_decode_n((const unsigned char*)str, 4, out_codepoint);
+}
+
+/*
+ * utf8_strlen - підрахунок кількості Unicode символів у UTF-8 рядку.
+ * ASCII-ділянки пропускаються по 16 байтів, інші символи перевіряються так само,
+ * як у utf8_decode, тож некоректний байт рахується одним символом, як при малюванні.
+ */
+int utf8_strlen(const char* s)
+{
+    return (int)utf8_length(s, strlen(s));
+}
+
+size_t utf8_length(const char* s, size_t length)
+{
+    const unsigned char* p = (const unsigned char*)s;
+    size_t i = 0;
+    size_t count = 0;
+
+    while (i < length) {
+        if (length - i >= 16 && utf8_is_ascii16(p + i)) {
+            i += 16;
+            count += 16;
+            continue;
+        }
+        uint32_t codepoint;
+        i += utf8_decode_n(p + i, length - i, &codepoint);
+        count++;
+    }
+    return count;
+}
+
+size_t utf8_ascii_prefix(const char* s, size_t length)
+{
+    const unsigned char* p = (const unsigned char*)s;
+    size_t i = 0;
+    while (length - i >= 16 && utf8_is_ascii16(p + i)) i += 16;
+    while (i < length && p[i] < 0x80) i++;
+    return i;
+}
@@ -0,0 +1,80 @@
+// clip.c
+
+#include <stdio.h>
+
+#include "clip.h"
+#include "gfx.h"
+
+// Перетини стеку: g_stack[i] - перетин перших i + 1 прямокутників.
+// g_depth - логічна глибина, може перевищувати CLIP_STACK_DEPTH
+static RenderRect g_stack[CLIP_STACK_DEPTH];
+static int g_depth = 0;
+// Нижня межа поточної області (PushClipScope): прямокутники нижче не відсікають
+static int g_base = 0;
+// Прямокутники понад CLIP_STACK_DEPTH: окремо не зберігаються, а звужують один
+// спільний перетин. PopClipRect його не розширює (відсікання лише надлишкове),
+// а повернення до CLIP_STACK_DEPTH знову відкриває точний g_stack.
+// g_overflow_base - область, у якій перетин обчислено
+static RenderRect g_overflow_rect;
+static int g_overflow_base = 0;
+
+static const RenderRect g_unbounded = { -CLIP_UNBOUNDED, -CLIP_UNBOUNDED, CLIP_UNBOUNDED, CLIP_UNBOUNDED };
+static const RenderRect g_empty = { 0, 0, 0, 0 };
+
+void PushClipRect(int x, int y, int width, int height)
+{
+    RenderRect rect = { x, y, x + (width > 0 ? width : 0), y + (height > 0 ? height : 0) };
+    rect = ClipRect_Intersect(rect, GetClipRect());
+
+    if (g_depth < CLIP_STACK_DEPTH) {
+        g_stack[g_depth] = rect;
+    } else {
+        if (g_depth == CLIP_STACK_DEPTH) fprintf(stderr, "Стек відсікання переповнено (понад %d)\n", CLIP_STACK_DEPTH);
+        g_overflow_rect = rect;
+        g_overflow_base = g_base;
+    }
+    g_depth++;
+}
+
+void PopClipRect(void)
+{
+    if (g_depth == g_base) {
+        fprintf(stderr, "PopClipRect без PushClipRect\n");
+        return;
+    }
+    g_depth--;
+}
+
+int PushClipScope(void)
+{
+    int scope = g_base;
+    g_base = g_depth;
+    return scope;
+}
+
+void PopClipScope(int scope)
+{
+    g_base = scope;
+}
+
+RenderRect GetClipRect(void)
+{
+    if (g_depth <= g_base) return g_unbounded;
+    if (g_depth <= CLIP_STACK_DEPTH) return g_stack[g_depth - 1];
+    // Перетин з іншої області не стосується цих координат: відсікаємо все
+    return (g_overflow_base == g_base) ? g_overflow_rect : g_empty;
+}
+
+RenderRect GetVisibleRect(void)
+{
+    RenderRect bounds = { 0, 0, 0, 0 };
+    RenderTarget* target = GetActiveRenderTarget();
+    if (target) {
+        bounds.x1 = target->width;
+        bounds.y1 = target->height;
+    } else {
+        bounds.x1 = gfx_xsize();
+        bounds.y1 = gfx_ysize();
+    }
+    return ClipRect_Intersect(bounds, GetClipRect());
+}
@@ -0,0 +1,276 @@
+// draw_list.c
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "draw_list.h"
+#include "graphics.h"  // DrawRectangle, DrawRectangleLines, DrawThickLine
+#include "clip.h"      // межі команд і відсікання при виконанні
+
+// Вирівнювання параметрів команд у буфері списку
+#define DRAW_LIST_DATA_ALIGN 16
+
+// Пакет з більшою кількістю команд перевіряється на перетин лише за загальними межами
+#define DRAW_LIST_EXACT_TEST 16
+
+static int DrawList_Intersects(RenderRect a, RenderRect b)
+{
+    return a.x0 < b.x1 && b.x0 < a.x1 && a.y0 < b.y1 && b.y0 < a.y1;
+}
+
+static RenderRect DrawList_Union(RenderRect a, RenderRect b)
+{
+    RenderRect r;
+    r.x0 = (a.x0 < b.x0) ? a.x0 : b.x0;
+    r.y0 = (a.y0 < b.y0) ? a.y0 : b.y0;
+    r.x1 = (a.x1 > b.x1) ? a.x1 : b.x1;
+    r.y1 = (a.y1 > b.y1) ? a.y1 : b.y1;
+    return r;
+}
+
+void DrawList_Init(DrawList* list)
+{
+    memset(list, 0, sizeof(*list));
+}
+
+void DrawList_Free(DrawList* list)
+{
+    free(list->commands);
+    free(list->data);
+    free(list->batches);
+    memset(list, 0, sizeof(*list));
+}
+
+uint64_t DrawList_State(const void* font, uint32_t color)
+{
+    // Збіг ключів різних станів лише об’єднує їх пакети - порядок від цього не залежить
+    return ((uint64_t)(uintptr_t)font * 0x9E3779B97F4A7C15ULL) ^ (color & 0xFFFFFF);
+}
+
+void* DrawList_Record(DrawList* list, RenderRect bounds, uint64_t state, DamageDrawFunc draw, size_t size)
+{
+    if (list->count == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 64;
+        DrawListCommand* commands = realloc(list->commands, capacity * sizeof(DrawListCommand));
+        if (!commands) goto fail;
+        list->commands = commands;
+        list->capacity = capacity;
+    }
+
+    size_t offset = (list->dataSize + DRAW_LIST_DATA_ALIGN - 1) & ~(size_t)(DRAW_LIST_DATA_ALIGN - 1);
+    if (offset + size > list->dataCapacity) {
+        size_t capacity = list->dataCapacity ? list->dataCapacity : 4096;
+        while (capacity < offset + size) capacity *= 2;
+        uint8_t* data = realloc(list->data, capacity);
+        if (!data) goto fail;
+        list->data = data;
+        list->dataCapacity = capacity;
+    }
+
+    // Відсікання на момент запису: при виконанні команда обмежується саме ним,
+    // а невидима команда не заважає переносити інші
+    bounds = ClipRect_Intersect(bounds, GetVisibleRect());
+
+    DrawListCommand* command = &list->commands[list->count++];
+    command->bounds = bounds;
+    command->state = state;
+    command->draw = draw;
+    command->data = offset;
+    command->next = -1;
+
+    list->dataSize = offset + size;
+    memset(list->data + offset, 0, size);
+    return list->data + offset;
+
+fail:
+    // Без запису порядок зберігається, лише якщо все записане вже намальовано
+    fprintf(stderr, "Помилка виділення пам’яті для команди списку малювання\n");
+    DrawList_Flush(list);
+    return NULL;
+}
+
+// Чи може команда з межами bounds перетинатися з командами пакета
+static int DrawList_BatchOverlaps(const DrawList* list, const DrawListBatch* batch, RenderRect bounds)
+{
+    if (!DrawList_Intersects(batch->bounds, bounds)) return 0;
+    if (batch->count > DRAW_LIST_EXACT_TEST) return 1;
+
+    for (int i = batch->first; i >= 0; i = list->commands[i].next) {
+        if (DrawList_Intersects(list->commands[i].bounds, bounds)) return 1;
+    }
+    return 0;
+}
+
+// Розкладка команд по пакетах, повертає кількість пакетів. Команда приєднується до
+// найранішого з останніх пакетів з тим самим станом, після якого немає команд, з якими
+// вона перетинається; інакше відкриває новий пакет у кінці
+static int DrawList_Sort(DrawList* list)
+{
+    int batchCount = 0;
+    for (int i = 0; i < list->count; i++) {
+        DrawListCommand* c = &list->commands[i];
+        if (c->bounds.x0 >= c->bounds.x1 || c->bounds.y0 >= c->bounds.y1) continue;
+
+        int join = -1;
+        int stop = (batchCount > DRAW_LIST_LOOKBACK) ? batchCount - DRAW_LIST_LOOKBACK : 0;
+        for (int b = batchCount - 1; b >= stop; b--) {
+            DrawListBatch* batch = &list->batches[b];
+            if (batch->state == c->state) join = b;
+            if (DrawList_BatchOverlaps(list, batch, c->bounds)) break;
+        }
+
+        if (join < 0) {
+            DrawListBatch* batch = &list->batches[batchCount++];
+            batch->state = c->state;
+            batch->bounds = c->bounds;
+            batch->first = batch->last = i;
+            batch->count = 1;
+            continue;
+        }
+
+        DrawListBatch* batch = &list->batches[join];
+        list->commands[batch->last].next = i;
+        batch->last = i;
+        batch->count++;
+        batch->bounds = DrawList_Union(batch->bounds, c->bounds);
+    }
+    return batchCount;
+}
+
+// Виконання команди з її межами як прямокутником відсікання
+static void DrawList_Execute(DrawList* list, const DrawListCommand* c)
+{
+    PushClipRect(c->bounds.x0, c->bounds.y0, c->bounds.x1 - c->bounds.x0, c->bounds.y1 - c->bounds.y0);
+    c->draw(list->data + c->data, 0, 0);
+    PopClipRect();
+    list->stats.commands++;
+}
+
+void DrawList_Flush(DrawList* list)
+{
+    list->stats.frames++;
+    if (list->count == 0) return;
+
+    // Зміни стану в порядку запису - для порівняння зі статистикою пакетів
+    int visible = 0;
+    uint64_t state = 0;
+    for (int i = 0; i < list->count; i++) {
+        const DrawListCommand* c = &list->commands[i];
+        if (c->bounds.x0 >= c->bounds.x1 || c->bounds.y0 >= c->bounds.y1) continue;
+        if (visible++ == 0 || c->state != state) list->stats.recorded++;
+        state = c->state;
+    }
+
+    if (list->batchCapacity < list->count) {
+        DrawListBatch* batches = realloc(list->batches, list->capacity * sizeof(DrawListBatch));
+        if (batches) {
+            list->batches = batches;
+            list->batchCapacity = list->capacity;
+        }
+    }
+
+    // Межі записано з відсіканням на момент запису: поточний стек відсікання не діє
+    int scope = PushClipScope();
+    if (list->batchCapacity >= list->count) {
+        int batchCount = DrawList_Sort(list);
+        for (int b = 0; b < batchCount; b++) {
+            for (int i = list->batches[b].first; i >= 0; i = list->commands[i].next)
+                DrawList_Execute(list, &list->commands[i]);
+        }
+        list->stats.batches += (uint64_t)batchCount;
+    } else {
+        // Немає пам’яті для пакетів - у порядку запису
+        for (int i = 0; i < list->count; i++) {
+            const DrawListCommand* c = &list->commands[i];
+            if (c->bounds.x0 >= c->bounds.x1 || c->bounds.y0 >= c->bounds.y1) continue;
+            DrawList_Execute(list, c);
+        }
+        list->stats.batches += (uint64_t)visible;
+    }
+    PopClipScope(scope);
+
+    DrawList_Clear(list);
+}
+
+void DrawList_Clear(DrawList* list)
+{
+    list->count = 0;
+    list->dataSize = 0;
+}
+
+typedef struct {
+    int x1, y1, x2, y2;
+    int thickness;
+    uint32_t color;
+} QueuedShape;
+
+static void DrawQueuedRectangle(const void* data, int dx, int dy)
+{
+    const QueuedShape* s = (const QueuedShape*)data;
+    DrawRectangle(s->x1 + dx, s->y1 + dy, s->x2, s->y2, s->color);
+}
+
+static void DrawQueuedRectangleLines(const void* data, int dx, int dy)
+{
+    const QueuedShape* s = (const QueuedShape*)data;
+    DrawRectangleLines(s->x1 + dx, s->y1 + dy, s->x2, s->y2, s->color);
+}
+
+static void DrawQueuedLine(const void* data, int dx, int dy)
+{
+    const QueuedShape* s = (const QueuedShape*)data;
+    DrawThickLine(s->x1 + dx, s->y1 + dy, s->x2 + dx, s->y2 + dy, s->thickness, s->color);
+}
+
+// Запис фігури: (x1, y1, x2, y2) - кути лінії або позиція і розмір прямокутника
+static void QueueShape(DrawList* list, RenderRect bounds, DamageDrawFunc draw,
+                       int x1, int y1, int x2, int y2, int thickness, uint32_t color)
+{
+    QueuedShape* s = DrawList_Record(list, bounds, DrawList_State(NULL, color), draw, sizeof(QueuedShape));
+    QueuedShape direct;
+    if (!s) s = &direct;
+    s->x1 = x1;
+    s->y1 = y1;
+    s->x2 = x2;
+    s->y2 = y2;
+    s->thickness = thickness;
+    s->color = color;
+    if (s == &direct) draw(s, 0, 0);
+}
+
+void QueueRectangle(DrawList* list, int x, int y, int width, int height, uint32_t color)
+{
+    if (width <= 0 || height <= 0) return;
+
+    RenderRect bounds = { x, y, x + width, y + height };
+    QueueShape(list, bounds, DrawQueuedRectangle, x, y, width, height, 0, color);
+}
+
+void QueueRectangleLines(DrawList* list, int x, int y, int width, int height, uint32_t color)
+{
+    // Ті самі межі, що й у RecordRectangleLines
+    if (width <= 0 && height <= 0) return;
+
+    int left = (width > 0) ? x : x + width - 1;
+    int top = (height > 0) ? y : y + height - 1;
+    RenderRect bounds = { left, top, 0, 0 };
+    bounds.x1 = ((width > 0) ? x + width : x + 1);
+    bounds.y1 = ((height > 0) ? y + height : y + 1);
+    QueueShape(list, bounds, DrawQueuedRectangleLines, x, y, width, height, 0, color);
+}
+
+void QueueLine(DrawList* list, int x1, int y1, int x2, int y2, int thickness, uint32_t color)
+{
+    if (thickness <= 0) return;
+
+    // DrawThickLine зсуває квадрати thickness x thickness від лінії не більше ніж на
+    // (thickness / 2)^2 пікселів у кожен бік
+    int reach = (thickness / 2 + 1) * (thickness / 2 + 1);
+    RenderRect bounds;
+    bounds.x0 = ((x1 < x2) ? x1 : x2) - reach;
+    bounds.y0 = ((y1 < y2) ? y1 : y2) - reach;
+    bounds.x1 = ((x1 > x2) ? x1 : x2) + reach + thickness;
+    bounds.y1 = ((y1 > y2) ? y1 : y2) + reach + thickness;
+    QueueShape(list, bounds, DrawQueuedLine, x1, y1, x2, y2, thickness, color);
+}
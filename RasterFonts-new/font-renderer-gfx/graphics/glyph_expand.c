@@ -0,0 +1,208 @@
+// glyph_expand.c
+
+#include <string.h>
+#include <pthread.h>
+
+#include "glyph_expand.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <immintrin.h>
+  #if defined(__SSE2__)
+    #define GLYPH_EXPAND_SSE2 1
+  #endif
+  #if defined(__GNUC__)
+    #define GLYPH_EXPAND_AVX2 1
+  #endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #include <arm_neon.h>
+  #define GLYPH_EXPAND_NEON 1
+#endif
+
+// Максимальна кількість вихідних стовпців, що обробляються за один прохід
+#define GLYPH_EXPAND_MAX_COLUMNS 1024
+
+/*
+ * Принцип роботи: рядок джерела читається вікнами по 32 біти (big-endian слово W).
+ * Для кожного вихідного стовпця заздалегідь (один раз на виклик) обчислюється
+ * маска 1 << (31 - біт_у_вікні), тож масштаб по горизонталі - це лише таблиця масок.
+ * Піксель належить гліфу, якщо (W & mask) != 0; векторні ядра перевіряють так
+ * 4 (SSE2/NEON) або 8 (AVX2) пікселів за раз.
+ */
+
+// Ядро: запис count пікселів dst за словом word і масками masks
+typedef void (*GlyphExpandKernel)(uint32_t* dst, uint32_t word, const uint32_t* masks,
+                                  int count, uint32_t fg, uint32_t bg, int opaque);
+
+static void ExpandKernelScalar(uint32_t* dst, uint32_t word, const uint32_t* masks,
+                               int count, uint32_t fg, uint32_t bg, int opaque)
+{
+    if (opaque) {
+        for (int i = 0; i < count; ++i) dst[i] = (word & masks[i]) ? fg : bg;
+    } else {
+        for (int i = 0; i < count; ++i) {
+            if (word & masks[i]) dst[i] = fg;
+        }
+    }
+}
+
+#ifdef GLYPH_EXPAND_SSE2
+static void ExpandKernelSSE2(uint32_t* dst, uint32_t word, const uint32_t* masks,
+                             int count, uint32_t fg, uint32_t bg, int opaque)
+{
+    const __m128i w = _mm_set1_epi32((int)word);
+    const __m128i vfg = _mm_set1_epi32((int)fg);
+    const __m128i vbg = _mm_set1_epi32((int)bg);
+    const __m128i zero = _mm_setzero_si128();
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i m = _mm_loadu_si128((const __m128i*)(masks + i));
+        // clear = 0xFFFFFFFF там, де біт гліфа не встановлений
+        __m128i clear = _mm_cmpeq_epi32(_mm_and_si128(w, m), zero);
+        __m128i base = opaque ? vbg : _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i out = _mm_or_si128(_mm_and_si128(clear, base), _mm_andnot_si128(clear, vfg));
+        _mm_storeu_si128((__m128i*)(dst + i), out);
+    }
+    ExpandKernelScalar(dst + i, word, masks + i, count - i, fg, bg, opaque);
+}
+#endif
+
+#ifdef GLYPH_EXPAND_AVX2
+__attribute__((target("avx2")))
+static void ExpandKernelAVX2(uint32_t* dst, uint32_t word, const uint32_t* masks,
+                             int count, uint32_t fg, uint32_t bg, int opaque)
+{
+    const __m256i w = _mm256_set1_epi32((int)word);
+    const __m256i vfg = _mm256_set1_epi32((int)fg);
+    const __m256i vbg = _mm256_set1_epi32((int)bg);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi32(-1);
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i m = _mm256_loadu_si256((const __m256i*)(masks + i));
+        __m256i clear = _mm256_cmpeq_epi32(_mm256_and_si256(w, m), zero);
+        if (opaque) {
+            _mm256_storeu_si256((__m256i*)(dst + i), _mm256_blendv_epi8(vfg, vbg, clear));
+        } else {
+            // Маскований запис лише пікселів гліфа
+            _mm256_maskstore_epi32((int*)(dst + i), _mm256_xor_si256(clear, ones), vfg);
+        }
+    }
+    ExpandKernelScalar(dst + i, word, masks + i, count - i, fg, bg, opaque);
+}
+#endif
+
+#ifdef GLYPH_EXPAND_NEON
+static void ExpandKernelNEON(uint32_t* dst, uint32_t word, const uint32_t* masks,
+                             int count, uint32_t fg, uint32_t bg, int opaque)
+{
+    const uint32x4_t w = vdupq_n_u32(word);
+    const uint32x4_t vfg = vdupq_n_u32(fg);
+    const uint32x4_t vbg = vdupq_n_u32(bg);
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        // set = 0xFFFFFFFF там, де біт гліфа встановлений
+        uint32x4_t set = vtstq_u32(w, vld1q_u32(masks + i));
+        uint32x4_t base = opaque ? vbg : vld1q_u32(dst + i);
+        vst1q_u32(dst + i, vbslq_u32(set, vfg, base));
+    }
+    ExpandKernelScalar(dst + i, word, masks + i, count - i, fg, bg, opaque);
+}
+#endif
+
+static GlyphExpandKernel expand_kernel = NULL;
+static const char* expand_backend = "scalar";
+static pthread_once_t expand_once = PTHREAD_ONCE_INIT;
+
+// Вибір ядра за можливостями CPU (один раз через pthread_once: першим
+// ExpandGlyphBits може бути виклик із кількох потоків RenderPool одночасно)
+static void SelectGlyphExpandKernel(void)
+{
+    expand_kernel = ExpandKernelScalar;
+    expand_backend = "scalar";
+#ifdef GLYPH_EXPAND_SSE2
+    expand_kernel = ExpandKernelSSE2;
+    expand_backend = "sse2";
+#endif
+#ifdef GLYPH_EXPAND_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        expand_kernel = ExpandKernelAVX2;
+        expand_backend = "avx2";
+    }
+#endif
+#ifdef GLYPH_EXPAND_NEON
+    expand_kernel = ExpandKernelNEON;
+    expand_backend = "neon";
+#endif
+}
+
+const char* GetGlyphExpandBackend(void)
+{
+    pthread_once(&expand_once, SelectGlyphExpandKernel);
+    return expand_backend;
+}
+
+// 32 біти рядка джерела, починаючи з пікселя first_bit (кратного 8), як big-endian слово
+static uint32_t LoadGlyphWord(const uint8_t* row, int bytes_per_row, int first_bit)
+{
+    uint32_t word = 0;
+    int byte = first_bit >> 3;
+    for (int k = 0; k < 4; ++k) {
+        word <<= 8;
+        if (byte + k < bytes_per_row) word |= row[byte + k];
+    }
+    return word;
+}
+
+void ExpandGlyphBits(uint32_t* dst, int dst_stride,
+                     const uint8_t* bitmap, int width, int height, int scale,
+                     int out_x0, int out_y0, int out_x1, int out_y1,
+                     uint32_t fg, uint32_t bg, int opaque)
+{
+    pthread_once(&expand_once, SelectGlyphExpandKernel);
+    if (!bitmap || width <= 0 || height <= 0 || scale < 1) return;
+
+    if (out_x0 < 0) out_x0 = 0;
+    if (out_y0 < 0) out_y0 = 0;
+    if (out_x1 > width * scale) out_x1 = width * scale;
+    if (out_y1 > height * scale) out_y1 = height * scale;
+    if (out_x0 >= out_x1 || out_y0 >= out_y1) return;
+
+    int bytes_per_row = (width + 7) / 8;
+    uint32_t masks[GLYPH_EXPAND_MAX_COLUMNS];
+
+    // Стовпці обробляються відрізками, що лежать в одному 32-бітному вікні джерела
+    for (int col = out_x0; col < out_x1; ) {
+        int window = (col / scale) >> 5;                 // номер 32-бітного вікна
+        int window_end = ((window + 1) << 5) * scale;    // перший стовпець наступного вікна
+        int seg_end = out_x1 < window_end ? out_x1 : window_end;
+        if (seg_end - col > GLYPH_EXPAND_MAX_COLUMNS) seg_end = col + GLYPH_EXPAND_MAX_COLUMNS;
+        int count = seg_end - col;
+
+        for (int i = 0; i < count; ++i) {
+            int bit = (col + i) / scale - (window << 5);
+            masks[i] = 1u << (31 - bit);
+        }
+
+        uint8_t* out_row = (uint8_t*)dst + (col - out_x0) * (int)sizeof(uint32_t);
+        int src_row = -1;
+        uint32_t word = 0;
+        for (int y = out_y0; y < out_y1; ++y, out_row += dst_stride) {
+            int r = y / scale;
+            if (r != src_row) {
+                src_row = r;
+                word = LoadGlyphWord(bitmap + r * bytes_per_row, bytes_per_row, window << 5);
+            } else if (opaque) {
+                // Повтор того ж рядка джерела при масштабі - просто копія
+                memcpy(out_row, out_row - dst_stride, (size_t)count * sizeof(uint32_t));
+                continue;
+            }
+            if (word == 0 && !opaque) continue; // порожнє вікно - нічого писати
+            expand_kernel((uint32_t*)out_row, word, masks, count, fg, bg, opaque);
+        }
+        col = seg_end;
+    }
+}
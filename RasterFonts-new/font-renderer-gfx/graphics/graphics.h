@@ -8,6 +8,8 @@ extern "C" {
 #endif
 
 #include "color.h"
+#include "render_target.h"
+#include "clip.h"
 
 #include <stdint.h>
 #include <math.h>
@@ -30,9 +32,22 @@ void DrawThickLine(int x1, int y1, int x2, int y2, int thickness, uint32_t color
 void DrawLineEx(Vector2 startPos, Vector2 endPos, float thickness, uint32_t color);
 
 // Малювання заповненого прямокутника кольором color (у форматі 0xRRGGBB)
-void DrawRectangle(int16_t x, int16_t y, int16_t width, int16_t height, uint32_t color);
+void DrawRectangle(int x, int y, int width, int height, uint32_t color);
 // Малювання не заповненого прямокутника кольором color (у форматі 0xRRGGBB)
-void DrawRectangleLines(int16_t x, int16_t y, int16_t width, int16_t height, uint32_t color);
+void DrawRectangleLines(int x, int y, int width, int height, uint32_t color);
+
+// Малювання монохромного бітмапа (1 біт на піксель, старший біт зліва) з масштабом scale:
+// кожна серія встановлених бітів рядка малюється одним прямокутником через DrawSpans.
+// Бітмап поза прямокутником відсікання (PushClipRect) відкидається цілком, частково
+// видимий відсікається по рядках і стовпцях
+void DrawBitmapSpans(const uint8_t* bitmap, int width, int height,
+                     int x, int y, int scale, uint32_t color);
+
+// Непрозорий бітмап: кожен піксель прямокутника (width * scale) x (height * scale)
+// отримує fg (біт встановлено) або bg за один прохід, без окремої заливки фону.
+// Відсікається так само, як DrawBitmapSpans
+void DrawBitmapOpaque(const uint8_t* bitmap, int width, int height,
+                      int x, int y, int scale, uint32_t fg, uint32_t bg);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,32 @@
+#ifndef RENDER_POOL_H
+#define RENDER_POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Найбільша кількість потоків малювання разом з потоком, що викликає RenderPool_Run
+#define RENDER_POOL_MAX_THREADS 8
+
+// Завдання index з count (наприклад, смуга цілі малювання)
+typedef void (*RenderPoolJob)(int index, void* user);
+
+// Виконання job(0..count-1, user) на пулі потоків; повертається, коли виконано всі.
+// Завдання спершу діляться між потоками порівну, потік, що звільнився, забирає
+// завдання з кінця чужої частини. Потік, що викликає, теж виконує завдання.
+// Завдання з різними index мають писати в різні дані - блокувань немає
+void RenderPool_Run(int count, RenderPoolJob job, void* user);
+
+// Кількість потоків малювання (з потоком, що викликає): 0 - за кількістю ядер
+// (за замовчуванням), 1 - усе малюється в потоці, що викликає
+void RenderPool_SetThreadCount(int threads);
+int RenderPool_GetThreadCount(void);
+
+// Зупинка робочих потоків (наступний RenderPool_Run запустить їх знову)
+void RenderPool_Shutdown(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RENDER_POOL_H
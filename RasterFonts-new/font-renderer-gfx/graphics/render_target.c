@@ -0,0 +1,163 @@
+// render_target.c
+
+#include <stddef.h>
+
+#include "render_target.h"
+#include "gfx.h"
+#include "glyph_expand.h"
+
+// Активна ціль малювання (NULL - малювання у вікно)
+static RenderTarget* active_target = NULL;
+// Ціль за замовчуванням, до якої повертає EndRenderTarget
+static RenderTarget* default_target = NULL;
+
+RenderTarget RenderTarget_Init(uint32_t* pixels, int width, int height, int stride)
+{
+    RenderTarget target;
+    target.pixels = pixels;
+    target.width = width;
+    target.height = height;
+    target.stride = (stride > 0) ? stride : width * (int)sizeof(uint32_t);
+    target.dirty_x0 = target.dirty_y0 = 0;
+    target.dirty_x1 = target.dirty_y1 = 0;
+    return target;
+}
+
+RenderTarget RenderTarget_Band(const RenderTarget* target, int y0, int y1)
+{
+    RenderRect rect = { 0, y0, target->width, y1 };
+    return RenderTarget_View(target, rect);
+}
+
+RenderTarget RenderTarget_View(const RenderTarget* target, RenderRect rect)
+{
+    if (rect.x0 < 0) rect.x0 = 0;
+    if (rect.y0 < 0) rect.y0 = 0;
+    if (rect.x1 > target->width) rect.x1 = target->width;
+    if (rect.y1 > target->height) rect.y1 = target->height;
+    if (rect.x1 < rect.x0) rect.x1 = rect.x0;
+    if (rect.y1 < rect.y0) rect.y1 = rect.y0;
+    return RenderTarget_Init(RenderTarget_Row(target, rect.y0) + rect.x0,
+                             rect.x1 - rect.x0, rect.y1 - rect.y0, target->stride);
+}
+
+void BeginRenderTarget(RenderTarget* target)
+{
+    active_target = target;
+}
+
+void EndRenderTarget(void)
+{
+    active_target = default_target;
+}
+
+RenderTarget* GetActiveRenderTarget(void)
+{
+    return active_target;
+}
+
+void SetDefaultRenderTarget(RenderTarget* target)
+{
+    // Якщо активною була попередня ціль за замовчуванням - переключаємося на нову
+    if (active_target == default_target) active_target = target;
+    default_target = target;
+}
+
+void RenderTarget_ResetDirty(RenderTarget* target)
+{
+    target->dirty_x0 = target->dirty_y0 = 0;
+    target->dirty_x1 = target->dirty_y1 = 0;
+}
+
+void RenderTarget_Clear(RenderTarget* target, uint32_t color)
+{
+    RenderTarget_FillRect(target, 0, 0, target->width, target->height, color);
+}
+
+void RenderTarget_FillRect(RenderTarget* target, int x, int y, int width, int height, uint32_t color)
+{
+    // Відсікання по межах цілі
+    int x0 = (x < 0) ? 0 : x;
+    int y0 = (y < 0) ? 0 : y;
+    int x1 = x + width;
+    int y1 = y + height;
+    if (x1 > target->width) x1 = target->width;
+    if (y1 > target->height) y1 = target->height;
+    if (x0 >= x1 || y0 >= y1) return;
+
+    RenderTarget_MarkDirty(target, x0, y0, x1, y1);
+
+    uint32_t pixel = 0xFF000000u | color;
+    for (int py = y0; py < y1; ++py) {
+        uint32_t* row = RenderTarget_Row(target, py);
+        for (int px = x0; px < x1; ++px) {
+            row[px] = pixel;
+        }
+    }
+}
+
+// Спільна частина RenderTarget_DrawBitmap*: відсікання по clip і межах цілі, розгортання
+// і облік зміненої області. Бітмап поза clip відкидається до читання бітів, частково
+// видимий розгортається лише у видимих рядках і стовпцях
+static void RenderTarget_ExpandBitmap(RenderTarget* target, RenderRect clip, const uint8_t* bitmap,
+                                      int width, int height, int x, int y, int scale,
+                                      uint32_t fg, uint32_t bg, int opaque)
+{
+    if (!bitmap || width <= 0 || height <= 0 || scale < 1) return;
+
+    // Межі бітмапа на цілі після відсікання
+    int x0 = (x < 0) ? 0 : x;
+    int y0 = (y < 0) ? 0 : y;
+    int x1 = x + width * scale;
+    int y1 = y + height * scale;
+    if (x1 > target->width) x1 = target->width;
+    if (y1 > target->height) y1 = target->height;
+    if (x0 < clip.x0) x0 = clip.x0;
+    if (y0 < clip.y0) y0 = clip.y0;
+    if (x1 > clip.x1) x1 = clip.x1;
+    if (y1 > clip.y1) y1 = clip.y1;
+    if (x0 >= x1 || y0 >= y1) return;
+
+    ExpandGlyphBits(RenderTarget_Row(target, y0) + x0, target->stride,
+                    bitmap, width, height, scale,
+                    x0 - x, y0 - y, x1 - x, y1 - y,
+                    0xFF000000u | fg, 0xFF000000u | bg, opaque);
+    RenderTarget_MarkDirty(target, x0, y0, x1, y1);
+}
+
+// Уся ціль (без додаткового відсікання)
+static RenderRect RenderTarget_Bounds(const RenderTarget* target)
+{
+    RenderRect bounds = { 0, 0, target->width, target->height };
+    return bounds;
+}
+
+void RenderTarget_DrawBitmap(RenderTarget* target, const uint8_t* bitmap, int width, int height,
+                             int x, int y, int scale, uint32_t color)
+{
+    RenderTarget_ExpandBitmap(target, RenderTarget_Bounds(target), bitmap, width, height, x, y, scale, color, 0, 0);
+}
+
+void RenderTarget_DrawBitmapClipped(RenderTarget* target, RenderRect clip, const uint8_t* bitmap,
+                                    int width, int height, int x, int y, int scale, uint32_t color)
+{
+    RenderTarget_ExpandBitmap(target, clip, bitmap, width, height, x, y, scale, color, 0, 0);
+}
+
+void RenderTarget_DrawBitmapOpaque(RenderTarget* target, const uint8_t* bitmap, int width, int height,
+                                   int x, int y, int scale, uint32_t fg, uint32_t bg)
+{
+    RenderTarget_ExpandBitmap(target, RenderTarget_Bounds(target), bitmap, width, height, x, y, scale, fg, bg, 1);
+}
+
+void RenderTarget_DrawBitmapOpaqueClipped(RenderTarget* target, RenderRect clip, const uint8_t* bitmap,
+                                          int width, int height, int x, int y, int scale,
+                                          uint32_t fg, uint32_t bg)
+{
+    RenderTarget_ExpandBitmap(target, clip, bitmap, width, height, x, y, scale, fg, bg, 1);
+}
+
+void RenderTarget_Present(const RenderTarget* target, int x, int y)
+{
+    gfx_put_image(target->pixels, target->width, target->height, target->stride, x, y);
+}
@@ -0,0 +1,105 @@
+#ifndef RENDER_TARGET_H
+#define RENDER_TARGET_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Ціль малювання в пам'яті: буфер ARGB8888, наданий викликачем.
+// Поки ціль активна (BeginRenderTarget), DrawPixel/DrawSpans і все, що на них
+// побудовано (гліфи, прямокутники, лінії), пишуть прямо в буфер без X11.
+typedef struct {
+    uint32_t* pixels;   // початок буфера (0xAARRGGBB)
+    int width;          // ширина в пікселях
+    int height;         // висота в пікселях
+    int stride;         // кількість байтів на рядок (>= width * 4)
+    // Змінена з останнього RenderTarget_ResetDirty область: [x0, x1) x [y0, y1),
+    // порожня, якщо dirty_x0 >= dirty_x1
+    int dirty_x0, dirty_y0, dirty_x1, dirty_y1;
+} RenderTarget;
+
+// Прямокутник [x0, x1) x [y0, y1) у пікселях цілі
+typedef struct {
+    int x0, y0, x1, y1;
+} RenderRect;
+
+// Створення опису цілі поверх готового буфера (stride <= 0 - щільні рядки)
+RenderTarget RenderTarget_Init(uint32_t* pixels, int width, int height, int stride);
+
+// Перенаправлення малювання в target / повернення до вікна
+void BeginRenderTarget(RenderTarget* target);
+void EndRenderTarget(void);
+// Поточна активна ціль або NULL, якщо малювання йде у вікно
+RenderTarget* GetActiveRenderTarget(void);
+// Ціль, до якої повертає EndRenderTarget (наприклад, бекбуфер вікна), або NULL
+void SetDefaultRenderTarget(RenderTarget* target);
+
+// Смуга цілі: рядки [y0, y1) target як окрема ціль поверх того самого буфера.
+// Малювання в смугу відсікається по її межах, тож різні смуги можна малювати
+// з різних потоків; змінена область смуги рахується від її рядка 0
+RenderTarget RenderTarget_Band(const RenderTarget* target, int y0, int y1);
+// Частина цілі: прямокутник rect (відсічений по межах target) як окрема ціль з
+// початком координат у (rect.x0, rect.y0)
+RenderTarget RenderTarget_View(const RenderTarget* target, RenderRect rect);
+
+// Скидання зміненої області (після виводу на екран)
+void RenderTarget_ResetDirty(RenderTarget* target);
+
+// Заливка всієї цілі кольором 0xRRGGBB
+void RenderTarget_Clear(RenderTarget* target, uint32_t color);
+// Заливка прямокутника з відсіканням по межах цілі
+void RenderTarget_FillRect(RenderTarget* target, int x, int y, int width, int height, uint32_t color);
+
+// Малювання монохромного бітмапа (1 біт на піксель, старший біт зліва) з масштабом scale
+// у позицію (x, y): лише пікселі гліфа кольором color (векторні ядра ExpandGlyphBits)
+void RenderTarget_DrawBitmap(RenderTarget* target, const uint8_t* bitmap, int width, int height,
+                             int x, int y, int scale, uint32_t color);
+// Те саме, але лише в межах прямокутника clip (у координатах цілі)
+void RenderTarget_DrawBitmapClipped(RenderTarget* target, RenderRect clip, const uint8_t* bitmap,
+                                    int width, int height, int x, int y, int scale, uint32_t color);
+// Те саме, що RenderTarget_DrawBitmap, але фон бітмапа заливається кольором bg в тому ж проході
+void RenderTarget_DrawBitmapOpaque(RenderTarget* target, const uint8_t* bitmap, int width, int height,
+                                   int x, int y, int scale, uint32_t fg, uint32_t bg);
+// Те саме, що RenderTarget_DrawBitmapOpaque, але лише в межах прямокутника clip
+void RenderTarget_DrawBitmapOpaqueClipped(RenderTarget* target, RenderRect clip, const uint8_t* bitmap,
+                                          int width, int height, int x, int y, int scale,
+                                          uint32_t fg, uint32_t bg);
+
+// Вивід вмісту цілі у вікно одним блітом у позицію (x, y)
+void RenderTarget_Present(const RenderTarget* target, int x, int y);
+
+// Розширення зміненої області прямокутником [x0, x1) x [y0, y1) (вже відсіченим)
+static inline void RenderTarget_MarkDirty(RenderTarget* target, int x0, int y0, int x1, int y1)
+{
+    if (target->dirty_x0 >= target->dirty_x1) {
+        target->dirty_x0 = x0; target->dirty_y0 = y0;
+        target->dirty_x1 = x1; target->dirty_y1 = y1;
+        return;
+    }
+    if (x0 < target->dirty_x0) target->dirty_x0 = x0;
+    if (y0 < target->dirty_y0) target->dirty_y0 = y0;
+    if (x1 > target->dirty_x1) target->dirty_x1 = x1;
+    if (y1 > target->dirty_y1) target->dirty_y1 = y1;
+}
+
+// Рядок y цілі
+static inline uint32_t* RenderTarget_Row(const RenderTarget* target, int y)
+{
+    return (uint32_t*)((uint8_t*)target->pixels + (intptr_t)y * target->stride);
+}
+
+// Запис одного пікселя з перевіркою меж
+static inline void RenderTarget_PutPixel(RenderTarget* target, int x, int y, uint32_t color)
+{
+    if ((unsigned)x >= (unsigned)target->width || (unsigned)y >= (unsigned)target->height) return;
+    RenderTarget_Row(target, y)[x] = 0xFF000000u | color;
+    RenderTarget_MarkDirty(target, x, y, x + 1, y + 1);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RENDER_TARGET_H
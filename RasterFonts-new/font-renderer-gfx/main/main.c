@@ -16,6 +16,9 @@ int main(void) {
     Display_Set_HEIGHT(screenHeight);
     gfx_color(128,127,255);
 
+    // Кадр малюється в бекбуфер (MIT-SHM) і виводиться у вікно в gfx_flush
+    gfx_enable_backbuffer();
+
     DrawRectangle(0, 0, screenWidth, screenHeight, WHITE);
     DrawRectangle(0, 0, osc_width, osc_height, BLACK);
 
@@ -42,6 +45,7 @@ int main(void) {
     }
 
     // Після виходу з циклу звільняємо пам'ять шрифту
+    gfx_disable_backbuffer();
 
     return 0;
 }
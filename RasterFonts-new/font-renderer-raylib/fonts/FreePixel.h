@@ -11,6 +11,10 @@ extern const int FreePixel_glyph_bytes;
 extern const GlyphPointerMap FreePixel_glyph_ptr_map[];
 extern const int FreePixel_glyph_ptr_map_count;
 
+extern const int16_t FreePixel_glyph_ascii_lookup[];
+extern const uint16_t FreePixel_glyph_sorted_lookup[];
+extern const int FreePixel_glyph_sorted_lookup_count;
+
 extern const int FreePixel_glyph_widths[];
 extern const int FreePixel_glyph_heights[];
 extern const int FreePixel_glyph_vertical_offsets[];
@@ -12,6 +12,10 @@ extern const int Terminus28x14_glyph_bytes;
 extern const GlyphPointerMap Terminus28x14_glyph_ptr_map[];
 extern const int Terminus28x14_glyph_ptr_map_count;
 
+extern const int16_t Terminus28x14_glyph_ascii_lookup[];
+extern const uint16_t Terminus28x14_glyph_sorted_lookup[];
+extern const int Terminus28x14_glyph_sorted_lookup_count;
+
 extern const int Terminus28x14_glyph_widths[];
 extern const int Terminus28x14_glyph_heights[];
 extern const int Terminus28x14_glyph_vertical_offsets[];
@@ -19,4 +23,4 @@ extern const int Terminus28x14_glyph_horizontal_offsets[];
 
 extern const RasterFont Terminus28x14_font;
 
-#endif // NS}_H
+#endif // Terminus28x14_H
@@ -12,6 +12,10 @@ extern const int TerminusBold22x11_glyph_bytes;
 extern const GlyphPointerMap TerminusBold22x11_glyph_ptr_map[];
 extern const int TerminusBold22x11_glyph_ptr_map_count;
 
+extern const int16_t TerminusBold22x11_glyph_ascii_lookup[];
+extern const uint16_t TerminusBold22x11_glyph_sorted_lookup[];
+extern const int TerminusBold22x11_glyph_sorted_lookup_count;
+
 extern const int TerminusBold22x11_glyph_widths[];
 extern const int TerminusBold22x11_glyph_heights[];
 extern const int TerminusBold22x11_glyph_vertical_offsets[];
@@ -19,4 +23,4 @@ extern const int TerminusBold22x11_glyph_horizontal_offsets[];
 
 extern const RasterFont TerminusBold22x11_font;
 
-#endif // VTp_H
+#endif // TerminusBold22x11_H
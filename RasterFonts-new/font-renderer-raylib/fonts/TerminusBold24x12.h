@@ -12,6 +12,10 @@ extern const int TerminusBold24x12_glyph_bytes;
 extern const GlyphPointerMap TerminusBold24x12_glyph_ptr_map[];
 extern const int TerminusBold24x12_glyph_ptr_map_count;
 
+extern const int16_t TerminusBold24x12_glyph_ascii_lookup[];
+extern const uint16_t TerminusBold24x12_glyph_sorted_lookup[];
+extern const int TerminusBold24x12_glyph_sorted_lookup_count;
+
 extern const int TerminusBold24x12_glyph_widths[];
 extern const int TerminusBold24x12_glyph_heights[];
 extern const int TerminusBold24x12_glyph_vertical_offsets[];
@@ -19,4 +23,4 @@ extern const int TerminusBold24x12_glyph_horizontal_offsets[];
 
 extern const RasterFont TerminusBold24x12_font;
 
-#endif // 7t}_H
+#endif // TerminusBold24x12_H
@@ -12,6 +12,10 @@ extern const int TerminusBold32x16_glyph_bytes;
 extern const GlyphPointerMap TerminusBold32x16_glyph_ptr_map[];
 extern const int TerminusBold32x16_glyph_ptr_map_count;
 
+extern const int16_t TerminusBold32x16_glyph_ascii_lookup[];
+extern const uint16_t TerminusBold32x16_glyph_sorted_lookup[];
+extern const int TerminusBold32x16_glyph_sorted_lookup_count;
+
 extern const int TerminusBold32x16_glyph_widths[];
 extern const int TerminusBold32x16_glyph_heights[];
 extern const int TerminusBold32x16_glyph_vertical_offsets[];
@@ -19,4 +23,4 @@ extern const int TerminusBold32x16_glyph_horizontal_offsets[];
 
 extern const RasterFont TerminusBold32x16_font;
 
-#endif // Qs_H
+#endif // TerminusBold32x16_H
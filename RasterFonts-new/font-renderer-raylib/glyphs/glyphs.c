@@ -1,59 +1,72 @@
 // glyphs.c
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "glyphs.h"    // структури RasterFont та glyph_map
+#include "text_cache.h"
 #include "raylib.h"    // DrawPixel, DrawRectangle, тощо
 
-/*
- * utf8_strlen - підрахунок кількості Unicode символів у UTF-8 рядку.
- * Стандартна strlen рахує байти, а не символи, що може спотворювати довжину тексту,
- * особливо для кирилиці та інших багатобайтових символів.
- */
-int utf8_strlen(const char* s) {
-    int len = 0;
-    // Проходимо по рядку, декодуючи кожен UTF-8 символ
-    while (*s) {
-        uint32_t codepoint = 0;
-        int bytes = utf8_decode(s, &codepoint); // розпаковуємо один символ
-        s += bytes; // переходимо до наступного символу
-        len++; // лічильник символів
+// Заповнення набору прямокутників одним кольором.
+// raylib сам збирає прямокутники в один пакет вершин, тож кожна серія
+// коштує один квад замість scale*scale окремих DrawPixel.
+void DrawSpans(const PixelSpan* spans, int count, Color color)
+{
+    for (int i = 0; i < count; ++i) {
+        if (spans[i].width <= 0 || spans[i].height <= 0) continue;
+        DrawRectangle(spans[i].x, spans[i].y, spans[i].width, spans[i].height, color);
     }
-    return len;
 }
 
-/*
- * utf8_decode - декодування одного UTF-8 символу з початку рядка str.
- * Записує decodед Unicode код символу у out_codepoint.
- * Повертає довжину символу у байтах (1-4).
- * Якщо символ некоректний, повертає 1 і код 0.
- */
-int utf8_decode(const char* str, uint32_t* out_codepoint) {
-    unsigned char c = (unsigned char)str[0];
-    if (c < 0x80) {
-        // Однобайтовий ASCII символ
-        *out_codepoint = c;
-        return 1;
-    } else if ((c & 0xE0) == 0xC0) {
-        // Дво-байтовий UTF-8 символ
-        *out_codepoint = ((str[0] & 0x1F) << 6) | (str[1] & 0x3F);
-        return 2;
-    } else if ((c & 0xF0) == 0xE0) {
-        // Трибайтовий UTF-8 символ
-        *out_codepoint = ((str[0] & 0x0F) << 12) | ((str[1] & 0x3F) << 6) | (str[2] & 0x3F);
-        return 3;
-    } else if ((c & 0xF8) == 0xF0) {
-        // Чотири байтовий UTF-8 символ
-        *out_codepoint = ((str[0] & 0x07) << 18) | ((str[1] & 0x3F) << 12) |
-        ((str[2] & 0x3F) << 6) | (str[3] & 0x3F);
-        return 4;
+// Кількість відрізків, що накопичуються перед передачею в DrawSpans
+#define BITMAP_SPAN_BATCH 256
+
+// Малювання монохромного бітмапа горизонтальними відрізками.
+// Рядок бітмапа займає (width + 7) / 8 байтів, старший біт байта - лівий піксель.
+// Нульові байти пропускаються цілком, кожна серія одиниць дає один прямокутник
+// (довжина серії * scale) x scale.
+void DrawBitmapSpans(const uint8_t* bitmap, int width, int height,
+                     int x, int y, int scale, Color color)
+{
+    if (!bitmap || width <= 0 || height <= 0 || scale < 1) return;
+
+    PixelSpan spans[BITMAP_SPAN_BATCH];
+    int count = 0;
+    int bytes_per_row = (width + 7) / 8;
+
+    for (int row = 0; row < height; ++row) {
+        const uint8_t* line = bitmap + row * bytes_per_row;
+        int px = 0;
+        while (px < width) {
+            uint8_t byte_val = line[px >> 3];
+            if (byte_val == 0 && (px & 7) == 0) { // порожній байт - 8 пікселів фону
+                px += 8;
+                continue;
+            }
+            if (!(byte_val & (0x80 >> (px & 7)))) {
+                px++;
+                continue;
+            }
+
+            // Шукаємо кінець серії встановлених бітів
+            int start = px;
+            while (px < width && (line[px >> 3] & (0x80 >> (px & 7)))) px++;
+
+            if (count == BITMAP_SPAN_BATCH) {
+                DrawSpans(spans, count, color);
+                count = 0;
+            }
+            spans[count].x = x + start * scale;
+            spans[count].y = y + row * scale;
+            spans[count].width = (px - start) * scale;
+            spans[count].height = scale;
+            count++;
+        }
     }
-    // Некоректний символ
-    *out_codepoint = 0;
-    return 1;
-}
 
+    if (count > 0) DrawSpans(spans, count, color);
+}
 
 // Малюємо один гліф з урахуванням зсувів і масштабу
 // glyph - масив байтів гліфа (монохромний)
@@ -63,36 +76,40 @@ int utf8_decode(const char* str, uint32_t* out_codepoint) {
 // scale - масштаб (розмір пікселя)
 // vert_offset, horiz_offset - вертикальний і горизонтальний зсуви гліфа (пікселі)
 // color - колір пікселя
+// Кожен рядок гліфа розбивається на серії встановлених бітів, і кожна серія
+// малюється одним прямокутником (див. DrawBitmapSpans) замість scale*scale пікселів.
 void DrawGlyphWithOffsets(const uint8_t* glyph, int width, int height, int bytes_per_glyph,
                           int x, int y, int scale, int vert_offset, int horiz_offset, Color color)
 {
-    int bytes_per_row = (width + 7) / 8;
+    (void)bytes_per_glyph;
     int draw_y = y + vert_offset * scale;
     int draw_x_base = x + horiz_offset * scale;
 
-    for (int row = 0; row < height; ++row) {
-        for (int byte = 0; byte < bytes_per_row; ++byte) {
-            uint8_t byte_val = glyph[row * bytes_per_row + byte];
-            for (int bit = 0; bit < 8; ++bit) {
-                int px = byte * 8 + bit;
-                if (px >= width) break;
-                if (byte_val & (0x80 >> bit)) {
-                    int draw_x = draw_x_base + px * scale;
-                    int draw_y_pixel = draw_y + row * scale;
-                    for (int dx = 0; dx < scale; ++dx) {
-                        for (int dy = 0; dy < scale; ++dy) {
-                            DrawPixel(draw_x + dx, draw_y_pixel + dy, color);
-        }
-    }
+    DrawBitmapSpans(glyph, width, height, draw_x_base, draw_y, scale, color);
 }
-                        }
-                    }
-                }
-            }
 
 // Пошук гліфа за Unicode кодом із вашого шрифту
 const GlyphPointerMap* FindGlyph(const RasterFont font, uint32_t unicode)
 {
+    if (font.glyph_ascii_lookup && font.glyph_sorted_lookup) {
+        // ASCII - пряма таблиця
+        if (unicode < 128) {
+            int index = font.glyph_ascii_lookup[unicode];
+            return (index >= 0) ? &font.glyph_map[index] : NULL;
+        }
+        // Решта - бінарний пошук по відсортованих індексах
+        int lo = 0, hi = font.glyph_sorted_count - 1;
+        while (lo <= hi) {
+            int mid = (lo + hi) / 2;
+            const GlyphPointerMap* entry = &font.glyph_map[font.glyph_sorted_lookup[mid]];
+            if (entry->unicode == unicode) return entry;
+            if (entry->unicode < unicode) lo = mid + 1;
+            else hi = mid - 1;
+        }
+        return NULL;
+    }
+
+    // Шрифт без таблиць пошуку - лінійний пошук
     for (int i = 0; i < font.glyph_count; ++i) {
         if (font.glyph_map[i].unicode == unicode) {
             return &font.glyph_map[i];
@@ -101,6 +118,170 @@ const GlyphPointerMap* FindGlyph(const RasterFont font, uint32_t unicode)
     return NULL;
 }
 
+// Таблиця ширин гліфів шрифту для вимірювання тексту. Будується один раз при першому
+// вимірюванні: коди до U+FFFF - сторінки по 256 кодів (як у таблиці Unicode PSF),
+// старші коди - через FindGlyph
+typedef struct {
+    const GlyphPointerMap* glyph_map; // Ключ: масив гліфів шрифту
+    int16_t* pages[256];              // Ширини для кодів сторінки, NULL - у сторінці немає гліфів
+    int16_t fallback;                 // Ширина для коду без гліфа (ширина пробілу, -1 - немає)
+} RasterFontAdvances;
+
+// Таблиці всіх шрифтів, які вже вимірювались (шрифти - статичні дані, тож таблиці не звільняються)
+static RasterFontAdvances** advance_tables = NULL;
+static int advance_table_count = 0;
+
+// Ширина коду без таблиці: гліф, пробіл замість відсутнього гліфа, або -1
+static int FindGlyphAdvance(const RasterFont font, uint32_t codepoint)
+{
+    const GlyphPointerMap* glyph = FindGlyph(font, codepoint);
+    if (!glyph) glyph = FindGlyph(font, 32);
+    return glyph ? font.glyph_widths[glyph - font.glyph_map] : -1;
+}
+
+// Звільняє таблицю ширин (лише при невдалій побудові)
+static void FreeRasterFontAdvances(RasterFontAdvances* adv)
+{
+    for (int p = 0; p < 256; ++p) free(adv->pages[p]);
+    free(adv);
+}
+
+// Таблиця ширин шрифту (створюється при першому зверненні), NULL - не вдалося виділити пам’ять
+static const RasterFontAdvances* GetRasterFontAdvances(const RasterFont font)
+{
+    for (int i = 0; i < advance_table_count; ++i) {
+        if (advance_tables[i]->glyph_map == font.glyph_map) return advance_tables[i];
+    }
+
+    RasterFontAdvances** tables = realloc(advance_tables, (advance_table_count + 1) * sizeof(*tables));
+    if (!tables) return NULL;
+    advance_tables = tables;
+
+    RasterFontAdvances* adv = calloc(1, sizeof(RasterFontAdvances));
+    if (!adv) return NULL;
+    adv->glyph_map = font.glyph_map;
+    adv->fallback = (int16_t)FindGlyphAdvance(font, 32);
+
+    for (int i = 0; i < font.glyph_count; ++i) {
+        uint32_t unicode = font.glyph_map[i].unicode;
+        if (unicode > 0xFFFF) continue;
+
+        int16_t** page = &adv->pages[unicode >> 8];
+        if (!*page) {
+            *page = malloc(256 * sizeof(int16_t));
+            if (!*page) {
+                FreeRasterFontAdvances(adv);
+                return NULL;
+            }
+            for (int c = 0; c < 256; ++c) (*page)[c] = adv->fallback;
+        }
+        // Повторні коди - так само, як їх знайде FindGlyph при малюванні
+        (*page)[unicode & 0xFF] = (int16_t)FindGlyphAdvance(font, unicode);
+    }
+
+    advance_tables[advance_table_count++] = adv;
+    return adv;
+}
+
+// Ширина коду з таблиці (або через FindGlyph, якщо таблиці немає), -1 - код не малюється
+static inline int LookupAdvance(const RasterFontAdvances* adv, const RasterFont font, uint32_t codepoint)
+{
+    if (adv && codepoint <= 0xFFFF) {
+        const int16_t* page = adv->pages[codepoint >> 8];
+        return page ? page[codepoint & 0xFF] : adv->fallback;
+    }
+    return FindGlyphAdvance(font, codepoint);
+}
+
+int GetRasterGlyphAdvance(const RasterFont font, uint32_t codepoint)
+{
+    return LookupAdvance(GetRasterFontAdvances(font), font, codepoint);
+}
+
+// Один прохід по тексту: межі і ширина кожного рядка (у lines та/або lineWidths,
+// не більше maxLines) і найбільша ширина (у maxWidth). Повертає кількість рядків
+static int MeasureRasterLines(const RasterFont font, const char* text, int spacing, int scale,
+                              TextLine* lines, int* lineWidths, int maxLines, int* maxWidth)
+{
+    *maxWidth = 0;
+    if (!text || !*text) return 0;
+
+    const RasterFontAdvances* adv = GetRasterFontAdvances(font);
+    const char* base = text;
+    const char* lineStart = text;
+    const char* end = text + strlen(text);
+    const char* ascii = text;
+    int lineCount = 0;
+    int lineWidth = 0;
+
+    for (;;) {
+        if (*text == '\n' || *text == '\0') {
+            if (lineWidth > 0) lineWidth -= spacing; // прибираємо зайвий інтервал у кінці
+            if (lineCount < maxLines) {
+                if (lines) {
+                    lines[lineCount].start = (int)(lineStart - base);
+                    lines[lineCount].length = (int)(text - lineStart);
+                    lines[lineCount].width = lineWidth;
+                }
+                if (lineWidths) lineWidths[lineCount] = lineWidth;
+            }
+            if (lineWidth > *maxWidth) *maxWidth = lineWidth;
+            lineCount++;
+            lineWidth = 0;
+            if (*text == '\0') break;
+            text++;
+            lineStart = text;
+            continue;
+        }
+
+        uint32_t codepoint = 0;
+        int bytes = utf8_next(text, end, &ascii, &codepoint);
+        int advance = LookupAdvance(adv, font, codepoint);
+        if (advance >= 0) lineWidth += advance * scale + spacing;
+        text += bytes;
+    }
+    return lineCount;
+}
+
+/*
+ * MeasureRasterTextLines - ширина кожного рядка тексту в пікселях так, як його
+ * малює DrawTextScaled: сума (ширина гліфа * scale + spacing) без останнього spacing.
+ * Рядки розділяються '\n'; у lineWidths записується не більше maxLines значень.
+ * Повертає кількість рядків (0 для порожнього тексту).
+ */
+int MeasureRasterTextLines(const RasterFont font, const char* text, int spacing, int scale,
+                           int* lineWidths, int maxLines)
+{
+    int maxWidth;
+    return MeasureRasterLines(font, text, spacing, scale, NULL, lineWidths, maxLines, &maxWidth);
+}
+
+/*
+ * MeasureRasterText - розмір тексту в пікселях: ширина найширшого рядка,
+ * висота всіх рядків (з інтервалом spacing між рядками) і кількість рядків.
+ */
+TextMetrics MeasureRasterText(const RasterFont font, const char* text, int spacing, int scale)
+{
+    TextMetrics metrics = { 0, 0, 0 };
+    metrics.lineCount = MeasureRasterLines(font, text, spacing, scale, NULL, NULL, 0, &metrics.width);
+    if (metrics.lineCount > 0)
+        metrics.height = metrics.lineCount * font.glyph_height * scale + (metrics.lineCount - 1) * spacing;
+    return metrics;
+}
+
+/*
+ * LayoutRasterTextLines - розкладка тексту на рядки за один прохід: для кожного рядка
+ * зсув і довжина в байтах (без '\n') та ширина в пікселях. Текст не копіюється,
+ * порожні рядки зберігаються. У lines записується не більше maxLines рядків;
+ * повертає повну кількість рядків, тож при нестачі місця буфер можна збільшити.
+ */
+int LayoutRasterTextLines(const RasterFont font, const char* text, int spacing, int scale,
+                          TextLine* lines, int maxLines)
+{
+    int maxWidth;
+    return MeasureRasterLines(font, text, spacing, scale, lines, NULL, maxLines, &maxWidth);
+}
+
 // Малювання символу з урахуванням індивідуальних розмірів і зсувів
 void DrawChar(const RasterFont font, int x, int y, uint32_t codepoint,
               Color color, int scale)
@@ -123,6 +304,11 @@ void DrawChar(const RasterFont font, int x, int y, uint32_t codepoint,
 void DrawTextScaled(const RasterFont font, int x, int y, const char* text,
                     int spacing, int scale, Color color)
 {
+    // Повторюваний рядок малюється однією текстурою з кешу (якщо кеш увімкнено)
+    if (TextCache_DrawText(font, x, y, text, spacing, scale, color)) return;
+
+    const char* end = text + strlen(text);
+    const char* ascii = text;
     int xpos = x;
     int ypos = y;
     while (*text) {
@@ -133,7 +319,7 @@ void DrawTextScaled(const RasterFont font, int x, int y, const char* text,
             continue;
         }
         uint32_t codepoint = 0;
-        int bytes = utf8_decode(text, &codepoint);
+        int bytes = utf8_next(text, end, &ascii, &codepoint);
 
         const GlyphPointerMap* glyph = FindGlyph(font, codepoint);
         if (!glyph) glyph = FindGlyph(font, 32); // заміна на пробіл, якщо не знайдено
@@ -154,12 +340,118 @@ void DrawTextScaled(const RasterFont font, int x, int y, const char* text,
     }
 }
 
+// Малювання одного рядка тексту довжиною length байтів (без '\n'), наприклад
+// рядка з розкладки LayoutRasterTextLines - без копіювання і завершального нуля
+void DrawTextLineScaled(const RasterFont font, int x, int y, const char* text, int length,
+                        int spacing, int scale, Color color)
+{
+    const char* end = text + length;
+    const char* ascii = text;
+    int xpos = x;
+    while (text < end) {
+        uint32_t codepoint = 0;
+        int bytes = utf8_next(text, end, &ascii, &codepoint);
+
+        const GlyphPointerMap* glyph = FindGlyph(font, codepoint);
+        if (!glyph) glyph = FindGlyph(font, 32); // заміна на пробіл, якщо не знайдено
+
+        if (glyph) {
+            int glyph_index = (int)(glyph - font.glyph_map);
+            int w = font.glyph_widths[glyph_index];
+            int h = font.glyph_heights[glyph_index];
+            int vo = font.glyph_vertical_offsets[glyph_index];
+
+            DrawGlyphWithOffsets(glyph->glyph, w, h, font.glyph_bytes,
+                                 xpos, y, scale, vo, 0, color);
+
+            xpos += (w * scale) + spacing;
+        }
+        text += bytes;
+    }
+}
+
+// Чи є в бітмапі гліфа хоч один встановлений піксель
+static int GlyphHasPixels(const uint8_t* glyph, int bytes)
+{
+    for (int i = 0; i < bytes; i++) {
+        if (glyph[i]) return 1;
+    }
+    return 0;
+}
+
+/*
+ * CreateGlyphRun - розбирає текст один раз: декодує UTF-8, шукає гліфи (відсутні
+ * замінюються пробілом) і рахує позиції так само, як DrawTextScaled.
+ * Порожні гліфи (пробіли) лише зсувають позицію і в GlyphRun не потрапляють.
+ * Якщо пам’яті не вистачило, повертається порожній GlyphRun (count = 0).
+ */
+GlyphRun CreateGlyphRun(const RasterFont font, const char* text, int spacing, int scale)
+{
+    GlyphRun run = { 0 };
+    run.scale = scale;
+    run.metrics = MeasureRasterText(font, text, spacing, scale);
+
+    int maxGlyphs = utf8_strlen(text);
+    if (maxGlyphs <= 0) return run;
+    run.glyphs = malloc(maxGlyphs * sizeof(GlyphRunGlyph));
+    if (!run.glyphs) return run;
+
+    const char* end = text + strlen(text);
+    const char* ascii = text;
+    int xpos = 0;
+    int ypos = 0;
+    while (*text) {
+        if (*text == '\n') {
+            xpos = 0;
+            ypos += font.glyph_height * scale + spacing;
+            text++;
+            continue;
+        }
+        uint32_t codepoint = 0;
+        int bytes = utf8_next(text, end, &ascii, &codepoint);
+
+        const GlyphPointerMap* glyph = FindGlyph(font, codepoint);
+        if (!glyph) glyph = FindGlyph(font, 32); // заміна на пробіл, якщо не знайдено
+
+        if (glyph) {
+            int glyph_index = (int)(glyph - font.glyph_map);
+            int w = font.glyph_widths[glyph_index];
+
+            if (GlyphHasPixels(glyph->glyph, font.glyph_bytes)) {
+                GlyphRunGlyph* placed = &run.glyphs[run.count++];
+                placed->bitmap = glyph->glyph;
+                placed->width = w;
+                placed->height = font.glyph_heights[glyph_index];
+                placed->x = xpos;
+                placed->y = ypos + font.glyph_vertical_offsets[glyph_index] * scale;
+            }
+            xpos += (w * scale) + spacing;
+        }
+        text += bytes;
+    }
+    return run;
+}
+
+void UnloadGlyphRun(GlyphRun run)
+{
+    free(run.glyphs);
+}
+
+void DrawGlyphRun(const GlyphRun* run, int x, int y, Color color)
+{
+    for (int i = 0; i < run->count; i++) {
+        const GlyphRunGlyph* glyph = &run->glyphs[i];
+        DrawBitmapSpans(glyph->bitmap, glyph->width, glyph->height,
+                        x + glyph->x, y + glyph->y, run->scale, color);
+    }
+}
+
 /*
  * DrawTextWithBackground - малює текст із фоновим прямокутником та рамкою.
  * Параметри:
  * - font: шрифт для малювання
  * - x, y: позиція початку тексту
- * - text: текст для малювання (підтримує \n)
+ * - text: текст для малювання (підтримує \n, довжина і кількість рядків не обмежені)
  * - spacing: відступ між символами
  * - scale: масштаб символів
  * - textColor, bgColor, borderColor: кольори тексту, фону і рамки
@@ -171,62 +463,25 @@ void DrawTextWithBackground(const RasterFont font, int x, int y, const char* tex
                             Color bgColor, Color borderColor,
                             int padding, int borderThickness)
 {
-    // Розбиваємо текст на рядки для посторочного малювання
-    const char* lines[20];
-    int lineCount = 0;
-    char tempText[512];
-    strncpy(tempText, text, sizeof(tempText) - 1);
-    tempText[sizeof(tempText) - 1] = '\0';
-
-    char* line = strtok(tempText, "\n");
-    while (line != NULL && lineCount < 20) {
-        lines[lineCount++] = line;
-        line = strtok(NULL, "\n");
-    }
+    // Розмір тексту одним проходом: ширина найширшого рядка і висота всіх рядків
+    TextMetrics metrics = MeasureRasterText(font, text, spacing, scale);
 
-    // Обчислюємо максимальну ширину рядка в пікселях з урахуванням ширини кожного гліфа
-    int maxLineWidth = 0;
-    for (int i = 0; i < lineCount; i++) {
-        int lineWidth = 0;
-        const char* ptr = lines[i];
-        while (*ptr) {
-            uint32_t cp = 0;
-            int bytes = utf8_decode(ptr, &cp);
-            const GlyphPointerMap* glyph = FindGlyph(font, cp);
-            if (!glyph) glyph = FindGlyph(font, 32); // пропуск, якщо не знайдений
-
-            if (glyph) {
-                int glyph_index = glyph - font.glyph_map;
-                int gw = font.glyph_widths[glyph_index];
-                lineWidth += (gw * scale) + spacing;
-            }
-            ptr += bytes;
-        }
-        if (lineWidth > 0) lineWidth -= spacing; // прибираємо зайвий інтервал у кінці
-        if (lineWidth > maxLineWidth) maxLineWidth = lineWidth;
-    }
-
-    // Обчислюємо висоту фону із урахуванням рядків, масштабу, паддінгу, отступів і товщини рамки
-    int lineHeight = font.glyph_height * scale;
-    int totalHeight = (lineHeight * lineCount) + (spacing * (lineCount - 1));
-    int bgWidth = maxLineWidth + 2 * padding + 2 * borderThickness;
-    int bgHeight = totalHeight + 2 * padding + 2 * borderThickness;
+    // Обчислюємо розмір фону із урахуванням паддінгу і товщини рамки
+    int bgWidth = metrics.width + 2 * padding + 2 * borderThickness;
+    int bgHeight = metrics.height + 2 * padding + 2 * borderThickness;
 
     // Малюємо залитий фон
     DrawRectangle(x - padding - borderThickness, y - padding - borderThickness, bgWidth, bgHeight, bgColor);
 
     // Малюємо рамку товщиною borderThickness
-    for(int i = 0; i < borderThickness; i++) {
+    for (int i = 0; i < borderThickness; i++) {
         DrawRectangleLines(x - padding - borderThickness + i, y - padding - borderThickness + i,
-                           bgWidth - 2*i, bgHeight - 2*i, borderColor);
+                           bgWidth - 2 * i, bgHeight - 2 * i, borderColor);
     }
 
-    // Малюємо текст поверх фону і рамки по рядках
-    int ypos = y;
-    for (int i = 0; i < lineCount; i++) {
-        DrawTextScaled(font, x, ypos, lines[i], spacing, scale, textColor);
-        ypos += lineHeight + spacing;
-    }
+    // Малюємо текст поверх фону і рамки (через DrawTextScaled, щоб постійні підписи
+    // бралися з кешу рядків)
+    DrawTextScaled(font, x, y, text, spacing, scale, textColor);
 }
 
 /*
@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include "glyphmap.h"
+#include "utf8.h"
 #include "color_utils.h"
 
 // Структура для опису шрифту повністю
@@ -17,25 +18,101 @@ typedef struct {
     const int* glyph_heights;           // масив фактичних висот кожного гліфа
     const int* glyph_vertical_offsets; // масив вертикальних зсувів для вирівнювання по baseline
     const int* glyph_horizontal_offsets; // масив горизонтальних зсувів гліфів
+    const int16_t* glyph_ascii_lookup;  // ASCII -> індекс у glyph_map (-1 - немає), або NULL
+    const uint16_t* glyph_sorted_lookup; // індекси glyph_map для кодів >= 128, відсортовані за Unicode
+    int glyph_sorted_count;             // кількість записів у glyph_sorted_lookup
 } RasterFont;
 
-// Оголошення функцій
-int utf8_strlen(const char* s);
-int utf8_decode(const char* str, uint32_t* out_codepoint);
+// Розмір тексту в пікселях
+typedef struct {
+    int width;      // ширина найширшого рядка
+    int height;     // висота всіх рядків разом з інтервалами між ними
+    int lineCount;  // кількість рядків
+} TextMetrics;
+
+// Рядок розкладеного тексту (LayoutRasterTextLines)
+typedef struct {
+    int start;      // зсув першого байта рядка в тексті
+    int length;     // довжина рядка в байтах (без '\n')
+    int width;      // ширина рядка в пікселях
+} TextLine;
+
+// Прямокутник пікселів (зазвичай одна горизонтальна серія) для пакетного заповнення
+typedef struct {
+    int x, y;
+    int width, height;
+} PixelSpan;
 
+// Гліф заздалегідь розібраного тексту (GlyphRun)
+typedef struct {
+    const uint8_t* bitmap;  // бітмап гліфа
+    int width;              // ширина гліфа в пікселях шрифту
+    int height;             // висота гліфа в пікселях шрифту
+    int x;                  // зсув від початку тексту по x (з масштабом)
+    int y;                  // зсув по y: рядок і вертикальний зсув гліфа (з масштабом)
+} GlyphRunGlyph;
+
+// Текст, розібраний один раз (CreateGlyphRun): UTF-8 декодовано, гліфи знайдено,
+// позиції пораховано. Для незмінних підписів, які малюються кожен кадр
+typedef struct {
+    GlyphRunGlyph* glyphs;  // гліфи для малювання (порожні гліфи, як пробіл, пропущено)
+    int count;              // кількість гліфів
+    int scale;              // масштаб
+    TextMetrics metrics;    // розмір тексту, як у MeasureRasterText
+} GlyphRun;
+
+// Оголошення функцій
 const GlyphPointerMap* FindGlyph(const RasterFont font, uint32_t unicode);
 
+void DrawSpans(const PixelSpan* spans, int count, Color color);
+
+void DrawBitmapSpans(const uint8_t* bitmap, int width, int height,
+                     int x, int y, int scale, Color color);
+
+// Ширина гліфа коду codepoint без масштабу (для відсутнього гліфа - ширина пробілу),
+// -1 - такий код не малюється. Береться з таблиці ширин, що будується раз на шрифт
+int GetRasterGlyphAdvance(const RasterFont font, uint32_t codepoint);
+
+// Розмір тексту (з '\n') так, як його малює DrawTextScaled
+TextMetrics MeasureRasterText(const RasterFont font, const char* text, int spacing, int scale);
+
+// Ширини окремих рядків тексту (не більше maxLines у lineWidths), повертає кількість рядків
+int MeasureRasterTextLines(const RasterFont font, const char* text, int spacing, int scale,
+                           int* lineWidths, int maxLines);
+
+// Розкладка тексту на рядки за один прохід (не більше maxLines у lines),
+// повертає повну кількість рядків
+int LayoutRasterTextLines(const RasterFont font, const char* text, int spacing, int scale,
+                          TextLine* lines, int maxLines);
+
 void DrawGlyph(const uint8_t* glyph, int charsize, int width, int height,
                int x, int y, Color color);
 
 void DrawGlyphScaled(const uint8_t* glyph, int width, int height, int bytes_per_glyph,
                      int x, int y, int scale, Color color);
 
+// Малювання гліфа з вертикальним і горизонтальним зсувом (у пікселях шрифту)
+void DrawGlyphWithOffsets(const uint8_t* glyph, int width, int height, int bytes_per_glyph,
+                          int x, int y, int scale, int vert_offset, int horiz_offset, Color color);
+
 void DrawChar(const RasterFont font, int x, int y, uint32_t codepoint, Color color, int scale);
 
 void DrawTextScaled(const RasterFont font, int x, int y, const char* text,
                          int spacing, int scale, Color color);
 
+// Малювання рядка довжиною length байтів без '\n' (наприклад, text + TextLine.start)
+void DrawTextLineScaled(const RasterFont font, int x, int y, const char* text, int length,
+                        int spacing, int scale, Color color);
+
+// Розбір тексту в GlyphRun (з '\n'); малюється так само, як DrawTextScaled
+GlyphRun CreateGlyphRun(const RasterFont font, const char* text, int spacing, int scale);
+
+// Звільнення пам’яті GlyphRun
+void UnloadGlyphRun(GlyphRun run);
+
+// Малювання GlyphRun з лівим верхнім кутом у (x, y) без декодування і пошуку гліфів
+void DrawGlyphRun(const GlyphRun* run, int x, int y, Color color);
+
 void DrawTextWithBackground(const RasterFont font, int x, int y, const char* text,
                             int spacing, int scale, Color textColor,
                             Color bgColor, Color borderColor,
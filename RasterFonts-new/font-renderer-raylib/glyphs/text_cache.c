@@ -0,0 +1,307 @@
+// text_cache.c
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "text_cache.h"
+#include "raylib.h"    // текстури
+#include "rlgl.h"      // rlDrawRenderBatchActive
+
+// Початкова кількість кошиків хеш-таблиці (степінь двійки)
+#define TEXT_CACHE_INITIAL_BUCKETS 64
+
+// Рядок у кеші
+typedef struct TextCacheEntry {
+    const GlyphPointerMap* font;    // шрифт (таблиця гліфів визначає його однозначно)
+    int spacing;
+    int scale;
+    uint64_t hash;
+    char* text;                     // копія рядка для перевірки збігу
+    size_t length;
+    int rasterized;                 // 0 - рядок зустрівся лише раз і текстури ще немає
+    int has_texture;                // 0 - у рядку немає пікселів
+    int upload_failed;              // LoadTextureFromImage не вдався: рядок малюється по гліфах,
+                                    // доки запис не витісниться (у LRU він не оновлюється)
+    Texture2D texture;              // рядок білим по прозорому, колір задається при малюванні
+    int offset_x, offset_y;         // зсув текстури від точки малювання
+    size_t bytes;                   // пам’ять запису
+    struct TextCacheEntry* bucket_next;
+    struct TextCacheEntry* newer;   // список LRU: від найновішого до найдавнішого
+    struct TextCacheEntry* older;
+} TextCacheEntry;
+
+static TextCacheEntry** g_buckets = NULL;
+static int g_bucket_count = 0;
+static TextCacheEntry* g_newest = NULL;
+static TextCacheEntry* g_oldest = NULL;
+static size_t g_budget = 0;
+static TextCacheStats g_stats = { 0 };
+
+// FNV-1a по байтах рядка з домішаними шрифтом, масштабом і відступом
+static uint64_t TextCache_Hash(const GlyphPointerMap* font, int spacing, int scale,
+                               const char* text, size_t length)
+{
+    uint64_t hash = 1469598103934665603ULL;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)text[i];
+        hash *= 1099511628211ULL;
+    }
+    hash ^= (uint64_t)(uintptr_t)font;
+    hash *= 1099511628211ULL;
+    hash ^= ((uint64_t)(uint32_t)scale << 32) | (uint32_t)spacing;
+    hash *= 1099511628211ULL;
+    return hash;
+}
+
+static TextCacheEntry** TextCache_Bucket(uint64_t hash)
+{
+    return &g_buckets[(hash ^ (hash >> 32)) & (uint64_t)(g_bucket_count - 1)];
+}
+
+static TextCacheEntry* TextCache_Find(const GlyphPointerMap* font, int spacing, int scale,
+                                      const char* text, size_t length, uint64_t hash)
+{
+    if (!g_buckets) return NULL;
+    for (TextCacheEntry* e = *TextCache_Bucket(hash); e; e = e->bucket_next) {
+        if (e->hash == hash && e->font == font && e->spacing == spacing && e->scale == scale &&
+            e->length == length && memcmp(e->text, text, length) == 0)
+            return e;
+    }
+    return NULL;
+}
+
+static void TextCache_LinkNewest(TextCacheEntry* e)
+{
+    e->newer = NULL;
+    e->older = g_newest;
+    if (g_newest) g_newest->newer = e;
+    else g_oldest = e;
+    g_newest = e;
+}
+
+static void TextCache_UnlinkLRU(TextCacheEntry* e)
+{
+    if (e->newer) e->newer->older = e->older;
+    else g_newest = e->older;
+    if (e->older) e->older->newer = e->newer;
+    else g_oldest = e->newer;
+}
+
+static void TextCache_Remove(TextCacheEntry* e)
+{
+    TextCacheEntry** link = TextCache_Bucket(e->hash);
+    while (*link != e) link = &(*link)->bucket_next;
+    *link = e->bucket_next;
+    TextCache_UnlinkLRU(e);
+
+    g_stats.bytes -= e->bytes;
+    g_stats.entries--;
+    if (e->has_texture) {
+        // Текстура ще може бути в незавершеному пакеті малювання кадру
+        rlDrawRenderBatchActive();
+        UnloadTexture(e->texture);
+    }
+    free(e->text);
+    free(e);
+}
+
+// Подвоєння кількості кошиків, коли записів стає вдвічі більше за кошики
+static void TextCache_Grow(void)
+{
+    int count = g_bucket_count ? g_bucket_count * 2 : TEXT_CACHE_INITIAL_BUCKETS;
+    TextCacheEntry** buckets = calloc(count, sizeof(TextCacheEntry*));
+    if (!buckets) return; // лишаємо старі кошики - пошук просто довший
+
+    TextCacheEntry** old = g_buckets;
+    int oldCount = g_bucket_count;
+    g_buckets = buckets;
+    g_bucket_count = count;
+    for (int i = 0; i < oldCount; i++) {
+        for (TextCacheEntry* e = old[i]; e; ) {
+            TextCacheEntry* next = e->bucket_next;
+            TextCacheEntry** bucket = TextCache_Bucket(e->hash);
+            e->bucket_next = *bucket;
+            *bucket = e;
+            e = next;
+        }
+    }
+    free(old);
+}
+
+// Витіснення найдавніших рядків до ліміту. Рядок keep витісняється останнім;
+// повертає 0, якщо довелося витіснити і його
+static int TextCache_EvictToBudget(TextCacheEntry* keep)
+{
+    while (g_stats.bytes > g_budget && g_oldest) {
+        TextCacheEntry* victim = g_oldest;
+        if (victim == keep) {
+            if (!victim->newer) break;
+            victim = victim->newer;
+        }
+        TextCache_Remove(victim);
+        g_stats.evictions++;
+    }
+    if (keep && g_stats.bytes > g_budget) {
+        TextCache_Remove(keep);
+        g_stats.evictions++;
+        return 0;
+    }
+    return 1;
+}
+
+// Розтеризація рядка в текстуру: ті самі гліфи і позиції, що й у DrawTextScaled
+static int TextCache_Rasterize(TextCacheEntry* e, const RasterFont font, const char* text)
+{
+    GlyphRun run = CreateGlyphRun(font, text, e->spacing, e->scale);
+    // Без масиву гліфів для непорожнього рядка - malloc не вдався, а не рядок без пікселів
+    if (!run.glyphs && text[0] != '\0') return 0;
+    if (run.count == 0) {
+        UnloadGlyphRun(run);
+        e->rasterized = 1;
+        return 1;
+    }
+
+    int scale = e->scale;
+    int x0 = INT_MAX, y0 = INT_MAX, x1 = INT_MIN, y1 = INT_MIN;
+    for (int i = 0; i < run.count; i++) {
+        const GlyphRunGlyph* g = &run.glyphs[i];
+        if (g->x < x0) x0 = g->x;
+        if (g->y < y0) y0 = g->y;
+        if (g->x + g->width * scale > x1) x1 = g->x + g->width * scale;
+        if (g->y + g->height * scale > y1) y1 = g->y + g->height * scale;
+    }
+
+    // Білі пікселі з альфою 0/255: DrawTexture фарбує їх кольором тексту
+    int width = x1 - x0;
+    int height = y1 - y0;
+    uint8_t* pixels = calloc((size_t)width * height, 2);
+    if (!pixels) {
+        UnloadGlyphRun(run);
+        return 0;
+    }
+
+    for (int i = 0; i < run.count; i++) {
+        const GlyphRunGlyph* g = &run.glyphs[i];
+        int glyphStride = (g->width + 7) / 8;
+        for (int row = 0; row < g->height; row++) {
+            const uint8_t* bits = g->bitmap + row * glyphStride;
+            for (int col = 0; col < g->width; col++) {
+                if (!(bits[col >> 3] & (0x80 >> (col & 7)))) continue;
+                int px = g->x - x0 + col * scale;
+                int py = g->y - y0 + row * scale;
+                for (int dy = 0; dy < scale; dy++) {
+                    uint8_t* line = pixels + ((size_t)(py + dy) * width + px) * 2;
+                    memset(line, 0xFF, (size_t)scale * 2);
+                }
+            }
+        }
+    }
+    UnloadGlyphRun(run);
+
+    Image image = {
+        .data = pixels,
+        .width = width,
+        .height = height,
+        .mipmaps = 1,
+        .format = PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA
+    };
+    e->texture = LoadTextureFromImage(image);
+    free(pixels);
+    if (e->texture.id == 0) {
+        e->upload_failed = 1;
+        return 0;
+    }
+
+    e->has_texture = 1;
+    e->offset_x = x0;
+    e->offset_y = y0;
+    e->bytes += (size_t)width * height * 2;
+    g_stats.bytes += (size_t)width * height * 2;
+    e->rasterized = 1;
+    return 1;
+}
+
+int TextCache_DrawText(const RasterFont font, int x, int y, const char* text,
+                       int spacing, int scale, Color color)
+{
+    if (g_budget == 0 || !text || !*text) return 0;
+
+    size_t length = strlen(text);
+    uint64_t hash = TextCache_Hash(font.glyph_map, spacing, scale, text, length);
+    TextCacheEntry* e = TextCache_Find(font.glyph_map, spacing, scale, text, length, hash);
+
+    if (e && e->upload_failed) {
+        g_stats.misses++;
+        return 0;
+    }
+    if (e && e->rasterized) {
+        g_stats.hits++;
+        TextCache_UnlinkLRU(e);
+        TextCache_LinkNewest(e);
+        if (e->has_texture) DrawTexture(e->texture, x + e->offset_x, y + e->offset_y, color);
+        return 1;
+    }
+    g_stats.misses++;
+
+    if (!e) {
+        // Перша зустріч: лише запам’ятовуємо рядок, малюється він по гліфах
+        e = calloc(1, sizeof(TextCacheEntry));
+        char* copy = malloc(length + 1);
+        if (!e || !copy) {
+            free(e);
+            free(copy);
+            return 0;
+        }
+        memcpy(copy, text, length + 1);
+        e->font = font.glyph_map;
+        e->spacing = spacing;
+        e->scale = scale;
+        e->hash = hash;
+        e->text = copy;
+        e->length = length;
+        e->bytes = sizeof(TextCacheEntry) + length + 1;
+
+        if (g_stats.entries >= g_bucket_count * 2) TextCache_Grow();
+        if (!g_buckets) {
+            free(copy);
+            free(e);
+            return 0;
+        }
+        TextCacheEntry** bucket = TextCache_Bucket(hash);
+        e->bucket_next = *bucket;
+        *bucket = e;
+        TextCache_LinkNewest(e);
+        g_stats.entries++;
+        g_stats.bytes += e->bytes;
+        TextCache_EvictToBudget(NULL);
+        return 0;
+    }
+
+    // Друга зустріч: розтеризуємо рядок і далі малюємо його з кешу
+    TextCache_UnlinkLRU(e);
+    TextCache_LinkNewest(e);
+    if (!TextCache_Rasterize(e, font, text) || !TextCache_EvictToBudget(e)) return 0;
+    if (e->has_texture) DrawTexture(e->texture, x + e->offset_x, y + e->offset_y, color);
+    return 1;
+}
+
+void TextCache_SetBudget(size_t bytes)
+{
+    g_budget = bytes;
+    if (bytes == 0) TextCache_Clear();
+    else TextCache_EvictToBudget(NULL);
+}
+
+void TextCache_Clear(void)
+{
+    while (g_oldest) TextCache_Remove(g_oldest);
+    free(g_buckets);
+    g_buckets = NULL;
+    g_bucket_count = 0;
+}
+
+TextCacheStats TextCache_GetStats(void)
+{
+    return g_stats;
+}
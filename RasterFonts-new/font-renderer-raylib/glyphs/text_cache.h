@@ -0,0 +1,39 @@
+#ifndef TEXT_CACHE_H
+#define TEXT_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "glyphs.h"
+
+// Статистика кешу розтеризованих рядків
+typedef struct {
+    uint64_t hits;      // рядок намальовано з кешу
+    uint64_t misses;    // рядка ще не було в кеші
+    uint64_t evictions; // витіснено рядків через ліміт пам’яті
+    size_t bytes;       // пам’ять усіх записів разом з текстурами
+    int entries;        // кількість записів
+} TextCacheStats;
+
+// Кеш рядків, розтеризованих цілком у текстуру (вже з масштабом): рядок малюється
+// одним DrawTexture замість прямокутника на кожен відрізок пікселів.
+// Ключ - шрифт, масштаб, відступ і сам рядок; колір не входить у ключ, бо біла
+// текстура фарбується кольором тексту при малюванні. Рядок розтеризується, коли
+// зустрічається вдруге, тож змінний текст (лічильники, час) не витісняє постійні підписи
+
+// Ліміт пам’яті кешу в байтах. 0 - кеш вимкнено (за замовчуванням).
+// Текстури створюються і звільняються лише між InitWindow і CloseWindow.
+// Зменшення ліміту одразу витісняє найдавніше використані рядки
+void TextCache_SetBudget(size_t bytes);
+
+// Видалення всіх рядків з кешу (лічильники зберігаються)
+void TextCache_Clear(void);
+
+// Статистика кешу
+TextCacheStats TextCache_GetStats(void);
+
+// Малювання рядка з кешу (викликається з DrawTextScaled).
+// Повертає 1, якщо рядок намальовано, 0 - його треба малювати по гліфах
+int TextCache_DrawText(const RasterFont font, int x, int y, const char* text,
+                       int spacing, int scale, Color color);
+
+#endif // TEXT_CACHE_H
@@ -0,0 +1,311 @@
+// text_layout.c
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "text_layout.h"
+
+// Тимчасові масиви для рядків, розкладених під час одного оновлення
+typedef struct {
+    LayoutGlyph* data;
+    int count;
+    int capacity;
+} LayoutGlyphArray;
+
+typedef struct {
+    LayoutLine* data;
+    int count;
+    int capacity;
+} LayoutLineArray;
+
+// Збільшує масив *data до щонайменше needed елементів розміром size. Повертає 0 при нестачі пам’яті
+static int GrowArray(void** data, int* capacity, int needed, size_t size)
+{
+    if (needed <= *capacity) return 1;
+
+    int newCapacity = *capacity ? *capacity : 16;
+    while (newCapacity < needed) newCapacity *= 2;
+
+    void* grown = realloc(*data, (size_t)newCapacity * size);
+    if (!grown) return 0;
+    *data = grown;
+    *capacity = newCapacity;
+    return 1;
+}
+
+void TextLayout_Init(TextLayout* layout, const RasterFont font, int spacing, int scale, int maxWidth)
+{
+    memset(layout, 0, sizeof(*layout));
+    layout->font = font;
+    layout->spacing = spacing;
+    layout->scale = scale;
+    layout->max_width = maxWidth;
+}
+
+void TextLayout_Free(TextLayout* layout)
+{
+    free(layout->text);
+    free(layout->glyphs);
+    free(layout->lines);
+    TextLayout_Init(layout, layout->font, layout->spacing, layout->scale, layout->max_width);
+}
+
+/*
+ * Розкладає один рядок, що починається з байта start: гліфи дописуються в glyphs,
+ * межі рядка - в line (first_glyph - індекс у glyphs). У *next записується початок
+ * наступного рядка, або -1, якщо текст закінчився.
+ * Перенос жадібний: слово, яке не вміщується в max_width, переходить на новий рядок
+ * разом з усім після нього, а пробіли на місці переносу не потрапляють в жоден рядок.
+ * Слово, довше за весь рядок, розривається посимвольно.
+ */
+static int LayoutOneLine(const TextLayout* layout, int start, LayoutGlyphArray* glyphs,
+                         LayoutLine* line, int* next)
+{
+    const RasterFont font = layout->font;
+    const char* text = layout->text;
+    const char* end = text + layout->length;
+    const char* ascii = text + start;
+    int first = glyphs->count;
+    int pos = start;
+    int x = 0;              // позиція наступного гліфа
+    int contentWidth = 0;   // правий край останнього гліфа, що не є пробілом
+    int inSpaces = 0;       // попередній символ - пробіл
+
+    // Останнє місце переносу: кінець слова перед пробілами і початок наступного слова
+    int breakGlyphs = -1, breakLength = 0, breakWidth = 0, breakNext = 0;
+
+    line->start = start;
+    line->first_glyph = first;
+
+    for (;;) {
+        if (text[pos] == '\0' || text[pos] == '\n') {
+            line->length = pos - start;
+            line->width = contentWidth;
+            *next = (text[pos] == '\n') ? pos + 1 : -1;
+            break;
+        }
+
+        uint32_t codepoint = 0;
+        int bytes = utf8_next(text + pos, end, &ascii, &codepoint);
+
+        const GlyphPointerMap* glyph = FindGlyph(font, codepoint);
+        if (!glyph) glyph = FindGlyph(font, 32); // заміна на пробіл, якщо не знайдено
+        if (!glyph) {
+            pos += bytes;
+            continue;
+        }
+
+        int w = font.glyph_widths[glyph - font.glyph_map] * layout->scale;
+        int isSpace = (codepoint == ' ');
+
+        if (isSpace) {
+            // Перший пробіл після слова - можливе місце переносу (пробіли на початку рядка - ні)
+            if (!inSpaces && glyphs->count > first) {
+                breakGlyphs = glyphs->count - first;
+                breakLength = pos - start;
+                breakWidth = contentWidth;
+            }
+            if (breakGlyphs >= 0) breakNext = pos + bytes;
+        } else if (layout->max_width > 0 && glyphs->count > first && x + w > layout->max_width) {
+            if (breakGlyphs >= 0) {
+                // Переносимо все слово
+                glyphs->count = first + breakGlyphs;
+                line->length = breakLength;
+                line->width = breakWidth;
+                *next = breakNext;
+            } else {
+                // Слово довше за рядок - розриваємо перед цим символом
+                line->length = pos - start;
+                line->width = contentWidth;
+                *next = pos;
+            }
+            break;
+        }
+
+        if (!GrowArray((void**)&glyphs->data, &glyphs->capacity, glyphs->count + 1, sizeof(LayoutGlyph)))
+            return 0;
+        LayoutGlyph* placed = &glyphs->data[glyphs->count++];
+        placed->glyph = glyph;
+        placed->x = x;
+        placed->offset = pos;
+
+        if (!isSpace) contentWidth = x + w;
+        inSpaces = isSpace;
+        x += w + layout->spacing;
+        pos += bytes;
+    }
+
+    line->glyph_count = glyphs->count - first;
+    return 1;
+}
+
+/*
+ * Перерозкладка після зміни тексту: байти [0, changeStart) не змінились,
+ * байти від changeEnd (у новому тексті) збігаються зі старими, зсунутими на delta.
+ * Розкладка починається з рядка перед тим, що містить changeStart (перше слово
+ * зміненого рядка могло вміститись у попередній), і закінчується, щойно новий рядок
+ * починається там само, де й один зі старих рядків після зміни - далі все як було.
+ */
+static int TextLayout_Relayout(TextLayout* layout, int changeStart, int changeEnd, int delta)
+{
+    int oldLineCount = layout->line_count;
+    int oldGlyphCount = layout->glyph_count;
+
+    // Рядок, що містить changeStart (бінарний пошук за початком рядка), і рядок перед ним
+    int firstLine = 0;
+    int lo = 0, hi = oldLineCount - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        if (layout->lines[mid].start <= changeStart) {
+            firstLine = mid;
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    if (firstLine > 0) firstLine--;
+
+    int keepGlyphs = (firstLine < oldLineCount) ? layout->lines[firstLine].first_glyph : 0;
+    int pos = (firstLine < oldLineCount) ? layout->lines[firstLine].start : 0;
+
+    LayoutGlyphArray glyphs = { 0 };
+    LayoutLineArray lines = { 0 };
+    int tail = -1;              // перший старий рядок, що лишається без змін
+    int oldLine = firstLine + 1;
+
+    while (layout->length > 0) {
+        if (!GrowArray((void**)&lines.data, &lines.capacity, lines.count + 1, sizeof(LayoutLine)) ||
+            !LayoutOneLine(layout, pos, &glyphs, &lines.data[lines.count], &pos)) {
+            free(glyphs.data);
+            free(lines.data);
+            return 0;
+        }
+        lines.count++;
+        if (pos < 0) break;
+
+        // Чи починається старий рядок там само (за межами зміни)
+        if (pos >= changeEnd) {
+            while (oldLine < oldLineCount && layout->lines[oldLine].start + delta < pos) oldLine++;
+            if (oldLine < oldLineCount && layout->lines[oldLine].start + delta == pos) {
+                tail = oldLine;
+                break;
+            }
+        }
+    }
+
+    // Старі рядки від tail до кінця переносяться без змін зі зсувом позицій
+    int tailLines = (tail >= 0) ? oldLineCount - tail : 0;
+    int tailGlyphStart = (tail >= 0) ? layout->lines[tail].first_glyph : oldGlyphCount;
+    int tailGlyphs = oldGlyphCount - tailGlyphStart;
+    int glyphTotal = keepGlyphs + glyphs.count + tailGlyphs;
+    int lineTotal = firstLine + lines.count + tailLines;
+
+    if (!GrowArray((void**)&layout->glyphs, &layout->glyph_capacity, glyphTotal, sizeof(LayoutGlyph)) ||
+        !GrowArray((void**)&layout->lines, &layout->line_capacity, lineTotal, sizeof(LayoutLine))) {
+        free(glyphs.data);
+        free(lines.data);
+        return 0;
+    }
+
+    int glyphShift = keepGlyphs + glyphs.count - tailGlyphStart;
+    if (tailGlyphs > 0)
+        memmove(layout->glyphs + keepGlyphs + glyphs.count, layout->glyphs + tailGlyphStart,
+                tailGlyphs * sizeof(LayoutGlyph));
+    if (glyphs.count > 0)
+        memcpy(layout->glyphs + keepGlyphs, glyphs.data, glyphs.count * sizeof(LayoutGlyph));
+    for (int i = keepGlyphs + glyphs.count; i < glyphTotal; i++) layout->glyphs[i].offset += delta;
+
+    if (tailLines > 0)
+        memmove(layout->lines + firstLine + lines.count, layout->lines + tail,
+                tailLines * sizeof(LayoutLine));
+    for (int i = 0; i < lines.count; i++) {
+        lines.data[i].first_glyph += keepGlyphs;
+        layout->lines[firstLine + i] = lines.data[i];
+    }
+    for (int i = firstLine + lines.count; i < lineTotal; i++) {
+        layout->lines[i].start += delta;
+        layout->lines[i].first_glyph += glyphShift;
+    }
+
+    layout->glyph_count = glyphTotal;
+    layout->line_count = lineTotal;
+    layout->first_changed_line = firstLine;
+    layout->relaid_line_count = lines.count;
+    free(glyphs.data);
+    free(lines.data);
+
+    // Розмір розкладки
+    layout->width = 0;
+    for (int i = 0; i < lineTotal; i++) {
+        if (layout->lines[i].width > layout->width) layout->width = layout->lines[i].width;
+    }
+    layout->height = lineTotal > 0
+        ? lineTotal * layout->font.glyph_height * layout->scale + (lineTotal - 1) * layout->spacing
+        : 0;
+    return 1;
+}
+
+int TextLayout_SetText(TextLayout* layout, const char* text)
+{
+    if (!text) text = "";
+    int oldLength = layout->length;
+    int newLength = (int)strlen(text);
+    const char* old = layout->text ? layout->text : "";
+
+    // Спільний початок і спільний кінець старого і нового тексту
+    int prefix = 0;
+    while (prefix < oldLength && prefix < newLength && old[prefix] == text[prefix]) prefix++;
+    if (prefix == oldLength && prefix == newLength) {
+        layout->first_changed_line = layout->line_count;
+        layout->relaid_line_count = 0;
+        return 1;
+    }
+    int suffix = 0;
+    while (suffix < oldLength - prefix && suffix < newLength - prefix &&
+           old[oldLength - 1 - suffix] == text[newLength - 1 - suffix]) suffix++;
+
+    if (!GrowArray((void**)&layout->text, &layout->text_capacity, newLength + 1, 1)) return 0;
+    memcpy(layout->text, text, newLength + 1);
+    layout->length = newLength;
+
+    return TextLayout_Relayout(layout, prefix, newLength - suffix, newLength - oldLength);
+}
+
+int TextLayout_Append(TextLayout* layout, const char* text)
+{
+    if (!text || !*text) return 1;
+    int oldLength = layout->length;
+    int added = (int)strlen(text);
+
+    if (!GrowArray((void**)&layout->text, &layout->text_capacity, oldLength + added + 1, 1)) return 0;
+    memcpy(layout->text + oldLength, text, added + 1);
+    layout->length = oldLength + added;
+
+    return TextLayout_Relayout(layout, oldLength, layout->length, added);
+}
+
+int TextLayout_SetMaxWidth(TextLayout* layout, int maxWidth)
+{
+    if (layout->max_width == maxWidth) return 1;
+    layout->max_width = maxWidth;
+    return TextLayout_Relayout(layout, 0, layout->length, 0);
+}
+
+void DrawTextLayout(const TextLayout* layout, int x, int y, Color color)
+{
+    const RasterFont font = layout->font;
+    int lineStep = font.glyph_height * layout->scale + layout->spacing;
+
+    for (int i = 0; i < layout->line_count; i++) {
+        const LayoutLine* line = &layout->lines[i];
+        int ypos = y + i * lineStep;
+
+        for (int g = 0; g < line->glyph_count; g++) {
+            const LayoutGlyph* placed = &layout->glyphs[line->first_glyph + g];
+            int index = (int)(placed->glyph - font.glyph_map);
+            DrawGlyphWithOffsets(placed->glyph->glyph, font.glyph_widths[index], font.glyph_heights[index],
+                                 font.glyph_bytes, x + placed->x, ypos, layout->scale,
+                                 font.glyph_vertical_offsets[index], 0, color);
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef TEXT_LAYOUT_H
+#define TEXT_LAYOUT_H
+
+#include <stdint.h>
+#include "glyphs.h"
+
+// Розміщений гліф: гліф шрифту і його позиція в рядку
+typedef struct {
+    const GlyphPointerMap* glyph;   // гліф (пробіл замість відсутнього гліфа)
+    int x;                          // зсув від початку рядка в пікселях (з масштабом)
+    int offset;                     // зсув символу в тексті (байти)
+} LayoutGlyph;
+
+// Рядок розкладки
+typedef struct {
+    int start;          // зсув першого байта рядка в тексті
+    int length;         // довжина рядка в байтах (без '\n' і пробілів на місці переносу)
+    int width;          // ширина рядка в пікселях (без пробілів у кінці)
+    int first_glyph;    // індекс першого гліфа рядка в масиві glyphs
+    int glyph_count;    // кількість гліфів рядка
+} LayoutLine;
+
+// Розкладка тексту з переносом слів у межах ширини max_width.
+// Зберігає копію тексту, межі рядків і позиції гліфів, тож малювання не декодує
+// UTF-8 і не шукає гліфи, а зміна тексту перераховує лише рядки, яких вона торкається
+typedef struct {
+    RasterFont font;
+    int spacing;                // відступ між символами і між рядками
+    int scale;                  // масштаб
+    int max_width;              // ширина переносу в пікселях (0 - лише за '\n')
+
+    char* text;                 // копія тексту (з завершальним нулем)
+    int length;                 // довжина тексту в байтах
+    int text_capacity;
+
+    LayoutGlyph* glyphs;        // гліфи всіх рядків підряд
+    int glyph_count;
+    int glyph_capacity;
+
+    LayoutLine* lines;          // рядки
+    int line_count;
+    int line_capacity;
+
+    int width;                  // ширина найширшого рядка
+    int height;                 // висота всіх рядків
+
+    int first_changed_line;     // перший рядок, змінений останнім оновленням
+    int relaid_line_count;      // скільки рядків розкладено заново при останньому оновленні
+} TextLayout;
+
+// Створення порожньої розкладки
+void TextLayout_Init(TextLayout* layout, const RasterFont font, int spacing, int scale, int maxWidth);
+
+// Звільнення пам’яті розкладки
+void TextLayout_Free(TextLayout* layout);
+
+// Заміна тексту. Розкладаються заново лише рядки від зміненого місця і доти,
+// доки перенос не збігається зі старим. Повертає 0 при нестачі пам’яті
+int TextLayout_SetText(TextLayout* layout, const char* text);
+
+// Додавання тексту в кінець (перераховуються лише останні рядки)
+int TextLayout_Append(TextLayout* layout, const char* text);
+
+// Зміна ширини переносу з повною перерозкладкою
+int TextLayout_SetMaxWidth(TextLayout* layout, int maxWidth);
+
+// Малювання розкладки з лівим верхнім кутом у (x, y)
+void DrawTextLayout(const TextLayout* layout, int x, int y, Color color);
+
+#endif // TEXT_LAYOUT_H
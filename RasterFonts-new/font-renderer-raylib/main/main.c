@@ -4,6 +4,7 @@
 
 #include "all_font.h" // Опис шрифтів як структури RasterFont
 #include "glyphs.h"
+#include "text_cache.h"
 
 int main(void) {
     const int screenWidth = 420;
@@ -19,11 +20,18 @@ int main(void) {
 
     SetTargetFPS(60);
 
+    // Підписи з фоном однакові в кожному кадрі - малюємо їх готовими текстурами
+    TextCache_SetBudget(256 * 1024);
+
     int scale = 2; // масштаб 1x
     int spacing = 1; // простір між символами px
     int padding = 5;
     int borderThickness = 1;
 
+    // Незмінні підписи розбираються один раз, а не кожен кадр
+    GlyphRun pixelLabel = CreateGlyphRun(Pixel_font, "Масштабований текст x2", spacing, scale);
+    GlyphRun freePixelLabel = CreateGlyphRun(FreePixel_font, "Масштабований текст x2", spacing, scale);
+
     while (!WindowShouldClose()) {
         // frameTime += GetFrameTime();
         // if (frameTime * 1000.0f >= oscData.refresh_rate_ms) {
@@ -50,13 +58,16 @@ int main(void) {
                                            "Масштабований текст\nз інверсним фоном",
                                            spacing, scale, RED, padding, borderThickness);
 
-        DrawTextScaled(Pixel_font, 30, 260, "Масштабований текст x2", spacing, scale, BLUE); // масштаб 2x
-        DrawTextScaled(FreePixel_font, 30, 290, "Масштабований текст x2", spacing, scale, RED); // масштаб 2x
+        DrawGlyphRun(&pixelLabel, 30, 260, BLUE); // масштаб 2x
+        DrawGlyphRun(&freePixelLabel, 30, 290, RED); // масштаб 2x
 
         EndDrawing();
     }
 
     // Після виходу з циклу звільняємо пам'ять шрифту
+    UnloadGlyphRun(pixelLabel);
+    UnloadGlyphRun(freePixelLabel);
+    TextCache_Clear(); // текстури звільняються до закриття вікна
 
     CloseWindow();
 
@@ -49,6 +49,83 @@ static void GetGlyphMetrics(const uint8_t* glyph, int width, int height, int byt
     }
 }
 
+// Запис таблиці пошуку: Unicode код і його індекс у glyph_ptr_map
+typedef struct {
+    uint32_t unicode;
+    int index;
+} GlyphLookupEntry;
+
+// Порівняння для qsort: за Unicode, а для однакових кодів — за індексом у мапі
+static int CompareGlyphLookupEntries(const void* a, const void* b) {
+    const GlyphLookupEntry* ea = (const GlyphLookupEntry*)a;
+    const GlyphLookupEntry* eb = (const GlyphLookupEntry*)b;
+    if (ea->unicode != eb->unicode) return (ea->unicode < eb->unicode) ? -1 : 1;
+    return ea->index - eb->index;
+}
+
+/*
+ * ExportGlyphLookup - експорт таблиць пошуку гліфа за Unicode для FindGlyph.
+ * ASCII (0..127) - пряма таблиця індексів у glyph_ptr_map (-1 - гліфа немає),
+ * решта кодів - індекси glyph_ptr_map, відсортовані за Unicode (бінарний пошук).
+ * Для дубльованих кодів лишається перший запис мапи, як і при лінійному пошуку.
+ *
+ * unicodes - Unicode коди записів glyph_ptr_map у порядку мапи
+ * count - кількість записів glyph_ptr_map
+ */
+static void ExportGlyphLookup(FILE* out_c, const char* fontname, const uint32_t* unicodes, int count)
+{
+    int ascii[128];
+    for (int i = 0; i < 128; ++i) ascii[i] = -1;
+
+    GlyphLookupEntry* sorted = malloc((count > 0 ? count : 1) * sizeof(GlyphLookupEntry));
+    if (!sorted) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+
+    int sorted_count = 0;
+    for (int i = 0; i < count; ++i) {
+        if (unicodes[i] < 128) {
+            if (ascii[unicodes[i]] < 0) ascii[unicodes[i]] = i;
+        } else {
+            sorted[sorted_count].unicode = unicodes[i];
+            sorted[sorted_count].index = i;
+            sorted_count++;
+        }
+    }
+    qsort(sorted, sorted_count, sizeof(GlyphLookupEntry), CompareGlyphLookupEntries);
+
+    // Прибираємо дублікати кодів, залишаючи запис з меншим індексом
+    int unique_count = 0;
+    for (int i = 0; i < sorted_count; ++i) {
+        if (unique_count > 0 && sorted[unique_count - 1].unicode == sorted[i].unicode) continue;
+        sorted[unique_count++] = sorted[i];
+    }
+
+    fprintf(out_c, "const int16_t %s_glyph_ascii_lookup[128] = {", fontname);
+    for (int i = 0; i < 128; ++i) {
+        if (i % 16 == 0) fprintf(out_c, "\n    ");
+        fprintf(out_c, "%d", ascii[i]);
+        if (i < 127) fprintf(out_c, ", ");
+    }
+    fprintf(out_c, "\n};\n\n");
+
+    // Порожній масив у C недопустимий — лишаємо один фіктивний елемент
+    fprintf(out_c, "const uint16_t %s_glyph_sorted_lookup[%d] = {", fontname,
+            unique_count > 0 ? unique_count : 1);
+    for (int i = 0; i < unique_count; ++i) {
+        if (i % 12 == 0) fprintf(out_c, "\n    ");
+        fprintf(out_c, "%d", sorted[i].index);
+        if (i < unique_count - 1) fprintf(out_c, ", ");
+    }
+    if (unique_count == 0) fprintf(out_c, "\n    0");
+    fprintf(out_c, "\n};\n\n");
+
+    fprintf(out_c, "const int %s_glyph_sorted_lookup_count = %d;\n\n", fontname, unique_count);
+
+    free(sorted);
+}
+
 void ExportGlyphsToC(PSF_Font font, const char* input_filename)
 {
     char fontname[256];
@@ -89,6 +166,9 @@ void ExportGlyphsToC(PSF_Font font, const char* input_filename)
             "extern const int %s_glyph_bytes;\n\n"
             "extern const GlyphPointerMap %s_glyph_ptr_map[];\n"
             "extern const int %s_glyph_ptr_map_count;\n\n"
+            "extern const int16_t %s_glyph_ascii_lookup[];\n"
+            "extern const uint16_t %s_glyph_sorted_lookup[];\n"
+            "extern const int %s_glyph_sorted_lookup_count;\n\n"
             "extern const int %s_glyph_widths[];\n"
             "extern const int %s_glyph_heights[];\n"
             "extern const int %s_glyph_vertical_offsets[];\n"
@@ -97,7 +177,8 @@ void ExportGlyphsToC(PSF_Font font, const char* input_filename)
             "#endif // %s_H\n",
             fontname,fontname,fontname,fontname,fontname,
             fontname,fontname,fontname,fontname,fontname,
-            fontname,fontname);
+            fontname,fontname,fontname,fontname,fontname,
+            fontname);
 
     fprintf(out_c, "#include \"%s.h\"\n\n", fontname);
     fprintf(out_c, "const int %s_glyph_width = %d;\n", fontname, font.width);
@@ -127,18 +208,31 @@ void ExportGlyphsToC(PSF_Font font, const char* input_filename)
         glyphs_exported++;
     }
 
+    int cyr_count = sizeof(cyr_map)/sizeof(cyr_map[0]);
+    uint32_t* map_unicodes = malloc((95 + cyr_count) * sizeof(uint32_t));
+    if (!map_unicodes) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    int map_count = 0;
+
     fprintf(out_c, "const GlyphPointerMap %s_glyph_ptr_map[] = {\n", fontname);
     for (int i = 32; i < 127; ++i) {
         fprintf(out_c, "    {0x%04X, %s_glyph_%03X},\n", i, fontname, i);
+        map_unicodes[map_count++] = i;
     }
-    int cyr_count = sizeof(cyr_map)/sizeof(cyr_map[0]);
     for (int i = 0; i < cyr_count; ++i) {
         uint32_t uc = cyr_map[i].unicode;
         if (uc >= 32 && uc <= 126) continue;
         fprintf(out_c, "    {0x%04X, %s_glyph_%03X},\n", uc, fontname, cyr_map[i].glyph_index);
+        map_unicodes[map_count++] = uc;
     }
     fprintf(out_c, "};\n\n");
 
+    // Таблиці O(1)/O(log n) пошуку гліфа для FindGlyph
+    ExportGlyphLookup(out_c, fontname, map_unicodes, map_count);
+    free(map_unicodes);
+
     // Вивід метаданих
     fprintf(out_c, "const int %s_glyph_widths[%d] = {\n", fontname, glyphs_exported);
     for (int i = 0; i < glyphs_exported; ++i) {
@@ -176,13 +270,17 @@ void ExportGlyphsToC(PSF_Font font, const char* input_filename)
             "    .glyph_widths = %s_glyph_widths,\n"
             "    .glyph_heights = %s_glyph_heights,\n"
             "    .glyph_vertical_offsets = %s_glyph_vertical_offsets,\n"
-            "    .glyph_horizontal_offsets = %s_glyph_horizontal_offsets\n"
+            "    .glyph_horizontal_offsets = %s_glyph_horizontal_offsets,\n"
+            "    .glyph_ascii_lookup = %s_glyph_ascii_lookup,\n"
+            "    .glyph_sorted_lookup = %s_glyph_sorted_lookup,\n"
+            "    .glyph_sorted_count = %s_glyph_sorted_lookup_count\n"
             "};\n",
-            fontname, glyphs_exported, fontname,
+            fontname, map_count, fontname,
             fontname,
             fontname, fontname, fontname,
             fontname, fontname,
-            fontname, fontname, fontname, fontname, fontname);
+            fontname, fontname, fontname, fontname,
+            fontname, fontname, fontname);
 
     free(widths);
     free(heights);
@@ -11,6 +11,10 @@ extern const int Pixel_glyph_bytes;
 extern const GlyphPointerMap Pixel_glyph_ptr_map[];
 extern const int Pixel_glyph_ptr_map_count;
 
+extern const int16_t Pixel_glyph_ascii_lookup[];
+extern const uint16_t Pixel_glyph_sorted_lookup[];
+extern const int Pixel_glyph_sorted_lookup_count;
+
 extern const int Pixel_glyph_widths[];
 extern const int Pixel_glyph_heights[];
 extern const int Pixel_glyph_vertical_offsets[];
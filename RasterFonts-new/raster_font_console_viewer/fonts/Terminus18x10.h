@@ -12,6 +12,10 @@ extern const int Terminus18x10_glyph_bytes;
 extern const GlyphPointerMap Terminus18x10_glyph_ptr_map[];
 extern const int Terminus18x10_glyph_ptr_map_count;
 
+extern const int16_t Terminus18x10_glyph_ascii_lookup[];
+extern const uint16_t Terminus18x10_glyph_sorted_lookup[];
+extern const int Terminus18x10_glyph_sorted_lookup_count;
+
 extern const int Terminus18x10_glyph_widths[];
 extern const int Terminus18x10_glyph_heights[];
 extern const int Terminus18x10_glyph_vertical_offsets[];
@@ -19,4 +23,4 @@ extern const int Terminus18x10_glyph_horizontal_offsets[];
 
 extern const RasterFont Terminus18x10_font;
 
-#endif // VZs_H
+#endif // Terminus18x10_H
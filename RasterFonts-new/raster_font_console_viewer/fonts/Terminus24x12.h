@@ -12,6 +12,10 @@ extern const int Terminus24x12_glyph_bytes;
 extern const GlyphPointerMap Terminus24x12_glyph_ptr_map[];
 extern const int Terminus24x12_glyph_ptr_map_count;
 
+extern const int16_t Terminus24x12_glyph_ascii_lookup[];
+extern const uint16_t Terminus24x12_glyph_sorted_lookup[];
+extern const int Terminus24x12_glyph_sorted_lookup_count;
+
 extern const int Terminus24x12_glyph_widths[];
 extern const int Terminus24x12_glyph_heights[];
 extern const int Terminus24x12_glyph_vertical_offsets[];
@@ -19,4 +23,4 @@ extern const int Terminus24x12_glyph_horizontal_offsets[];
 
 extern const RasterFont Terminus24x12_font;
 
-#endif // &ն|_H
+#endif // Terminus24x12_H
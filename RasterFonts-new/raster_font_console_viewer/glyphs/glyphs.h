@@ -16,6 +16,9 @@ typedef struct {
     const int* glyph_heights;           // масив фактичних висот кожного гліфа
     const int* glyph_vertical_offsets; // масив вертикальних зсувів для вирівнювання по baseline
     const int* glyph_horizontal_offsets; // масив горизонтальних зсувів гліфів
+    const int16_t* glyph_ascii_lookup;  // ASCII -> індекс у glyph_map (-1 - немає), або NULL
+    const uint16_t* glyph_sorted_lookup; // індекси glyph_map для кодів >= 128, відсортовані за Unicode
+    int glyph_sorted_count;             // кількість записів у glyph_sorted_lookup
 } RasterFont;
 
 // Оголошення функцій
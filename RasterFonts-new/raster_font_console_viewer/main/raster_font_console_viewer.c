@@ -57,6 +57,25 @@ static const FontEntry g_fonts[] = {
    Пошук гліфа в шрифті
    ============================================================ */
 static const GlyphPointerMap* find_glyph(const RasterFont* font, uint32_t unicode) {
+    if (font->glyph_ascii_lookup && font->glyph_sorted_lookup) {
+        // ASCII - пряма таблиця
+        if (unicode < 128) {
+            int index = font->glyph_ascii_lookup[unicode];
+            return (index >= 0) ? &font->glyph_map[index] : NULL;
+        }
+        // Решта - бінарний пошук по відсортованих індексах
+        int lo = 0, hi = font->glyph_sorted_count - 1;
+        while (lo <= hi) {
+            int mid = (lo + hi) / 2;
+            const GlyphPointerMap* entry = &font->glyph_map[font->glyph_sorted_lookup[mid]];
+            if (entry->unicode == unicode) return entry;
+            if (entry->unicode < unicode) lo = mid + 1;
+            else hi = mid - 1;
+        }
+        return NULL;
+    }
+
+    // Шрифт без таблиць пошуку - лінійний пошук
     for (int i = 0; i < font->glyph_count; i++) {
         if (font->glyph_map[i].unicode == unicode)
             return &font->glyph_map[i];
@@ -151,6 +151,83 @@ void GetFontName(const char* filepath, char* fontname, size_t max_len)
     fontname[len] = '\0';
 }
 
+// Запис таблиці пошуку: Unicode код і його індекс у glyph_ptr_map
+typedef struct {
+    uint32_t unicode;
+    int index;
+} GlyphLookupEntry;
+
+// Порівняння для qsort: за Unicode, а для однакових кодів — за індексом у мапі
+static int CompareGlyphLookupEntries(const void* a, const void* b) {
+    const GlyphLookupEntry* ea = (const GlyphLookupEntry*)a;
+    const GlyphLookupEntry* eb = (const GlyphLookupEntry*)b;
+    if (ea->unicode != eb->unicode) return (ea->unicode < eb->unicode) ? -1 : 1;
+    return ea->index - eb->index;
+}
+
+/*
+ * ExportGlyphLookup - експорт таблиць пошуку гліфа за Unicode для FindGlyph.
+ * ASCII (0..127) - пряма таблиця індексів у glyph_ptr_map (-1 - гліфа немає),
+ * решта кодів - індекси glyph_ptr_map, відсортовані за Unicode (бінарний пошук).
+ * Для дубльованих кодів лишається перший запис мапи, як і при лінійному пошуку.
+ *
+ * unicodes - Unicode коди записів glyph_ptr_map у порядку мапи
+ * count - кількість записів glyph_ptr_map
+ */
+static void ExportGlyphLookup(FILE* out_c, const char* fontname, const uint32_t* unicodes, int count)
+{
+    int ascii[128];
+    for (int i = 0; i < 128; ++i) ascii[i] = -1;
+
+    GlyphLookupEntry* sorted = malloc((count > 0 ? count : 1) * sizeof(GlyphLookupEntry));
+    if (!sorted) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+
+    int sorted_count = 0;
+    for (int i = 0; i < count; ++i) {
+        if (unicodes[i] < 128) {
+            if (ascii[unicodes[i]] < 0) ascii[unicodes[i]] = i;
+        } else {
+            sorted[sorted_count].unicode = unicodes[i];
+            sorted[sorted_count].index = i;
+            sorted_count++;
+        }
+    }
+    qsort(sorted, sorted_count, sizeof(GlyphLookupEntry), CompareGlyphLookupEntries);
+
+    // Прибираємо дублікати кодів, залишаючи запис з меншим індексом
+    int unique_count = 0;
+    for (int i = 0; i < sorted_count; ++i) {
+        if (unique_count > 0 && sorted[unique_count - 1].unicode == sorted[i].unicode) continue;
+        sorted[unique_count++] = sorted[i];
+    }
+
+    fprintf(out_c, "const int16_t %s_glyph_ascii_lookup[128] = {", fontname);
+    for (int i = 0; i < 128; ++i) {
+        if (i % 16 == 0) fprintf(out_c, "\n    ");
+        fprintf(out_c, "%d", ascii[i]);
+        if (i < 127) fprintf(out_c, ", ");
+    }
+    fprintf(out_c, "\n};\n\n");
+
+    // Порожній масив у C недопустимий — лишаємо один фіктивний елемент
+    fprintf(out_c, "const uint16_t %s_glyph_sorted_lookup[%d] = {", fontname,
+            unique_count > 0 ? unique_count : 1);
+    for (int i = 0; i < unique_count; ++i) {
+        if (i % 12 == 0) fprintf(out_c, "\n    ");
+        fprintf(out_c, "%d", sorted[i].index);
+        if (i < unique_count - 1) fprintf(out_c, ", ");
+    }
+    if (unique_count == 0) fprintf(out_c, "\n    0");
+    fprintf(out_c, "\n};\n\n");
+
+    fprintf(out_c, "const int %s_glyph_sorted_lookup_count = %d;\n\n", fontname, unique_count);
+
+    free(sorted);
+}
+
 /*
  * ExportGlyphsToC - основна функція експорту гліфів з FT_Face у C файли.
  * Завантажує гліфи для заданих діапазонів Unicode,
@@ -189,6 +266,9 @@ void ExportGlyphsToC(FT_Face face, int glyph_width, int glyph_height, const char
             "extern const int %s_glyph_bytes;\n\n"
             "extern const GlyphPointerMap %s_glyph_ptr_map[];\n"
             "extern const int %s_glyph_ptr_map_count;\n\n"
+            "extern const int16_t %s_glyph_ascii_lookup[];\n"
+            "extern const uint16_t %s_glyph_sorted_lookup[];\n"
+            "extern const int %s_glyph_sorted_lookup_count;\n\n"
             "extern const int %s_glyph_widths[];\n"
             "extern const int %s_glyph_heights[];\n"
             "extern const int %s_glyph_vertical_offsets[];\n\n"
@@ -198,6 +278,7 @@ void ExportGlyphsToC(FT_Face face, int glyph_width, int glyph_height, const char
             fontname, fontname,
             fontname, fontname,
             fontname, fontname, fontname,
+            fontname, fontname, fontname,
             fontname, fontname);
 
     // Запис c-файлу
@@ -258,6 +339,13 @@ void ExportGlyphsToC(FT_Face face, int glyph_width, int glyph_height, const char
     }
     fprintf(out_c, "};\n\n");
 
+    // Таблиці пошуку гліфа для FindGlyph
+    uint32_t* map_unicodes = malloc(glyph_count * sizeof(uint32_t));
+    if (!map_unicodes) { fprintf(stderr, "Out of memory\n"); exit(1); }
+    for (int i = 0; i < glyph_count; ++i) map_unicodes[i] = glyphs[i].unicode;
+    ExportGlyphLookup(out_c, fontname, map_unicodes, glyph_count);
+    free(map_unicodes);
+
     // Метадані по ширинах, висотах, зсувам
     fprintf(out_c, "const int %s_glyph_widths[%d] = {\n", fontname, glyph_count);
     for (int i = 0; i < glyph_count; ++i) {
@@ -289,11 +377,15 @@ void ExportGlyphsToC(FT_Face face, int glyph_width, int glyph_height, const char
             "    .glyph_count = %s_glyph_ptr_map_count,\n"
             "    .glyph_widths = %s_glyph_widths,\n"
             "    .glyph_heights = %s_glyph_heights,\n"
-            "    .glyph_vertical_offsets = %s_glyph_vertical_offsets\n"
+            "    .glyph_vertical_offsets = %s_glyph_vertical_offsets,\n"
+            "    .glyph_ascii_lookup = %s_glyph_ascii_lookup,\n"
+            "    .glyph_sorted_lookup = %s_glyph_sorted_lookup,\n"
+            "    .glyph_sorted_count = %s_glyph_sorted_lookup_count\n"
             "};\n",
             fontname, fontname,
             fontname, fontname,
             fontname, fontname,
+            fontname, fontname, fontname,
             fontname, fontname, fontname);
 
     for (int i = 0; i < glyph_count; ++i) {
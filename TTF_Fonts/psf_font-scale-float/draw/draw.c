@@ -10,14 +10,32 @@ extern PSF_Font font12;
 extern PSF_Font font18;
 extern PSF_Font font32;
 
+static GlyphRun labels[3];
+static int labelsReady = 0;
+
 void drawTxt(void)
 {
     // font12 = LoadPSFFont("fonts/Uni3-Terminus12x6.psf");
     // font18 = LoadPSFFont("fonts/Uni3-TerminusBold18x10.psf");
     // font32 = LoadPSFFont("fonts/Uni3-TerminusBold32x16.psf");
 
-    DrawPSFText(font12, 40, 20, "Привіт Світ! Terminus12x6", 1, 3.0f, SKYBLUE);
-    DrawPSFText(font18, 40, 100, "Привіт Світ! TerminusBold18", 1, 2.0f, YELLOW);
-    DrawPSFText(font32, 40, 140, "Привіт Світ! TerminusBold32", 1, 1.25f, GREEN);
+    // Підписи не змінюються: текст розбирається при першому кадрі, далі малюються готові гліфи
+    if (!labelsReady) {
+        labels[0] = CreatePSFGlyphRun(font12, "Привіт Світ! Terminus12x6", 1, 3.0f);
+        labels[1] = CreatePSFGlyphRun(font18, "Привіт Світ! TerminusBold18", 1, 2.0f);
+        labels[2] = CreatePSFGlyphRun(font32, "Привіт Світ! TerminusBold32", 1, 1.25f);
+        labelsReady = 1;
+    }
+
+    DrawPSFGlyphRun(&labels[0], 40, 20, SKYBLUE);
+    DrawPSFGlyphRun(&labels[1], 40, 100, YELLOW);
+    DrawPSFGlyphRun(&labels[2], 40, 140, GREEN);
+}
+
+void unloadTxt(void)
+{
+    if (!labelsReady) return;
+    for (int i = 0; i < 3; i++) UnloadPSFGlyphRun(labels[i]);
+    labelsReady = 0;
 }
 
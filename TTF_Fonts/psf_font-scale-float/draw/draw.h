@@ -7,4 +7,7 @@
 
 void drawTxt(void);
 
+// Звільнення підписів drawTxt (до UnloadPSFFont)
+void unloadTxt(void);
+
 #endif // DRAW_H_
@@ -2,6 +2,7 @@
 #include "raylib.h"
 #include "psf_font.h"
 #include "GlyphCache.h"
+#include "GlyphPrewarm.h"
 #include "draw.h"
 
 PSF_Font font12;
@@ -11,13 +12,21 @@ PSF_Font font32;
 int main(void) {
     InitWindow(800, 450, "PSF Font with Multi-Font Glyph Cache");
 
-    font12 = LoadPSFFont("fonts/Uni3-Terminus12x6.psf");
-    font18 = LoadPSFFont("fonts/Uni3-TerminusBold18x10.psf");
-    font32 = LoadPSFFont("fonts/Uni3-TerminusBold32x16.psf");
+    font12 = LoadPSFFontMapped("fonts/Uni3-Terminus12x6.psf");
+    font18 = LoadPSFFontMapped("fonts/Uni3-TerminusBold18x10.psf");
+    font32 = LoadPSFFontMapped("fonts/Uni3-TerminusBold32x16.psf");
+
+    // Гліфи шрифтів розгортаються у фоні для масштабів, якими вони малюються в drawTxt
+    GlyphPrewarm_Font(font12, 3.0f);
+    GlyphPrewarm_Font(font18, 2.0f);
+    GlyphPrewarm_Font(font32, 1.25f);
 
     SetTargetFPS(60);
 
     while (!WindowShouldClose()) {
+        // Не більше 32 готових гліфів за кадр, щоб завантаження в атлас не збільшувало час кадру
+        GlyphPrewarm_Update(32);
+
         BeginDrawing();
         ClearBackground(BLACK);
 
@@ -31,6 +40,7 @@ int main(void) {
     }
 
     // Після виходу з циклу звільняємо пам'ять шрифту
+    unloadTxt();
     GlyphCache_ClearAllCaches();
     UnloadPSFFont(font12);
     UnloadPSFFont(font18);
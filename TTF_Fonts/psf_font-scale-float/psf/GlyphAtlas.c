@@ -0,0 +1,279 @@
+// GlyphAtlas.c
+#include "GlyphAtlas.h"
+#include "rlgl.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+// Полиця (shelf): горизонтальна смуга сторінки фіксованої висоти,
+// яка заповнюється гліфами зліва направо
+typedef struct {
+    int y;          // Верхній край полиці
+    int height;     // Висота полиці
+    int used;       // Зайнята ширина
+} GlyphAtlasShelf;
+
+// Звільнене місце на полиці: використовується заново для гліфа рівно того ж розміру
+// (гліфи PSF одного шрифту однакові, тож місце після витісненого гліфа не пропадає)
+typedef struct {
+    int x, y;       // Лівий верхній кут (разом з відступом)
+    int w, h;       // Розмір (разом з відступами)
+} GlyphAtlasSlot;
+
+// Сторінка атласу: одна текстура і набір полиць на ній
+typedef struct {
+    Texture2D texture;          // Текстура сторінки
+    int filter;                 // Фільтр текстури (POINT / BILINEAR)
+    GlyphAtlasShelf* shelves;   // Масив полиць
+    int shelfCount;             // Кількість полиць
+    int shelfCapacity;          // Розмір масиву полиць
+    int bottom;                 // Нижній край останньої полиці (звідси відкривається нова)
+    int liveGlyphs;             // Кількість розміщених і ще не повернених гліфів
+    GlyphAtlasSlot* freeSlots;  // Звільнені місця
+    int freeCount;              // Кількість звільнених місць
+    int freeCapacity;           // Розмір масиву звільнених місць
+    uint64_t lastUse;           // Позначка останнього використання (для LRU)
+} GlyphAtlasPage;
+
+// Сторінки атласу (масив росте за потреби)
+static GlyphAtlasPage* g_pages = NULL;
+static int g_pageCount = 0;
+static int g_pageCapacity = 0;
+
+// Ліміт пам’яті, лічильник використань і обробник витіснення
+static size_t g_budget = 0;
+static uint64_t g_useClock = 0;
+static uint64_t g_evictions = 0;
+static GlyphAtlasEvictCallback g_evictCallback = NULL;
+
+// Порожнє зображення сторінки: біле і повністю прозоре. Білий колір і у прозорих пікселях
+// не дає BILINEAR затемнювати краї гліфів при змішуванні з відступами
+static Image GlyphAtlas_BlankImage(void) {
+    Image blank = { 0 };
+    size_t pixels = (size_t)GLYPH_ATLAS_PAGE_SIZE * GLYPH_ATLAS_PAGE_SIZE;
+
+    blank.data = MemAlloc((unsigned int)(pixels * GLYPH_IMAGE_BYTES_PER_PIXEL));
+    if (!blank.data) return blank;
+    blank.width = GLYPH_ATLAS_PAGE_SIZE;
+    blank.height = GLYPH_ATLAS_PAGE_SIZE;
+    blank.mipmaps = 1;
+    blank.format = GLYPH_IMAGE_FORMAT;
+
+    // Пікселі GRAY_ALPHA: (255, 0)
+    uint8_t* data = (uint8_t*)blank.data;
+    for (size_t i = 0; i < pixels; i++) data[i * 2] = 0xFF;
+    return blank;
+}
+
+// Стирає сторінку: прибирає полиці і звільнені місця, очищує текстуру,
+// щоб прозорі відступи нових гліфів знову були чистими
+static void GlyphAtlas_ResetPage(GlyphAtlasPage* page) {
+    // Гліфи зі сторінки могли вже потрапити в поточний пакет малювання - малюємо його до стирання
+    rlDrawRenderBatchActive();
+
+    page->shelfCount = 0;
+    page->bottom = 0;
+    page->freeCount = 0;
+    page->liveGlyphs = 0;
+    Image blank = GlyphAtlas_BlankImage();
+    if (blank.data) UpdateTexture(page->texture, blank.data);
+    UnloadImage(blank);
+}
+
+// Витісняє найдавніше використану сторінку і переналаштовує її на фільтр filter.
+// Повертає номер сторінки або -1, якщо сторінок немає
+static int GlyphAtlas_EvictPage(int filter) {
+    int victim = -1;
+    for (int i = 0; i < g_pageCount; i++) {
+        if (victim < 0 || g_pages[i].lastUse < g_pages[victim].lastUse) victim = i;
+    }
+    if (victim < 0) return -1;
+
+    // Спершу власники гліфів забувають про сторінку, потім вона стирається
+    if (g_evictCallback) g_evictCallback(victim);
+    GlyphAtlasPage* page = &g_pages[victim];
+    GlyphAtlas_ResetPage(page);
+    if (page->filter != filter) {
+        SetTextureFilter(page->texture, filter);
+        page->filter = filter;
+    }
+    g_evictions++;
+    return victim;
+}
+
+// Створює нову порожню (прозору) сторінку з фільтром filter, повертає її номер або -1
+static int GlyphAtlas_NewPage(int filter) {
+    if (g_pageCount == g_pageCapacity) {
+        int newCapacity = g_pageCapacity ? g_pageCapacity * 2 : 4;
+        GlyphAtlasPage* pages = (GlyphAtlasPage*)realloc(g_pages, newCapacity * sizeof(GlyphAtlasPage));
+        if (!pages) {
+            fprintf(stderr, "Помилка виділення пам’яті для сторінок атласу\n");
+            return -1;
+        }
+        g_pages = pages;
+        g_pageCapacity = newCapacity;
+    }
+
+    Image blank = GlyphAtlas_BlankImage();
+    if (!blank.data) return -1;
+    Texture2D texture = LoadTextureFromImage(blank);
+    UnloadImage(blank);
+    if (texture.id == 0) return -1;
+    SetTextureFilter(texture, filter);
+
+    GlyphAtlasPage* page = &g_pages[g_pageCount];
+    memset(page, 0, sizeof(*page));
+    page->texture = texture;
+    page->filter = filter;
+    return g_pageCount++;
+}
+
+// Пошук місця w x h (з відступами) на сторінці за алгоритмом полиць.
+// Обирається полиця з найменшою достатньою висотою; якщо такої немає - відкривається нова
+static int GlyphAtlas_PlaceOnPage(GlyphAtlasPage* page, int w, int h, int* outX, int* outY) {
+    // Звільнене місце точно такого ж розміру
+    for (int i = 0; i < page->freeCount; i++) {
+        GlyphAtlasSlot* slot = &page->freeSlots[i];
+        if (slot->w != w || slot->h != h) continue;
+        *outX = slot->x;
+        *outY = slot->y;
+        page->freeSlots[i] = page->freeSlots[--page->freeCount];
+        // Старий гліф на цьому місці міг уже потрапити в поточний пакет малювання
+        rlDrawRenderBatchActive();
+        return 1;
+    }
+
+    GlyphAtlasShelf* best = NULL;
+    for (int i = 0; i < page->shelfCount; i++) {
+        GlyphAtlasShelf* shelf = &page->shelves[i];
+        if (shelf->height < h || shelf->used + w > GLYPH_ATLAS_PAGE_SIZE) continue;
+        if (!best || shelf->height < best->height) best = shelf;
+    }
+
+    // Полиця набагато вища за гліф марнує місце - краще відкрити нову, якщо є куди
+    if (best && best->height > h + h / 2 && page->bottom + h <= GLYPH_ATLAS_PAGE_SIZE) best = NULL;
+
+    if (!best) {
+        if (page->bottom + h > GLYPH_ATLAS_PAGE_SIZE) return 0;
+        if (page->shelfCount == page->shelfCapacity) {
+            int newCapacity = page->shelfCapacity ? page->shelfCapacity * 2 : 16;
+            GlyphAtlasShelf* shelves = (GlyphAtlasShelf*)realloc(page->shelves, newCapacity * sizeof(GlyphAtlasShelf));
+            if (!shelves) return 0;
+            page->shelves = shelves;
+            page->shelfCapacity = newCapacity;
+        }
+        best = &page->shelves[page->shelfCount++];
+        best->y = page->bottom;
+        best->height = h;
+        best->used = 0;
+        page->bottom += h;
+    }
+
+    *outX = best->used;
+    *outY = best->y;
+    best->used += w;
+    return 1;
+}
+
+int GlyphAtlas_Add(int width, int height, const void* pixels, int filter, GlyphAtlasRegion* region) {
+    if (!region) return 0;
+    region->page = -1;
+
+    int w = width + 2 * GLYPH_ATLAS_PADDING;
+    int h = height + 2 * GLYPH_ATLAS_PADDING;
+    if (width <= 0 || height <= 0 || w > GLYPH_ATLAS_PAGE_SIZE || h > GLYPH_ATLAS_PAGE_SIZE) return 0;
+
+    // Спершу шукаємо місце на існуючих сторінках з тим самим фільтром (з кінця - там найбільше місця)
+    int page = -1, x = 0, y = 0;
+    for (int i = g_pageCount - 1; i >= 0 && page < 0; i--) {
+        if (g_pages[i].filter != filter) continue;
+        if (GlyphAtlas_PlaceOnPage(&g_pages[i], w, h, &x, &y)) page = i;
+    }
+    if (page < 0) {
+        // Нова сторінка не вміщується в ліміт - повторно використовуємо найдавнішу
+        if (g_budget && g_pageCount > 0 && (size_t)(g_pageCount + 1) * GLYPH_ATLAS_PAGE_BYTES > g_budget)
+            page = GlyphAtlas_EvictPage(filter);
+        else
+            page = GlyphAtlas_NewPage(filter);
+        if (page < 0 || !GlyphAtlas_PlaceOnPage(&g_pages[page], w, h, &x, &y)) return 0;
+    }
+
+    Rectangle source = { (float)(x + GLYPH_ATLAS_PADDING), (float)(y + GLYPH_ATLAS_PADDING),
+                         (float)width, (float)height };
+    UpdateTextureRec(g_pages[page].texture, source, pixels);
+
+    g_pages[page].liveGlyphs++;
+    g_pages[page].lastUse = ++g_useClock;
+    region->page = page;
+    region->source = source;
+    return 1;
+}
+
+void GlyphAtlas_Release(GlyphAtlasRegion region) {
+    if (region.page < 0 || region.page >= g_pageCount) return;
+
+    GlyphAtlasPage* page = &g_pages[region.page];
+    if (page->liveGlyphs > 0) page->liveGlyphs--;
+
+    // Сторінка порожня: стираємо її повністю
+    if (page->liveGlyphs == 0) {
+        GlyphAtlas_ResetPage(page);
+        return;
+    }
+
+    // Інакше запам’ятовуємо місце для наступного гліфа того ж розміру
+    if (page->freeCount == page->freeCapacity) {
+        int newCapacity = page->freeCapacity ? page->freeCapacity * 2 : 16;
+        GlyphAtlasSlot* slots = (GlyphAtlasSlot*)realloc(page->freeSlots, newCapacity * sizeof(GlyphAtlasSlot));
+        if (!slots) return; // Місце просто пропаде до очищення сторінки
+        page->freeSlots = slots;
+        page->freeCapacity = newCapacity;
+    }
+    GlyphAtlasSlot* slot = &page->freeSlots[page->freeCount++];
+    slot->x = (int)region.source.x - GLYPH_ATLAS_PADDING;
+    slot->y = (int)region.source.y - GLYPH_ATLAS_PADDING;
+    slot->w = (int)region.source.width + 2 * GLYPH_ATLAS_PADDING;
+    slot->h = (int)region.source.height + 2 * GLYPH_ATLAS_PADDING;
+}
+
+void GlyphAtlas_Touch(int page) {
+    if (page < 0 || page >= g_pageCount) return;
+    g_pages[page].lastUse = ++g_useClock;
+}
+
+void GlyphAtlas_SetBudget(size_t bytes) {
+    g_budget = bytes;
+}
+
+void GlyphAtlas_SetEvictCallback(GlyphAtlasEvictCallback callback) {
+    g_evictCallback = callback;
+}
+
+size_t GlyphAtlas_GetBytes(void) {
+    return (size_t)g_pageCount * GLYPH_ATLAS_PAGE_BYTES;
+}
+
+uint64_t GlyphAtlas_GetEvictionCount(void) {
+    return g_evictions;
+}
+
+Texture2D GlyphAtlas_GetTexture(int page) {
+    if (page < 0 || page >= g_pageCount) return (Texture2D){ 0 };
+    return g_pages[page].texture;
+}
+
+int GlyphAtlas_GetPageCount(void) {
+    return g_pageCount;
+}
+
+void GlyphAtlas_Unload(void) {
+    for (int i = 0; i < g_pageCount; i++) {
+        UnloadTexture(g_pages[i].texture);
+        free(g_pages[i].shelves);
+        free(g_pages[i].freeSlots);
+    }
+    free(g_pages);
+    g_pages = NULL;
+    g_pageCount = 0;
+    g_pageCapacity = 0;
+}
@@ -0,0 +1,63 @@
+// GlyphAtlas.h
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+#include "raylib.h"
+#include "GlyphToImage.h" // Формат пікселів гліфів (GRAY_ALPHA)
+#include <stdint.h>
+#include <stddef.h>
+
+// Розмір однієї сторінки атласу (текстури) в пікселях
+#define GLYPH_ATLAS_PAGE_SIZE 512
+
+// Прозорий відступ навколо кожного гліфа (щоб BILINEAR не захоплював сусідів)
+#define GLYPH_ATLAS_PADDING 1
+
+// Обсяг пам’яті однієї сторінки атласу (сторінки мають формат гліфів GLYPH_IMAGE_FORMAT)
+#define GLYPH_ATLAS_PAGE_BYTES ((size_t)GLYPH_ATLAS_PAGE_SIZE * GLYPH_ATLAS_PAGE_SIZE * GLYPH_IMAGE_BYTES_PER_PIXEL)
+
+// Місце гліфа в атласі: сторінка і прямокутник-джерело в її текстурі
+typedef struct {
+    int page;           // Номер сторінки атласу (-1 - гліф ще не розміщено)
+    Rectangle source;   // Прямокутник гліфа в текстурі сторінки
+} GlyphAtlasRegion;
+
+// Обробник витіснення сторінки: викликається перед повторним використанням сторінки page,
+// усі місця на ній після цього недійсні (повертати їх через GlyphAtlas_Release не треба)
+typedef void (*GlyphAtlasEvictCallback)(int page);
+
+// Розміщення зображення width x height (GLYPH_IMAGE_FORMAT, pixels) в атласі з фільтром filter
+// (TEXTURE_FILTER_POINT / TEXTURE_FILTER_BILINEAR). Сторінки з різним фільтром не змішуються.
+// Повертає 1 і заповнює region, або 0, якщо гліф не вміщується в сторінку
+int GlyphAtlas_Add(int width, int height, const void* pixels, int filter, GlyphAtlasRegion* region);
+
+// Повернення місця гліфа атласу. Місце використовується заново для гліфа того ж розміру,
+// а коли на сторінці не лишається живих гліфів, сторінка очищується повністю
+void GlyphAtlas_Release(GlyphAtlasRegion region);
+
+// Позначка використання сторінки (для вибору найдавніше використаної при витісненні)
+void GlyphAtlas_Touch(int page);
+
+// Ліміт пам’яті атласу в байтах (0 - без обмеження). Коли нова сторінка не вміщується в ліміт,
+// витісняється найдавніше використана сторінка (але завжди дозволена хоча б одна)
+void GlyphAtlas_SetBudget(size_t bytes);
+
+// Обробник витіснення сторінок (один на весь атлас)
+void GlyphAtlas_SetEvictCallback(GlyphAtlasEvictCallback callback);
+
+// Обсяг пам’яті всіх сторінок атласу в байтах
+size_t GlyphAtlas_GetBytes(void);
+
+// Кількість витіснених сторінок від початку роботи
+uint64_t GlyphAtlas_GetEvictionCount(void);
+
+// Текстура сторінки атласу
+Texture2D GlyphAtlas_GetTexture(int page);
+
+// Кількість створених сторінок
+int GlyphAtlas_GetPageCount(void);
+
+// Звільнення всіх сторінок атласу
+void GlyphAtlas_Unload(void);
+
+#endif // GLYPH_ATLAS_H
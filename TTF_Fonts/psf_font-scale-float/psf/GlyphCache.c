@@ -1,105 +1,297 @@
 // GlyphCache.c
 #include "GlyphCache.h"
 #include "GlyphToImage.h"
+#include "GlyphPrewarm.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 
-// Максимальна кількість одночасно кешованих шрифтів
-#define MAX_CACHED_FONTS 16
+// Дескриптор кешу: молодші 16 біт - номер слота + 1, старші 16 біт - покоління.
+// Покоління змінюється при кожній реєстрації, тож дескриптор вивантаженого шрифту
+// не спрацює для нового шрифту в тому ж слоті
+#define FONT_HANDLE_SLOT_BITS 16
+#define FONT_HANDLE_SLOT_MASK 0xFFFFu
+#define MAX_REGISTERED_FONTS  0xFFFF
 
-// Структура для зберігання кешу одного шрифту:
-// зберігає копію шрифту (щоб ідентифікувати його) та кеш гліфів
+// Запис реєстру шрифтів: кеш гліфів одного шрифту
 typedef struct {
-    PSF_Font font;       // Копія структури шрифту (для порівняння та пошуку)
-    GlyphCache cache;    // Кеш гліфів для цього шрифту
+    GlyphCache cache;    // Кеш гліфів для цього шрифту (створюється при першому малюванні)
+    int glyph_count;     // Кількість гліфів шрифту
+    uint32_t handle;     // Поточний дескриптор слота (0 - слот вільний)
+    int nextFree;        // Наступний вільний слот у списку вільних (-1 - кінець)
 } FontCacheEntry;
 
-// Статичний масив кешів для різних шрифтів
-static FontCacheEntry g_fontCaches[MAX_CACHED_FONTS];
+// Реєстр шрифтів (масив росте за потреби) і список вільних слотів
+static FontCacheEntry* g_fontCaches = NULL;
+static int g_fontCacheCapacity = 0;
+static int g_fontCacheUsed = 0;       // Скільки слотів колись видавалось
+static int g_fontCacheLive = 0;       // Скільки шрифтів зареєстровано зараз
+static int g_freeSlot = -1;           // Голова списку вільних слотів
+static uint32_t g_generation = 0;     // Лічильник поколінь дескрипторів
 
-// Поточна кількість кешованих шрифтів
-static int g_fontCacheCount = 0;
+// Лічильник використань гліфів (для LRU) і лічильники вже вивантажених шрифтів
+static uint64_t g_useClock = 0;
+static GlyphCacheStats g_retiredStats = { 0 };
 
-// Ініціалізує кеш гліфів: виділяє пам’ять під масив текстур і обнуляє їх
+// Внутрішня функція: запис реєстру за дескриптором за O(1), або NULL для недійсного дескриптора
+static FontCacheEntry* GetFontEntry(uint32_t handle) {
+    int slot = (int)(handle & FONT_HANDLE_SLOT_MASK) - 1;
+    if (slot < 0 || slot >= g_fontCacheUsed) return NULL;
+    if (g_fontCaches[slot].handle != handle) return NULL;
+    return &g_fontCaches[slot];
+}
+
+// Пам’ять атласу, яку займає гліф (разом з прозорими відступами)
+static size_t GlyphRegionBytes(GlyphAtlasRegion region) {
+    return (size_t)((int)region.source.width + 2 * GLYPH_ATLAS_PADDING) *
+           (size_t)((int)region.source.height + 2 * GLYPH_ATLAS_PADDING) * GLYPH_IMAGE_BYTES_PER_PIXEL;
+}
+
+// Внутрішня функція: атлас витісняє сторінку - усі кеші забувають гліфи з неї
+static void GlyphCache_OnAtlasEvict(int page) {
+    for (int i = 0; i < g_fontCacheUsed; i++) {
+        GlyphCache* cache = &g_fontCaches[i].cache;
+        if (g_fontCaches[i].handle == 0 || !cache->glyphRegions) continue;
+
+        for (int g = 0; g < cache->glyph_count * GLYPH_SCALE_CLASS_COUNT; g++) {
+            GlyphAtlasRegion* region = &cache->glyphRegions[g];
+            if (region->page != page) continue;
+            cache->bytes -= GlyphRegionBytes(*region);
+            cache->entries--;
+            cache->evictions++;
+            region->page = -1;
+        }
+    }
+}
+
+// Внутрішня функція: витісняє найдавніше використані гліфи кешу, доки до зайнятої пам’яті
+// можна додати ще incoming байтів у межах ліміту (або доки кеш не спорожніє)
+static void GlyphCache_EvictToBudget(GlyphCache* cache, size_t incoming) {
+    while (cache->entries > 0 && cache->bytes + incoming > cache->budget) {
+        int victim = -1;
+        for (int g = 0; g < cache->glyph_count * GLYPH_SCALE_CLASS_COUNT; g++) {
+            if (cache->glyphRegions[g].page < 0) continue;
+            if (victim < 0 || cache->lastUse[g] < cache->lastUse[victim]) victim = g;
+        }
+        if (victim < 0) break;
+
+        GlyphAtlasRegion* region = &cache->glyphRegions[victim];
+        cache->bytes -= GlyphRegionBytes(*region);
+        cache->entries--;
+        cache->evictions++;
+        GlyphAtlas_Release(*region);
+        region->page = -1;
+    }
+}
+
+// Внутрішня функція: розміщує гліф у атласі з фільтром класу масштабу
+// (з витісненням давніх гліфів, якщо кеш виходить за свій ліміт)
+static int GlyphCache_PlaceGlyph(GlyphCache* cache, GlyphAtlasRegion* region, GlyphScaleClass scaleClass,
+                                 int width, int height, const void* pixels) {
+    // Звільняємо місце під новий гліф у межах ліміту шрифту
+    if (cache->budget) {
+        size_t incoming = (size_t)(width + 2 * GLYPH_ATLAS_PADDING) *
+                          (size_t)(height + 2 * GLYPH_ATLAS_PADDING) * GLYPH_IMAGE_BYTES_PER_PIXEL;
+        GlyphCache_EvictToBudget(cache, incoming);
+    }
+
+    // Вибір фільтра: чіткість при цілочисельному масштабі, згладжування при дробовому
+    int filter = (scaleClass == GLYPH_SCALE_INTEGER) ? TEXTURE_FILTER_POINT : TEXTURE_FILTER_BILINEAR;
+
+    if (!GlyphAtlas_Add(width, height, pixels, filter, region)) return 0;
+    cache->entries++;
+    cache->bytes += GlyphRegionBytes(*region);
+    return 1;
+}
+
+// Ініціалізує кеш гліфів: виділяє пам’ять під масив місць у атласі
+// (окремо для кожного класу масштабу), всі гліфи - ще не створені
 void GlyphCache_Init(GlyphCache* cache, int glyph_count) {
     if (!cache) return;
 
     cache->glyph_count = glyph_count;
+    cache->entries = 0;
+    cache->bytes = 0;
 
-    // Виділяємо пам’ять під масив текстур розміром glyph_count
-    cache->glyphTextures = (Texture2D*)calloc(glyph_count, sizeof(Texture2D));
-    if (!cache->glyphTextures) {
-        fprintf(stderr, "Помилка виділення пам’яті для glyphTextures\n");
+    // Виділяємо пам’ять під масиви місць і позначок: glyph_count на кожен клас масштабу
+    int slots = glyph_count * GLYPH_SCALE_CLASS_COUNT;
+    cache->glyphRegions = (GlyphAtlasRegion*)calloc(slots, sizeof(GlyphAtlasRegion));
+    cache->lastUse = (uint64_t*)calloc(slots, sizeof(uint64_t));
+    if (!cache->glyphRegions || !cache->lastUse) {
+        fprintf(stderr, "Помилка виділення пам’яті для glyphRegions\n");
+        free(cache->glyphRegions);
+        free(cache->lastUse);
+        cache->glyphRegions = NULL;
+        cache->lastUse = NULL;
         cache->glyph_count = 0;
+        return;
     }
+
+    for (int i = 0; i < slots; i++) cache->glyphRegions[i].page = -1;
 }
 
-// Звільняє всі текстури гліфів у кеші та очищує пам’ять
+// Звільняє пам’ять кешу і повертає місця його гліфів в атлас
 void GlyphCache_Unload(GlyphCache* cache) {
-    if (!cache || !cache->glyphTextures) return;
+    if (!cache || !cache->glyphRegions) return;
 
-    // Проходимо по всіх текстурах і звільняємо їх, якщо вони існують
-    for (int i = 0; i < cache->glyph_count; i++) {
-        if (cache->glyphTextures[i].id != 0) {
-            UnloadTexture(cache->glyphTextures[i]);
-            cache->glyphTextures[i].id = 0;
-        }
+    for (int i = 0; i < cache->glyph_count * GLYPH_SCALE_CLASS_COUNT; i++) {
+        if (cache->glyphRegions[i].page >= 0) GlyphAtlas_Release(cache->glyphRegions[i]);
     }
-
-    // Звільняємо масив текстур
-    free(cache->glyphTextures);
-    cache->glyphTextures = NULL;
+    free(cache->glyphRegions);
+    free(cache->lastUse);
+    cache->glyphRegions = NULL;
+    cache->lastUse = NULL;
     cache->glyph_count = 0;
+    cache->entries = 0;
+    cache->bytes = 0;
 }
 
-// Повертає текстуру гліфа з кешу, створює її при відсутності
-// Текстура створюється у білому кольорі (монохром), колір задається при малюванні
-Texture2D GlyphCache_GetTexture(GlyphCache* cache, PSF_Font font, int glyphIndex, float scale) {
+// Клас масштабу: цілий (піксельне повторення) або дробовий (з фільтрацією)
+GlyphScaleClass GlyphCache_GetScaleClass(float scale) {
+    return ((int)scale == scale) ? GLYPH_SCALE_INTEGER : GLYPH_SCALE_FRACTIONAL;
+}
+
+// Повертає місце гліфа в атласі, створює і завантажує гліф при відсутності
+// (з витісненням давніх гліфів, якщо кеш виходить за свій ліміт).
+// Гліф зберігається у білому кольорі (монохром), колір задається при малюванні
+GlyphAtlasRegion GlyphCache_GetGlyph(GlyphCache* cache, PSF_Font font, int glyphIndex, float scale) {
+    GlyphAtlasRegion none = { -1, { 0 } };
+    if (!cache || !cache->glyphRegions) return none;
+
     // Якщо індекс гліфа некоректний — замінюємо на пробіл (32)
-    if (!cache || glyphIndex < 0 || glyphIndex >= cache->glyph_count) glyphIndex = 32;
+    if (glyphIndex < 0 || glyphIndex >= cache->glyph_count) glyphIndex = 32;
+    if (glyphIndex >= cache->glyph_count) return none;
 
-    // Якщо текстура для цього гліфа ще не створена — створюємо
-    if (cache->glyphTextures[glyphIndex].id == 0) {
-        // Створюємо текстуру гліфа з білим кольором (WHITE)
-        cache->glyphTextures[glyphIndex] = GlyphToTexture(font, glyphIndex, scale, WHITE);
+    // Цілий і дробовий масштаб потребують різного фільтра, тож зберігаються окремо
+    GlyphScaleClass scaleClass = GlyphCache_GetScaleClass(scale);
+    int slot = scaleClass * cache->glyph_count + glyphIndex;
+
+    GlyphAtlasRegion* region = &cache->glyphRegions[slot];
+    cache->lastUse[slot] = ++g_useClock;
+    if (region->page >= 0) {
+        cache->hits++;
+        GlyphAtlas_Touch(region->page);
+        return *region;
     }
+    cache->misses++;
+
+    Image img = GlyphToImage(font, glyphIndex);
+    GlyphCache_PlaceGlyph(cache, region, scaleClass, img.width, img.height, img.data);
+    UnloadImage(img);
 
-    // Повертаємо текстуру з кешу
-    return cache->glyphTextures[glyphIndex];
+    return *region;
 }
 
-// Малює текстуру гліфа з масштабуванням і заданим кольором
-void DrawPSFCharScaledTexture(Texture2D tex, int x, int y, float scale, Color color) {
-    Rectangle sourceRec = { 0.0f, 0.0f, (float)tex.width, (float)tex.height };
-    Rectangle destRec = { (float)x, (float)y, tex.width * scale, tex.height * scale };
+// Кладе готовий (вже розгорнутий у GLYPH_IMAGE_FORMAT) гліф у кеш шрифту з дескриптором handle.
+// Використовується фоновим прогрівом; повертає 1, якщо гліф додано
+int GlyphCache_StoreGlyph(uint32_t handle, int glyphIndex, GlyphScaleClass scaleClass,
+                          int width, int height, const void* pixels) {
+    FontCacheEntry* entry = GetFontEntry(handle);
+    if (!entry || glyphIndex < 0 || glyphIndex >= entry->glyph_count) return 0;
+
+    GlyphCache* cache = &entry->cache;
+    if (!cache->glyphRegions) GlyphCache_Init(cache, entry->glyph_count);
+    if (!cache->glyphRegions) return 0;
+
+    int slot = scaleClass * cache->glyph_count + glyphIndex;
+    GlyphAtlasRegion* region = &cache->glyphRegions[slot];
+    if (region->page >= 0) return 0; // Вже намальовано раніше за прогрів
+
+    cache->lastUse[slot] = ++g_useClock;
+    return GlyphCache_PlaceGlyph(cache, region, scaleClass, width, height, pixels);
+}
+
+// Малює гліф з атласу з масштабуванням і заданим кольором
+void DrawPSFAtlasGlyph(GlyphAtlasRegion region, int x, int y, float scale, Color color) {
+    if (region.page < 0) return;
+
+    Rectangle destRec = { (float)x, (float)y, region.source.width * scale, region.source.height * scale };
     Vector2 origin = { 0.0f, 0.0f };
 
-    // Малюємо текстуру з переданим кольором (колір задається тут)
-    DrawTexturePro(tex, sourceRec, destRec, origin, 0.0f, color);
+    // Малюємо прямокутник атласу з переданим кольором (колір задається тут)
+    DrawTexturePro(GlyphAtlas_GetTexture(region.page), region.source, destRec, origin, 0.0f, color);
 }
 
-// Внутрішня функція пошуку кешу для конкретного шрифту за унікальним вказівником на glyphBuffer
-static GlyphCache* GetCacheForFont(PSF_Font font) {
-    // Перевіряємо, чи кеш для цього шрифту вже існує
-    for (int i = 0; i < g_fontCacheCount; i++) {
-        if (g_fontCaches[i].font.glyphBuffer == font.glyphBuffer) {
-            // Знайшли існуючий кеш — повертаємо його
-            return &g_fontCaches[i].cache;
+// Реєструє шрифт у кеші гліфів і повертає його дескриптор (0 - помилка).
+// Викликається з LoadPSFFont / LoadPSFFontMapped
+uint32_t GlyphCache_RegisterFont(const PSF_Font* font) {
+    if (!font) return 0;
+
+    int slot = g_freeSlot;
+    if (slot >= 0) {
+        g_freeSlot = g_fontCaches[slot].nextFree;
+    } else {
+        if (g_fontCacheUsed == MAX_REGISTERED_FONTS) {
+            fprintf(stderr, "Перевищено максимальну кількість шрифтів у кеші (%d)\n", MAX_REGISTERED_FONTS);
+            return 0;
+        }
+        if (g_fontCacheUsed == g_fontCacheCapacity) {
+            int newCapacity = g_fontCacheCapacity ? g_fontCacheCapacity * 2 : 16;
+            FontCacheEntry* entries = (FontCacheEntry*)realloc(g_fontCaches, newCapacity * sizeof(FontCacheEntry));
+            if (!entries) {
+                fprintf(stderr, "Помилка виділення пам’яті для реєстру шрифтів\n");
+                return 0;
+            }
+            g_fontCaches = entries;
+            g_fontCacheCapacity = newCapacity;
         }
+        slot = g_fontCacheUsed++;
     }
 
-    // Якщо кеш не знайдено, створюємо новий, якщо є вільне місце
-    if (g_fontCacheCount < MAX_CACHED_FONTS) {
-        g_fontCaches[g_fontCacheCount].font = font;
-        GlyphCache_Init(&g_fontCaches[g_fontCacheCount].cache, font.glyph_count);
-        g_fontCacheCount++;
-        return &g_fontCaches[g_fontCacheCount - 1].cache;
+    // Покоління 0 пропускаємо, щоб дескриптор ніколи не був нулем
+    g_generation = (g_generation + 1) & FONT_HANDLE_SLOT_MASK;
+    if (g_generation == 0) g_generation = 1;
+
+    FontCacheEntry* entry = &g_fontCaches[slot];
+    memset(entry, 0, sizeof(*entry));
+    entry->glyph_count = font->glyph_count;
+    entry->handle = (g_generation << FONT_HANDLE_SLOT_BITS) | (uint32_t)(slot + 1);
+    entry->nextFree = -1;
+    g_fontCacheLive++;
+
+    // Атлас повідомляє кеші шрифтів про витіснені сторінки
+    GlyphAtlas_SetEvictCallback(GlyphCache_OnAtlasEvict);
+    return entry->handle;
+}
+
+// Знімає шрифт з реєстрації: звільняє його кеш і місця в атласі, слот іде в повторне використання.
+// Викликається з UnloadPSFFont
+void GlyphCache_UnregisterFont(uint32_t handle) {
+    FontCacheEntry* entry = GetFontEntry(handle);
+    if (!entry) return;
+
+    // Робочі потоки прогріву не повинні читати гліфи шрифту після вивантаження
+    GlyphPrewarm_CancelFont(handle);
+
+    GlyphCache_Unload(&entry->cache);
+    g_retiredStats.hits += entry->cache.hits;
+    g_retiredStats.misses += entry->cache.misses;
+    g_retiredStats.evictions += entry->cache.evictions;
+    entry->handle = 0;
+    entry->nextFree = g_freeSlot;
+    g_freeSlot = (int)(entry - g_fontCaches);
+
+    // Останній шрифт вивантажено - зупиняємо прогрів і звільняємо сам реєстр
+    if (--g_fontCacheLive == 0) {
+        GlyphPrewarm_Shutdown();
+        free(g_fontCaches);
+        g_fontCaches = NULL;
+        g_fontCacheCapacity = 0;
+        g_fontCacheUsed = 0;
+        g_freeSlot = -1;
     }
+}
 
-    // Якщо кешів забагато — виводимо помилку і повертаємо NULL
-    fprintf(stderr, "Перевищено максимальну кількість кешів шрифтів (%d)\n", MAX_CACHED_FONTS);
-    return NULL;
+// Внутрішня функція: кеш гліфів шрифту за його дескриптором, створюється при першому зверненні
+static GlyphCache* GetCacheForFont(PSF_Font font) {
+    FontCacheEntry* entry = GetFontEntry(font.cacheHandle);
+    if (!entry) {
+        fprintf(stderr, "Шрифт не зареєстровано в кеші гліфів (завантажте його через LoadPSFFont)\n");
+        return NULL;
+    }
+
+    if (!entry->cache.glyphRegions) GlyphCache_Init(&entry->cache, entry->glyph_count);
+    return entry->cache.glyphRegions ? &entry->cache : NULL;
 }
 
 // Малює UTF-8 текст шрифтом PSF з динамічним кешем гліфів,
@@ -111,6 +303,8 @@ void DrawPSFText(PSF_Font font, int x, int y, const char* text, int spacing, flo
 
     int xpos = x;
     int ypos = y;
+    const char* end = text + strlen(text);
+    const char* ascii = text;
 
     while (*text) {
         // Обробка символу нового рядка
@@ -123,19 +317,20 @@ void DrawPSFText(PSF_Font font, int x, int y, const char* text, int spacing, flo
 
         uint32_t codepoint = 0;
         // Декодуємо один UTF-8 символ і отримуємо Unicode код
-        int bytes = utf8_decode(text, &codepoint);
+        int bytes = utf8_next(text, end, &ascii, &codepoint);
 
         // Знаходимо індекс гліфа для Unicode коду
-        int glyph_index = UnicodeToGlyphIndex(codepoint);
+        int glyph_index = GetPSFGlyphIndex(font, codepoint);
 
         // Якщо індекс некоректний — замінюємо на пробіл
         if (glyph_index < 0 || glyph_index >= font.glyph_count) glyph_index = 32;
 
-        // Отримуємо текстуру гліфа з кешу (монохромну)
-        Texture2D glyphTex = GlyphCache_GetTexture(cache, font, glyph_index, scale);
+        // Отримуємо місце гліфа в атласі (монохромного)
+        GlyphAtlasRegion region = GlyphCache_GetGlyph(cache, font, glyph_index, scale);
 
-        // Малюємо текстуру гліфа з потрібним кольором
-        DrawPSFCharScaledTexture(glyphTex, xpos, ypos, scale, color);
+        // Малюємо гліф з потрібним кольором; сусідні гліфи з тієї ж сторінки
+        // raylib об’єднує в один пакет
+        DrawPSFAtlasGlyph(region, xpos, ypos, scale, color);
 
         // Зсуваємо позицію по горизонталі для наступного символу
         xpos += (int)((font.glyph_width * scale) + spacing);
@@ -145,11 +340,129 @@ void DrawPSFText(PSF_Font font, int x, int y, const char* text, int spacing, flo
     }
 }
 
-// Звільняє всі кеші гліфів для всіх шрифтів
+// Чи є в гліфі хоч один встановлений піксель
+static int GlyphHasPixels(PSF_Font font, int glyphIndex) {
+    const unsigned char* glyph = font.glyphBuffer + glyphIndex * font.glyph_bytes;
+    for (int i = 0; i < font.glyph_bytes; i++) {
+        if (glyph[i]) return 1;
+    }
+    return 0;
+}
+
+GlyphRun CreatePSFGlyphRun(PSF_Font font, const char* text, int spacing, float scale) {
+    GlyphRun run = { 0 };
+    run.font = font;
+    run.scale = scale;
+
+    int maxGlyphs = utf8_strlen(text);
+    if (maxGlyphs <= 0) return run;
+    run.glyphs = (GlyphRunGlyph*)malloc(maxGlyphs * sizeof(GlyphRunGlyph));
+    if (!run.glyphs) {
+        fprintf(stderr, "Помилка виділення пам’яті для GlyphRun\n");
+        return run;
+    }
+
+    // Ті самі позиції, що й у DrawPSFText, але від (0, 0)
+    int xpos = 0;
+    int ypos = 0;
+    const char* end = text + strlen(text);
+    const char* ascii = text;
+    while (*text) {
+        if (*text == '\n') {
+            xpos = 0;
+            ypos += (int)((font.glyph_height * scale) + spacing);
+            text++;
+            continue;
+        }
+
+        uint32_t codepoint = 0;
+        int bytes = utf8_next(text, end, &ascii, &codepoint);
+        int glyph_index = GetPSFGlyphIndex(font, codepoint);
+        if (glyph_index < 0 || glyph_index >= font.glyph_count) glyph_index = 32;
+
+        // Порожні гліфи лише зсувають позицію
+        if (glyph_index < font.glyph_count && GlyphHasPixels(font, glyph_index)) {
+            GlyphRunGlyph* placed = &run.glyphs[run.count++];
+            placed->glyph = glyph_index;
+            placed->x = xpos;
+            placed->y = ypos;
+        }
+
+        xpos += (int)((font.glyph_width * scale) + spacing);
+        text += bytes;
+    }
+    return run;
+}
+
+void UnloadPSFGlyphRun(GlyphRun run) {
+    free(run.glyphs);
+}
+
+void DrawPSFGlyphRun(const GlyphRun* run, int x, int y, Color color) {
+    GlyphCache* cache = GetCacheForFont(run->font);
+    if (!cache) return;
+
+    for (int i = 0; i < run->count; i++) {
+        const GlyphRunGlyph* placed = &run->glyphs[i];
+        GlyphAtlasRegion region = GlyphCache_GetGlyph(cache, run->font, placed->glyph, run->scale);
+        DrawPSFAtlasGlyph(region, x + placed->x, y + placed->y, run->scale, color);
+    }
+}
+
+// Звільняє всі кеші гліфів для всіх шрифтів і сторінки атласу.
+// Шрифти лишаються зареєстрованими: гліфи будуть створені знову при наступному малюванні
 void GlyphCache_ClearAllCaches(void) {
-    for (int i = 0; i < g_fontCacheCount; i++) {
-        GlyphCache_Unload(&g_fontCaches[i].cache);
+    for (int i = 0; i < g_fontCacheUsed; i++) {
+        if (g_fontCaches[i].handle != 0) GlyphCache_Unload(&g_fontCaches[i].cache);
     }
-    g_fontCacheCount = 0;
+    GlyphAtlas_Unload();
 }
 
+void GlyphCache_SetBudget(size_t bytes) {
+    GlyphAtlas_SetBudget(bytes);
+}
+
+void GlyphCache_SetFontBudget(PSF_Font font, size_t bytes) {
+    FontCacheEntry* entry = GetFontEntry(font.cacheHandle);
+    if (!entry) return;
+
+    entry->cache.budget = bytes;
+    // Новий ліміт менший за зайняте - витісняємо зайве одразу
+    if (bytes && entry->cache.glyphRegions) GlyphCache_EvictToBudget(&entry->cache, 0);
+}
+
+// Внутрішня функція: статистика одного кешу
+static GlyphCacheStats GetCacheStats(const GlyphCache* cache) {
+    GlyphCacheStats stats = { 0 };
+    stats.bytes = cache->bytes;
+    stats.entries = cache->entries;
+    stats.hits = cache->hits;
+    stats.misses = cache->misses;
+    stats.evictions = cache->evictions;
+    return stats;
+}
+
+GlyphCacheStats GlyphCache_GetStats(void) {
+    // Лічильники звернень включають і вже вивантажені шрифти
+    GlyphCacheStats stats = g_retiredStats;
+    for (int i = 0; i < g_fontCacheUsed; i++) {
+        if (g_fontCaches[i].handle == 0) continue;
+        GlyphCacheStats one = GetCacheStats(&g_fontCaches[i].cache);
+        stats.bytes += one.bytes;
+        stats.entries += one.entries;
+        stats.hits += one.hits;
+        stats.misses += one.misses;
+        stats.evictions += one.evictions;
+    }
+    stats.atlasBytes = GlyphAtlas_GetBytes();
+    stats.atlasPages = GlyphAtlas_GetPageCount();
+    stats.pageEvictions = GlyphAtlas_GetEvictionCount();
+    return stats;
+}
+
+GlyphCacheStats GlyphCache_GetFontStats(PSF_Font font) {
+    GlyphCacheStats stats = { 0 };
+    FontCacheEntry* entry = GetFontEntry(font.cacheHandle);
+    if (entry) stats = GetCacheStats(&entry->cache);
+    return stats;
+}
@@ -5,32 +5,115 @@
 #include "raylib.h"
 #include <stdint.h>
 #include "psf_font.h"  // Структура PSF_Font
+#include "GlyphAtlas.h" // Спільний атлас текстур гліфів
 
-// Структура кешу текстур гліфів
+// Клас масштабу гліфа: від нього залежить фільтр текстури, тому кожен клас
+// має власну копію гліфа в атласі
+typedef enum {
+    GLYPH_SCALE_INTEGER = 0,    // Цілий масштаб: повторення пікселів (TEXTURE_FILTER_POINT)
+    GLYPH_SCALE_FRACTIONAL,     // Дробовий масштаб: згладжування (TEXTURE_FILTER_BILINEAR)
+    GLYPH_SCALE_CLASS_COUNT
+} GlyphScaleClass;
+
+// Структура кешу гліфів шрифту: гліфи лежать у спільному атласі,
+// кеш лише пам’ятає, де саме
 typedef struct {
-    Texture2D* glyphTextures;  // Масив текстур гліфів
-    int glyph_count;           // Кількість гліфів (розмір масиву)
+    GlyphAtlasRegion* glyphRegions; // Місце гліфа в атласі для кожного класу масштабу:
+                                    // [клас * glyph_count + індекс] (page == -1 - ще не створено)
+    uint64_t* lastUse;              // Позначка останнього використання кожного місця (для LRU)
+    int glyph_count;                // Кількість гліфів шрифту
+    int entries;                    // Кількість гліфів, що зараз лежать в атласі
+    size_t bytes;                   // Пам’ять атласу, зайнята гліфами кешу (з відступами)
+    size_t budget;                  // Ліміт bytes (0 - без обмеження), переживає перестворення кешу
+    uint64_t hits, misses, evictions; // Лічильники звернень і витіснень
 } GlyphCache;
 
-// Ініціалізація кешу (виділення пам’яті, обнулення)
+// Гліф заздалегідь розібраного тексту (GlyphRun)
+typedef struct {
+    int glyph;      // Індекс гліфа в шрифті
+    int x, y;       // Зсув від початку тексту (з масштабом)
+} GlyphRunGlyph;
+
+// Текст, розібраний один раз (CreatePSFGlyphRun), для незмінних підписів, які малюються кожен кадр.
+// Місця гліфів в атласі не запам’ятовуються: атлас може їх витіснити, тож вони беруться з кешу
+typedef struct {
+    PSF_Font font;              // Копія опису шрифту
+    float scale;                // Масштаб
+    GlyphRunGlyph* glyphs;      // Гліфи для малювання (порожні гліфи, як пробіл, пропущено)
+    int count;                  // Кількість гліфів
+} GlyphRun;
+
+// Статистика кешу гліфів
+typedef struct {
+    size_t bytes;           // Пам’ять, зайнята гліфами (з відступами)
+    int entries;            // Кількість гліфів в атласі
+    uint64_t hits;          // Гліф знайдено в кеші
+    uint64_t misses;        // Гліф довелося створити
+    uint64_t evictions;     // Витіснено гліфів (через ліміт шрифту або разом зі сторінкою атласу)
+    size_t atlasBytes;      // Пам’ять усіх сторінок атласу (лише в загальній статистиці)
+    int atlasPages;         // Кількість сторінок атласу (лише в загальній статистиці)
+    uint64_t pageEvictions; // Витіснено сторінок атласу (лише в загальній статистиці)
+} GlyphCacheStats;
+
+// Ініціалізація кешу (виділення пам’яті, обнулення; ліміт і лічильники не змінюються)
 void GlyphCache_Init(GlyphCache* cache, int glyph_count);
 
-// Звільнення ресурсів кешу (текстур і пам’яті)
+// Звільнення пам’яті кешу з поверненням місць його гліфів в атлас
 void GlyphCache_Unload(GlyphCache* cache);
 
-// Отримання текстури гліфа з кешу, створення при відсутності
-Texture2D GlyphCache_GetTexture(GlyphCache* cache, PSF_Font font, int glyphIndex, float scale);
+// Клас масштабу для scale
+GlyphScaleClass GlyphCache_GetScaleClass(float scale);
+
+// Отримання місця гліфа в атласі для класу масштабу scale, створення і завантаження при відсутності
+GlyphAtlasRegion GlyphCache_GetGlyph(GlyphCache* cache, PSF_Font font, int glyphIndex, float scale);
+
+// Додавання готового гліфа (GLYPH_IMAGE_FORMAT width x height) у кеш шрифту handle, якщо його там ще немає.
+// Викликається з потоку малювання (GlyphPrewarm_Update), повертає 1, якщо гліф додано
+int GlyphCache_StoreGlyph(uint32_t handle, int glyphIndex, GlyphScaleClass scaleClass,
+                          int width, int height, const void* pixels);
 
-// Малювання текстури гліфа з масштабуванням і кольором
-void DrawPSFCharScaledTexture(Texture2D tex, int x, int y, float scale, Color color);
+// Малювання гліфа з атласу з масштабуванням і кольором
+void DrawPSFAtlasGlyph(GlyphAtlasRegion region, int x, int y, float scale, Color color);
 
-// Малювання UTF-8 тексту з динамічним кешем текстур гліфів,
-// який підтримує одночасну роботу з багатьма шрифтами
+// Малювання UTF-8 тексту з динамічним кешем гліфів, який підтримує одночасну
+// роботу з багатьма шрифтами. Гліфи одного рядка беруться з однієї текстури атласу,
+// тому raylib малює рядок одним пакетом
 void DrawPSFText(PSF_Font font, int x, int y, const char* text, int spacing, float scale, Color color);
 
-// Звільнення всіх кешів, створених для різних шрифтів
+// Розбір тексту в GlyphRun (з '\n'): UTF-8 декодується і гліфи шукаються один раз,
+// малюється так само, як DrawPSFText. Дійсний до UnloadPSFFont шрифту
+GlyphRun CreatePSFGlyphRun(PSF_Font font, const char* text, int spacing, float scale);
+
+// Звільнення пам’яті GlyphRun
+void UnloadPSFGlyphRun(GlyphRun run);
+
+// Малювання GlyphRun з лівим верхнім кутом у (x, y) гліфами з кешу
+void DrawPSFGlyphRun(const GlyphRun* run, int x, int y, Color color);
+
+// Реєстрація шрифту в кеші: повертає стабільний дескриптор для PSF_Font.cacheHandle
+// (викликається при завантаженні шрифту), 0 - помилка
+uint32_t GlyphCache_RegisterFont(const PSF_Font* font);
+
+// Зняття шрифту з реєстрації зі звільненням його гліфів (викликається з UnloadPSFFont)
+void GlyphCache_UnregisterFont(uint32_t handle);
+
+// Звільнення всіх кешів, створених для різних шрифтів, і сторінок атласу
 void GlyphCache_ClearAllCaches(void);
 
+// Загальний ліміт пам’яті атласу в байтах (0 - без обмеження).
+// При перевищенні витісняються найдавніше використані сторінки атласу
+void GlyphCache_SetBudget(size_t bytes);
+
+// Ліміт пам’яті гліфів одного шрифту в байтах (0 - без обмеження).
+// При перевищенні витісняються найдавніше використані гліфи цього шрифту
+void GlyphCache_SetFontBudget(PSF_Font font, size_t bytes);
+
+// Загальна статистика всіх кешів і атласу
+GlyphCacheStats GlyphCache_GetStats(void);
+
+// Статистика кешу одного шрифту
+GlyphCacheStats GlyphCache_GetFontStats(PSF_Font font);
+
 
 #endif // GLYPH_CACHE_H
 
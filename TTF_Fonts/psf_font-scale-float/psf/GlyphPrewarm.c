@@ -0,0 +1,292 @@
+// GlyphPrewarm.c
+#include "GlyphPrewarm.h"
+#include "GlyphToImage.h"
+#include <pthread.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+// Завдання прогріву: до GLYPH_PREWARM_CHUNK гліфів одного шрифту і класу масштабу
+typedef struct GlyphPrewarmTask {
+    uint32_t handle;                    // Дескриптор кешу шрифту
+    PSF_Font font;                      // Копія опису шрифту (гліфи живуть до UnloadPSFFont)
+    GlyphScaleClass scaleClass;         // Клас масштабу, для якого гліфи кладуться в атлас
+    int glyphs[GLYPH_PREWARM_CHUNK];    // Індекси гліфів
+    int count;                          // Кількість гліфів у завданні
+    int uploaded;                       // Скільки вже завантажено в атлас (потік малювання)
+    uint8_t* pixels;                    // Розгорнуті гліфи підряд (GLYPH_IMAGE_FORMAT)
+    struct GlyphPrewarmTask* next;      // Наступне завдання в черзі
+} GlyphPrewarmTask;
+
+// Черга завдань (FIFO)
+typedef struct {
+    GlyphPrewarmTask* head;
+    GlyphPrewarmTask* tail;
+} GlyphPrewarmQueue;
+
+// Стан прогріву. Черги, g_busy і g_remaining захищені g_lock
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_workAvailable = PTHREAD_COND_INITIALIZER; // З’явилось завдання або зупинка
+static pthread_cond_t g_workDone = PTHREAD_COND_INITIALIZER;      // Робочий потік завершив завдання
+static pthread_t g_threads[GLYPH_PREWARM_MAX_THREADS];
+static int g_threadCount = 0;
+static int g_stop = 0;
+static GlyphPrewarmQueue g_pending = { 0 };             // Чекають розгортання
+static GlyphPrewarmQueue g_ready = { 0 };               // Розгорнуті, чекають завантаження
+static uint32_t g_busy[GLYPH_PREWARM_MAX_THREADS];      // Шрифт, який зараз розгортає потік (0 - вільний)
+static int g_remaining = 0;                             // Гліфи, ще не завантажені в атлас
+
+// Завдання, яке зараз завантажується (належить лише потоку малювання)
+static GlyphPrewarmTask* g_uploading = NULL;
+
+static void GlyphPrewarm_Push(GlyphPrewarmQueue* queue, GlyphPrewarmTask* task) {
+    task->next = NULL;
+    if (queue->tail) queue->tail->next = task;
+    else queue->head = task;
+    queue->tail = task;
+}
+
+static GlyphPrewarmTask* GlyphPrewarm_Pop(GlyphPrewarmQueue* queue) {
+    GlyphPrewarmTask* task = queue->head;
+    if (!task) return NULL;
+    queue->head = task->next;
+    if (!queue->head) queue->tail = NULL;
+    return task;
+}
+
+static void GlyphPrewarm_FreeTask(GlyphPrewarmTask* task) {
+    free(task->pixels);
+    free(task);
+}
+
+// Видаляє з черги завдання шрифту handle (handle == 0 - всі), повертає кількість
+// ще не завантажених гліфів у видалених завданнях
+static int GlyphPrewarm_RemoveFont(GlyphPrewarmQueue* queue, uint32_t handle) {
+    int removed = 0;
+    GlyphPrewarmTask* kept = NULL;
+    GlyphPrewarmTask* keptTail = NULL;
+
+    for (GlyphPrewarmTask* task = queue->head; task; ) {
+        GlyphPrewarmTask* next = task->next;
+        if (handle == 0 || task->handle == handle) {
+            removed += task->count - task->uploaded;
+            GlyphPrewarm_FreeTask(task);
+        } else {
+            task->next = NULL;
+            if (keptTail) keptTail->next = task;
+            else kept = task;
+            keptTail = task;
+        }
+        task = next;
+    }
+    queue->head = kept;
+    queue->tail = keptTail;
+    return removed;
+}
+
+// Робочий потік: бере завдання з g_pending, розгортає гліфи і кладе результат у g_ready
+static void* GlyphPrewarm_Worker(void* arg) {
+    int id = (int)(intptr_t)arg;
+
+    pthread_mutex_lock(&g_lock);
+    for (;;) {
+        while (!g_stop && !g_pending.head) pthread_cond_wait(&g_workAvailable, &g_lock);
+        if (g_stop) break;
+
+        GlyphPrewarmTask* task = GlyphPrewarm_Pop(&g_pending);
+        g_busy[id] = task->handle;
+        pthread_mutex_unlock(&g_lock);
+
+        // Розгортання - без блокування, гліфи шрифту читаються лише для читання
+        int stride = task->font.glyph_width * GLYPH_IMAGE_BYTES_PER_PIXEL;
+        size_t glyphBytes = (size_t)stride * task->font.glyph_height;
+        task->pixels = (uint8_t*)malloc(task->count * glyphBytes);
+        if (task->pixels) {
+            for (int i = 0; i < task->count; i++) {
+                GlyphToGrayAlpha(&task->font, task->glyphs[i], task->pixels + i * glyphBytes, stride);
+            }
+        }
+
+        pthread_mutex_lock(&g_lock);
+        if (task->pixels) {
+            GlyphPrewarm_Push(&g_ready, task);
+        } else {
+            fprintf(stderr, "Помилка виділення пам’яті для прогріву гліфів\n");
+            g_remaining -= task->count;
+            GlyphPrewarm_FreeTask(task);
+        }
+        g_busy[id] = 0;
+        pthread_cond_broadcast(&g_workDone);
+    }
+    pthread_mutex_unlock(&g_lock);
+    return NULL;
+}
+
+// Запускає робочі потоки при першому прогріві: по одному на ядро, крім ядра потоку малювання
+static int GlyphPrewarm_StartThreads(void) {
+    if (g_threadCount > 0) return 1;
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int wanted = (cpus > 1) ? (int)(cpus - 1) : 1;
+    if (wanted > GLYPH_PREWARM_MAX_THREADS) wanted = GLYPH_PREWARM_MAX_THREADS;
+
+    for (int i = 0; i < wanted; i++) {
+        g_busy[i] = 0;
+        if (pthread_create(&g_threads[i], NULL, GlyphPrewarm_Worker, (void*)(intptr_t)i) != 0) break;
+        g_threadCount++;
+    }
+    if (g_threadCount == 0) {
+        fprintf(stderr, "Не вдалося запустити потоки прогріву гліфів\n");
+        return 0;
+    }
+    return 1;
+}
+
+// Ставить у чергу гліфи glyphs[count] шрифту font, розбиваючи їх на завдання
+static int GlyphPrewarm_Submit(PSF_Font font, const int* glyphs, int count, float scale) {
+    if (font.cacheHandle == 0 || count <= 0) return 0;
+    if (!GlyphPrewarm_StartThreads()) return 0;
+
+    GlyphScaleClass scaleClass = GlyphCache_GetScaleClass(scale);
+    int queued = 0;
+
+    pthread_mutex_lock(&g_lock);
+    for (int start = 0; start < count; start += GLYPH_PREWARM_CHUNK) {
+        GlyphPrewarmTask* task = (GlyphPrewarmTask*)calloc(1, sizeof(GlyphPrewarmTask));
+        if (!task) {
+            fprintf(stderr, "Помилка виділення пам’яті для прогріву гліфів\n");
+            break;
+        }
+        task->handle = font.cacheHandle;
+        task->font = font;
+        task->scaleClass = scaleClass;
+        task->count = (count - start < GLYPH_PREWARM_CHUNK) ? count - start : GLYPH_PREWARM_CHUNK;
+        memcpy(task->glyphs, glyphs + start, task->count * sizeof(int));
+        GlyphPrewarm_Push(&g_pending, task);
+        queued += task->count;
+    }
+    g_remaining += queued;
+    pthread_cond_broadcast(&g_workAvailable);
+    pthread_mutex_unlock(&g_lock);
+
+    return queued;
+}
+
+int GlyphPrewarm_Font(PSF_Font font, float scale) {
+    if (font.glyph_count <= 0) return 0;
+
+    int* glyphs = (int*)malloc(font.glyph_count * sizeof(int));
+    if (!glyphs) return 0;
+    for (int i = 0; i < font.glyph_count; i++) glyphs[i] = i;
+
+    int queued = GlyphPrewarm_Submit(font, glyphs, font.glyph_count, scale);
+    free(glyphs);
+    return queued;
+}
+
+int GlyphPrewarm_Codepoints(PSF_Font font, const uint32_t* codepoints, int count, float scale) {
+    if (!codepoints || count <= 0 || font.glyph_count <= 0) return 0;
+
+    // Різні коди можуть вказувати на один гліф - кожен гліф ставимо в чергу один раз
+    unsigned char* seen = (unsigned char*)calloc(font.glyph_count, 1);
+    int* glyphs = (int*)malloc(count * sizeof(int));
+    if (!seen || !glyphs) {
+        free(seen);
+        free(glyphs);
+        return 0;
+    }
+
+    int unique = 0;
+    for (int i = 0; i < count; i++) {
+        int glyph = GetPSFGlyphIndex(font, codepoints[i]);
+        if (glyph < 0 || glyph >= font.glyph_count || seen[glyph]) continue;
+        seen[glyph] = 1;
+        glyphs[unique++] = glyph;
+    }
+
+    int queued = GlyphPrewarm_Submit(font, glyphs, unique, scale);
+    free(seen);
+    free(glyphs);
+    return queued;
+}
+
+int GlyphPrewarm_Update(int maxGlyphs) {
+    int done = 0;      // Оброблено гліфів (включно з тими, що вже були в кеші)
+    int uploaded = 0;  // Реально завантажено в атлас
+
+    while (uploaded < maxGlyphs) {
+        if (!g_uploading) {
+            pthread_mutex_lock(&g_lock);
+            g_uploading = GlyphPrewarm_Pop(&g_ready);
+            pthread_mutex_unlock(&g_lock);
+            if (!g_uploading) break;
+        }
+
+        GlyphPrewarmTask* task = g_uploading;
+        size_t glyphBytes = (size_t)task->font.glyph_width * task->font.glyph_height * GLYPH_IMAGE_BYTES_PER_PIXEL;
+        while (task->uploaded < task->count && uploaded < maxGlyphs) {
+            uploaded += GlyphCache_StoreGlyph(task->handle, task->glyphs[task->uploaded], task->scaleClass,
+                                              task->font.glyph_width, task->font.glyph_height,
+                                              task->pixels + task->uploaded * glyphBytes);
+            task->uploaded++;
+            done++;
+        }
+
+        if (task->uploaded == task->count) {
+            GlyphPrewarm_FreeTask(task);
+            g_uploading = NULL;
+        }
+    }
+
+    pthread_mutex_lock(&g_lock);
+    g_remaining -= done;
+    int remaining = g_remaining;
+    pthread_mutex_unlock(&g_lock);
+    return remaining;
+}
+
+void GlyphPrewarm_CancelFont(uint32_t handle) {
+    if (handle == 0) return;
+
+    pthread_mutex_lock(&g_lock);
+    g_remaining -= GlyphPrewarm_RemoveFont(&g_pending, handle);
+
+    // Чекаємо потоки, які зараз розгортають гліфи цього шрифту; їх результат
+    // потрапить у g_ready і буде видалений нижче
+    for (;;) {
+        int busy = 0;
+        for (int i = 0; i < g_threadCount; i++) {
+            if (g_busy[i] == handle) busy = 1;
+        }
+        if (!busy) break;
+        pthread_cond_wait(&g_workDone, &g_lock);
+    }
+
+    g_remaining -= GlyphPrewarm_RemoveFont(&g_ready, handle);
+    if (g_uploading && g_uploading->handle == handle) {
+        g_remaining -= g_uploading->count - g_uploading->uploaded;
+        GlyphPrewarm_FreeTask(g_uploading);
+        g_uploading = NULL;
+    }
+    pthread_mutex_unlock(&g_lock);
+}
+
+void GlyphPrewarm_Shutdown(void) {
+    pthread_mutex_lock(&g_lock);
+    g_stop = 1;
+    pthread_cond_broadcast(&g_workAvailable);
+    pthread_mutex_unlock(&g_lock);
+
+    for (int i = 0; i < g_threadCount; i++) pthread_join(g_threads[i], NULL);
+    g_threadCount = 0;
+
+    GlyphPrewarm_RemoveFont(&g_pending, 0);
+    GlyphPrewarm_RemoveFont(&g_ready, 0);
+    if (g_uploading) {
+        GlyphPrewarm_FreeTask(g_uploading);
+        g_uploading = NULL;
+    }
+    g_remaining = 0;
+    g_stop = 0;
+}
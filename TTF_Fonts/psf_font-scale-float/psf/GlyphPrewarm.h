@@ -0,0 +1,41 @@
+// GlyphPrewarm.h
+#ifndef GLYPH_PREWARM_H
+#define GLYPH_PREWARM_H
+
+#include "raylib.h"
+#include <stdint.h>
+#include "psf_font.h"
+#include "GlyphCache.h"
+
+// Кількість гліфів в одному завданні робочого потоку
+#define GLYPH_PREWARM_CHUNK 64
+
+// Максимальна кількість робочих потоків прогріву
+#define GLYPH_PREWARM_MAX_THREADS 4
+
+// Фоновий прогрів кешу гліфів: робочі потоки розгортають гліфи у буфери GRAY_ALPHA
+// в оперативній пам’яті, а потік малювання завантажує готові гліфи в атлас
+// невеликими порціями (GlyphPrewarm_Update раз на кадр), тож поява нового шрифту
+// чи масштабу не зупиняє кадр.
+// Шрифт має бути завантажений через LoadPSFFont / LoadPSFFontMapped;
+// UnloadPSFFont сам скасовує його незавершений прогрів
+
+// Прогрів усіх гліфів шрифту для масштабу scale (від нього залежить клас масштабу).
+// Повертає кількість поставлених у чергу гліфів
+int GlyphPrewarm_Font(PSF_Font font, float scale);
+
+// Прогрів гліфів для набору Unicode кодів (наприклад, алфавіту інтерфейсу)
+int GlyphPrewarm_Codepoints(PSF_Font font, const uint32_t* codepoints, int count, float scale);
+
+// Завантаження в атлас не більше maxGlyphs готових гліфів (викликається з потоку малювання
+// раз на кадр). Повертає кількість гліфів, що ще чекають розгортання або завантаження
+int GlyphPrewarm_Update(int maxGlyphs);
+
+// Скасування прогріву шрифту з дескриптором handle з очікуванням робочих потоків,
+// які зараз читають його гліфи
+void GlyphPrewarm_CancelFont(uint32_t handle);
+
+// Скасування всього прогріву і зупинка робочих потоків
+void GlyphPrewarm_Shutdown(void);
+
+#endif // GLYPH_PREWARM_H
@@ -1,34 +1,99 @@
 // GlyphToImage.c
 #include "GlyphToImage.h"
+#include <string.h>
 
-// Створює Image з гліфа PSF з заданим кольором
-Image GlyphToImage(PSF_Font font, int glyphIndex, Color color) {
-    int glyph_width = font.glyph_width;
-    int glyph_height = font.glyph_height;
-    int bytes_per_row = (glyph_width + 7) / 8;
-    unsigned char* glyph = font.glyphBuffer + glyphIndex * font.glyph_bytes;
+// Чотири пікселі GRAY_ALPHA для кожного значення півбайта гліфа (старший біт - лівий піксель)
+#define GA_OFF 0xFF, 0x00
+#define GA_ON  0xFF, 0xFF
+static const uint8_t g_nibblePixels[16][8] = {
+    { GA_OFF, GA_OFF, GA_OFF, GA_OFF }, { GA_OFF, GA_OFF, GA_OFF, GA_ON  },
+    { GA_OFF, GA_OFF, GA_ON,  GA_OFF }, { GA_OFF, GA_OFF, GA_ON,  GA_ON  },
+    { GA_OFF, GA_ON,  GA_OFF, GA_OFF }, { GA_OFF, GA_ON,  GA_OFF, GA_ON  },
+    { GA_OFF, GA_ON,  GA_ON,  GA_OFF }, { GA_OFF, GA_ON,  GA_ON,  GA_ON  },
+    { GA_ON,  GA_OFF, GA_OFF, GA_OFF }, { GA_ON,  GA_OFF, GA_OFF, GA_ON  },
+    { GA_ON,  GA_OFF, GA_ON,  GA_OFF }, { GA_ON,  GA_OFF, GA_ON,  GA_ON  },
+    { GA_ON,  GA_ON,  GA_OFF, GA_OFF }, { GA_ON,  GA_ON,  GA_OFF, GA_ON  },
+    { GA_ON,  GA_ON,  GA_ON,  GA_OFF }, { GA_ON,  GA_ON,  GA_ON,  GA_ON  },
+};
+#undef GA_OFF
+#undef GA_ON
 
-    Image img = GenImageColor(glyph_width, glyph_height, BLANK);
+// Розгортає гліф PSF у маску GRAY_ALPHA: кожен байт рядка гліфа дає 8 пікселів
+// двома копіюваннями з таблиці, неповний останній байт - копіюється лише його частина
+void GlyphToGrayAlpha(const PSF_Font* font, int glyphIndex, uint8_t* dst, int dstStride) {
+    int glyph_width = font->glyph_width;
+    int glyph_height = font->glyph_height;
+    int bytes_per_row = (glyph_width + 7) / 8;
+    int full_bytes = glyph_width / 8;
+    int tail_pixels = glyph_width % 8;
+    const unsigned char* glyph = font->glyphBuffer + glyphIndex * font->glyph_bytes;
 
     for (int y = 0; y < glyph_height; y++) {
-        for (int byte = 0; byte < bytes_per_row; byte++) {
-            unsigned char bits = glyph[y * bytes_per_row + byte];
-            for (int bit = 0; bit < 8; bit++) {
-                int x = byte * 8 + bit;
-                if (x >= glyph_width) break;
-                if (bits & (0x80 >> bit)) {
-                    // Малюємо білим кольором (255,255,255,255) - альфа маска
-                    ImageDrawPixel(&img, x, y, WHITE);
-                }
-            }
+        const unsigned char* bits = glyph + y * bytes_per_row;
+        uint8_t* row = dst + y * dstStride;
+
+        for (int byte = 0; byte < full_bytes; byte++) {
+            memcpy(row, g_nibblePixels[bits[byte] >> 4], 8);
+            memcpy(row + 8, g_nibblePixels[bits[byte] & 0x0F], 8);
+            row += 16;
+        }
+        if (tail_pixels) {
+            uint8_t last[16];
+            memcpy(last, g_nibblePixels[bits[full_bytes] >> 4], 8);
+            memcpy(last + 8, g_nibblePixels[bits[full_bytes] & 0x0F], 8);
+            memcpy(row, last, tail_pixels * GLYPH_IMAGE_BYTES_PER_PIXEL);
         }
     }
+}
+
+// Створює Image з гліфа PSF (біла маска GRAY_ALPHA)
+Image GlyphToImage(PSF_Font font, int glyphIndex) {
+    Image img = { 0 };
+    int stride = font.glyph_width * GLYPH_IMAGE_BYTES_PER_PIXEL;
+
+    img.data = MemAlloc(stride * font.glyph_height);
+    if (!img.data) return img;
+    img.width = font.glyph_width;
+    img.height = font.glyph_height;
+    img.mipmaps = 1;
+    img.format = GLYPH_IMAGE_FORMAT;
+
+    GlyphToGrayAlpha(&font, glyphIndex, (uint8_t*)img.data, stride);
     return img;
 }
 
-// Конвертує Image у Texture2D з вибором фільтра залежно від масштабу
-Texture2D GlyphToTexture(PSF_Font font, int glyphIndex, float scale, Color color) {
-    Image img = GlyphToImage(font, glyphIndex, color);
+// Створює зображення з усіма гліфами шрифту, розкладеними сіткою
+Image FontToImage(PSF_Font font, int columns) {
+    Image img = { 0 };
+    if (columns <= 0 || font.glyph_count <= 0) return img;
+
+    int rows = (font.glyph_count + columns - 1) / columns;
+    int stride = columns * font.glyph_width * GLYPH_IMAGE_BYTES_PER_PIXEL;
+
+    img.data = MemAlloc(stride * rows * font.glyph_height);
+    if (!img.data) return img;
+    img.width = columns * font.glyph_width;
+    img.height = rows * font.glyph_height;
+    img.mipmaps = 1;
+    img.format = GLYPH_IMAGE_FORMAT;
+
+    // Порожні клітинки останнього рядка - білі й прозорі (255, 0), як фон атласу (GlyphAtlas):
+    // чорні прозорі пікселі BILINEAR підмішував би до країв сусідніх гліфів
+    uint8_t* data = (uint8_t*)img.data;
+    size_t pixels = (size_t)img.width * img.height;
+    for (size_t i = 0; i < pixels; i++) data[i * 2] = 0xFF;
+
+    for (int i = 0; i < font.glyph_count; i++) {
+        uint8_t* cell = (uint8_t*)img.data + (i / columns) * font.glyph_height * stride
+                      + (i % columns) * font.glyph_width * GLYPH_IMAGE_BYTES_PER_PIXEL;
+        GlyphToGrayAlpha(&font, i, cell, stride);
+    }
+    return img;
+}
+
+// Конвертує гліф у Texture2D з вибором фільтра залежно від масштабу
+Texture2D GlyphToTexture(PSF_Font font, int glyphIndex, float scale) {
+    Image img = GlyphToImage(font, glyphIndex);
     Texture2D tex = LoadTextureFromImage(img);
     UnloadImage(img);
 
@@ -41,4 +106,3 @@ Texture2D GlyphToTexture(PSF_Font font, int glyphIndex, float scale, Color color
 
     return tex;
 }
-
@@ -6,11 +6,25 @@
 #include "psf_font.h"
 #include <stdint.h>
 
-// Створює Image з одного гліфа PSF шрифту з заданим кольором
-Image GlyphToImage(PSF_Font font, int glyphIndex, Color color);
+// Формат зображень гліфів: біла маска з альфою (2 байти на піксель замість 4 у RGBA),
+// колір задається при малюванні
+#define GLYPH_IMAGE_FORMAT          PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA
+#define GLYPH_IMAGE_BYTES_PER_PIXEL 2
 
-// Конвертує Image у Texture2D з вибором фільтра залежно від масштабу
-Texture2D GlyphToTexture(PSF_Font font, int glyphIndex, float scale, Color color);
+// Розгортає гліф у маску GRAY_ALPHA: рядок y починається з dst + y * dstStride,
+// встановлені біти - (255, 255), решта - (255, 0). Рядки обробляються цілими байтами
+// через таблицю, без звернень до raylib, тому безпечно для робочих потоків
+void GlyphToGrayAlpha(const PSF_Font* font, int glyphIndex, uint8_t* dst, int dstStride);
 
-#endif // GLYPH_TO_IMAGE_H
+// Створює Image (GRAY_ALPHA) з одного гліфа PSF шрифту
+Image GlyphToImage(PSF_Font font, int glyphIndex);
+
+// Створює одне зображення (GRAY_ALPHA) з усіма гліфами шрифту в сітці по columns гліфів
+// у рядку: гліф i лежить у клітинці (i % columns, i / columns), порожні клітинки - (255, 0).
+// Для побудови атласів
+Image FontToImage(PSF_Font font, int columns);
 
+// Конвертує гліф у Texture2D з вибором фільтра залежно від масштабу
+Texture2D GlyphToTexture(PSF_Font font, int glyphIndex, float scale);
+
+#endif // GLYPH_TO_IMAGE_H
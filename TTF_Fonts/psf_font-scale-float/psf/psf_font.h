@@ -5,6 +5,7 @@
 #include "raylib.h"
 #include <stdint.h>
 #include <stddef.h>
+#include "utf8.h"
 
 // Структура шрифту PSF1/PSF2
 typedef struct {
@@ -14,12 +15,23 @@ typedef struct {
     int glyph_count;            // Кількість гліфів (символів) у шрифті
     int glyph_bytes;            // Розмір одного гліфа в байтах
     unsigned char* glyphBuffer; // Вказівник на буфер з бінарними даними гліфів
+    void* mappedData;           // Відображення файлу у пам’ять (LoadPSFFontMapped) або NULL
+    size_t mappedSize;          // Розмір відображення в байтах
+    uint16_t* unicodePageDir;   // Каталог сторінок таблиці Unicode (NULL - таблиці немає)
+    uint16_t* unicodePages;     // Сторінки по 256 індексів гліфів; сторінка 0 порожня
+    uint32_t cacheHandle;       // Дескриптор кешу гліфів (GlyphCache_RegisterFont), 0 - немає
 } PSF_Font;
 
-int utf8_decode(const char* str, uint32_t* out_codepoint);
 int UnicodeToGlyphIndex(uint32_t codepoint);
 
+// Індекс гліфа за Unicode кодом із таблиці Unicode шрифту (O(1))
+int GetPSFGlyphIndex(PSF_Font font, uint32_t codepoint);
+
 PSF_Font LoadPSFFont(const char* filename);
+
+// Завантаження PSF шрифту через mmap: гліфи не копіюються, сторінки файлу
+// спільні між процесами. Звільняється тією ж UnloadPSFFont
+PSF_Font LoadPSFFontMapped(const char* filename);
 void UnloadPSFFont(PSF_Font font);
 
 /*
@@ -0,0 +1,63 @@
+#ifndef CLIP_H
+#define CLIP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "render_target.h"
+
+// Найбільша глибина стеку прямокутників відсікання
+#define CLIP_STACK_DEPTH 32
+
+// Межа "без відсікання": далі за неї координати не бувають
+#define CLIP_UNBOUNDED (1 << 28)
+
+// Стек прямокутників відсікання. Усе малювання (DrawPixel, DrawSpans, DrawBitmapSpans
+// і все, що на них побудовано: прямокутники, лінії, гліфи, текст) обмежується
+// перетином прямокутників стеку. Координати ті самі, що й у малюванні: активної
+// цілі (BeginRenderTarget) або вікна.
+// Новий прямокутник перетинається з поточним, тож вкладене відсікання не виходить
+// за зовнішнє; кожному PushClipRect відповідає свій PopClipRect.
+// Понад CLIP_STACK_DEPTH прямокутники не губляться, а звужують спільний перетин:
+// до повернення на CLIP_STACK_DEPTH відсікання може бути вужчим, але не ширшим
+void PushClipRect(int x, int y, int width, int height);
+void PopClipRect(void);
+
+// Нова область без відсікання поверх стеку (для малювання в іншу ціль з іншими
+// координатами): доки вона діє, попередні прямокутники стеку не враховуються.
+// Повертає значення для PopClipScope, який повертає попередню область
+int PushClipScope(void);
+void PopClipScope(int scope);
+
+// Поточний прямокутник відсікання (зі стеком, що порожній, - без обмежень)
+RenderRect GetClipRect(void);
+
+// Видима область: прямокутник відсікання, обмежений активною ціллю (або вікном).
+// Порожня (x0 >= x1 або y0 >= y1), якщо малювати нікуди
+RenderRect GetVisibleRect(void);
+
+// Перетин прямокутників a і b (порожній, якщо вони не перетинаються)
+static inline RenderRect ClipRect_Intersect(RenderRect a, RenderRect b)
+{
+    RenderRect r = a;
+    if (b.x0 > r.x0) r.x0 = b.x0;
+    if (b.y0 > r.y0) r.y0 = b.y0;
+    if (b.x1 < r.x1) r.x1 = b.x1;
+    if (b.y1 < r.y1) r.y1 = b.y1;
+    return r;
+}
+
+// Чи перетинає непорожній прямокутник [x0, x1) x [y0, y1) область clip (без обчислення
+// перетину); з порожньою областю - ніколи
+static inline int ClipRect_Overlaps(RenderRect clip, int x0, int y0, int x1, int y1)
+{
+    return x0 < clip.x1 && clip.x0 < x1 && y0 < clip.y1 && clip.y0 < y1 &&
+           x0 < x1 && y0 < y1 && clip.x0 < clip.x1 && clip.y0 < clip.y1;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CLIP_H
@@ -0,0 +1,354 @@
+// damage.c
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "damage.h"
+#include "graphics.h"  // DrawRectangle, DrawRectangleLines
+#include "gfx.h"       // gfx_backbuffer, gfx_present_backbuffer_rects, gfx_put_image
+#include "clip.h"      // відсікання команд при перемальовуванні
+
+// Вирівнювання параметрів команд у буфері кадру
+#define DAMAGE_DATA_ALIGN 16
+
+static int DamageRect_Empty(RenderRect r)
+{
+    return r.x0 >= r.x1 || r.y0 >= r.y1;
+}
+
+static int DamageRect_Intersects(RenderRect a, RenderRect b)
+{
+    return a.x0 < b.x1 && b.x0 < a.x1 && a.y0 < b.y1 && b.y0 < a.y1;
+}
+
+static RenderRect DamageRect_Union(RenderRect a, RenderRect b)
+{
+    RenderRect r;
+    r.x0 = (a.x0 < b.x0) ? a.x0 : b.x0;
+    r.y0 = (a.y0 < b.y0) ? a.y0 : b.y0;
+    r.x1 = (a.x1 > b.x1) ? a.x1 : b.x1;
+    r.y1 = (a.y1 > b.y1) ? a.y1 : b.y1;
+    return r;
+}
+
+static int64_t DamageRect_Area(RenderRect r)
+{
+    return (int64_t)(r.x1 - r.x0) * (r.y1 - r.y0);
+}
+
+// FNV-1a по функції, межах і параметрах команди
+static uint64_t DamageCommand_Hash(const DamageCommand* c, const uint8_t* data)
+{
+    uint64_t hash = 1469598103934665603ULL;
+    const uint8_t* head = (const uint8_t*)c;
+    size_t headSize = offsetof(DamageCommand, draw) + sizeof(c->draw); // межі і функція
+    for (size_t i = 0; i < headSize; i++) {
+        hash ^= head[i];
+        hash *= 1099511628211ULL;
+    }
+    for (size_t i = 0; i < c->size; i++) {
+        hash ^= data[c->data + i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static int DamageCommand_Equal(const DamageCommand* a, const DamageFrame* fa,
+                               const DamageCommand* b, const DamageFrame* fb)
+{
+    return a->key == b->key && a->draw == b->draw && a->size == b->size &&
+           a->bounds.x0 == b->bounds.x0 && a->bounds.y0 == b->bounds.y0 &&
+           a->bounds.x1 == b->bounds.x1 && a->bounds.y1 == b->bounds.y1 &&
+           memcmp(fa->data + a->data, fb->data + b->data, a->size) == 0;
+}
+
+void DamageTracker_Init(DamageTracker* tracker, RenderTarget* target, uint32_t clearColor)
+{
+    memset(tracker, 0, sizeof(*tracker));
+    tracker->target = target;
+    tracker->clearColor = clearColor;
+    tracker->full = 1;
+}
+
+void DamageTracker_Free(DamageTracker* tracker)
+{
+    for (int i = 0; i < 2; i++) {
+        free(tracker->frames[i].commands);
+        free(tracker->frames[i].data);
+    }
+    free(tracker->table);
+    memset(tracker, 0, sizeof(*tracker));
+}
+
+void DamageTracker_Invalidate(DamageTracker* tracker)
+{
+    tracker->full = 1;
+}
+
+void DamageTracker_BeginFrame(DamageTracker* tracker)
+{
+    DamageFrame* frame = &tracker->frames[tracker->current];
+    frame->count = 0;
+    frame->dataSize = 0;
+    tracker->failed = 0;
+}
+
+void* DamageTracker_Record(DamageTracker* tracker, RenderRect bounds, DamageDrawFunc draw, size_t size)
+{
+    DamageFrame* frame = &tracker->frames[tracker->current];
+
+    if (frame->count == frame->capacity) {
+        int capacity = frame->capacity ? frame->capacity * 2 : 64;
+        DamageCommand* commands = realloc(frame->commands, capacity * sizeof(DamageCommand));
+        if (!commands) goto fail;
+        frame->commands = commands;
+        frame->capacity = capacity;
+    }
+
+    size_t offset = (frame->dataSize + DAMAGE_DATA_ALIGN - 1) & ~(size_t)(DAMAGE_DATA_ALIGN - 1);
+    if (offset + size > frame->dataCapacity) {
+        size_t capacity = frame->dataCapacity ? frame->dataCapacity : 4096;
+        while (capacity < offset + size) capacity *= 2;
+        uint8_t* data = realloc(frame->data, capacity);
+        if (!data) goto fail;
+        frame->data = data;
+        frame->dataCapacity = capacity;
+    }
+
+    // Межі відсікаються по прямокутнику відсікання (PushClipRect) і цілі: невидима
+    // частина не впливає на порівняння, а при перемальовуванні команда відсікається по них
+    bounds = ClipRect_Intersect(bounds, GetClipRect());
+    RenderTarget* target = tracker->target;
+    if (bounds.x0 < 0) bounds.x0 = 0;
+    if (bounds.y0 < 0) bounds.y0 = 0;
+    if (bounds.x1 > target->width) bounds.x1 = target->width;
+    if (bounds.y1 > target->height) bounds.y1 = target->height;
+    if (DamageRect_Empty(bounds)) bounds.x0 = bounds.y0 = bounds.x1 = bounds.y1 = 0;
+
+    DamageCommand* command = &frame->commands[frame->count++];
+    memset(command, 0, sizeof(*command));
+    command->bounds = bounds;
+    command->draw = draw;
+    command->data = offset;
+    command->size = size;
+    command->match = -1;
+
+    frame->dataSize = offset + size;
+    memset(frame->data + offset, 0, size);
+    return frame->data + offset;
+
+fail:
+    // Без команди кадр не відтворити по частинах - наступний перемальовується повністю
+    fprintf(stderr, "Помилка виділення пам’яті для команди кадру\n");
+    tracker->failed = 1;
+    return NULL;
+}
+
+// Додавання прямокутника змін: злиття з уже наявним, якщо вони перетинаються
+// або об’єднання не більше за їх суму, інакше - новий прямокутник
+static void DamageTracker_AddRect(DamageTracker* tracker, RenderRect rect)
+{
+    if (DamageRect_Empty(rect)) return;
+
+    for (;;) {
+        int merged = 0;
+        for (int i = 0; i < tracker->rectCount; i++) {
+            RenderRect other = tracker->rects[i];
+            RenderRect both = DamageRect_Union(rect, other);
+            if (DamageRect_Intersects(rect, other) ||
+                DamageRect_Area(both) <= DamageRect_Area(rect) + DamageRect_Area(other)) {
+                // Об’єднаний прямокутник може зачепити інші - перевіряємо його знову
+                tracker->rects[i] = tracker->rects[--tracker->rectCount];
+                rect = both;
+                merged = 1;
+                break;
+            }
+        }
+        if (!merged) break;
+    }
+
+    if (tracker->rectCount == DAMAGE_MAX_RECTS) {
+        // Забагато окремих змін - один прямокутник на всі
+        for (int i = 0; i < tracker->rectCount; i++) rect = DamageRect_Union(rect, tracker->rects[i]);
+        tracker->rectCount = 0;
+    }
+    tracker->rects[tracker->rectCount++] = rect;
+}
+
+// Пари однакових команд поточного і попереднього кадрів (однакові команди
+// зіставляються по порядку). 0 - не вдалося виділити пам’ять для таблиці
+static int DamageTracker_Match(DamageTracker* tracker, DamageFrame* cur, DamageFrame* prev)
+{
+    int size = 64;
+    while (size < prev->count * 2) size *= 2;
+    if (size > tracker->tableSize) {
+        int* table = realloc(tracker->table, size * sizeof(int));
+        if (!table) return 0;
+        tracker->table = table;
+        tracker->tableSize = size;
+    }
+    int mask = size - 1;
+    int* table = tracker->table;
+    for (int i = 0; i < size; i++) table[i] = -1;
+
+    for (int i = 0; i < prev->count; i++) {
+        int slot = (int)(prev->commands[i].key & (uint64_t)mask);
+        while (table[slot] >= 0) slot = (slot + 1) & mask;
+        table[slot] = i;
+    }
+
+    for (int i = 0; i < cur->count; i++) {
+        DamageCommand* c = &cur->commands[i];
+        for (int slot = (int)(c->key & (uint64_t)mask); table[slot] >= 0; slot = (slot + 1) & mask) {
+            DamageCommand* p = &prev->commands[table[slot]];
+            if (p->match < 0 && DamageCommand_Equal(c, cur, p, prev)) {
+                c->match = table[slot];
+                p->match = i;
+                break;
+            }
+        }
+    }
+    return 1;
+}
+
+// Перемальовування прямокутника: фон і всі команди кадру, що його перетинають
+static void DamageTracker_Repaint(DamageTracker* tracker, const DamageFrame* frame, RenderRect rect)
+{
+    RenderTarget view = RenderTarget_View(tracker->target, rect);
+    RenderTarget* previous = GetActiveRenderTarget();
+    BeginRenderTarget(&view);
+    // Відсікання викликача - в інших координатах: кожна команда відсікається по своїх межах
+    int scope = PushClipScope();
+
+    RenderTarget_FillRect(&view, 0, 0, view.width, view.height, tracker->clearColor);
+    for (int i = 0; i < frame->count; i++) {
+        const DamageCommand* c = &frame->commands[i];
+        if (!DamageRect_Intersects(c->bounds, rect)) continue;
+        PushClipRect(c->bounds.x0 - rect.x0, c->bounds.y0 - rect.y0,
+                     c->bounds.x1 - c->bounds.x0, c->bounds.y1 - c->bounds.y0);
+        c->draw(frame->data + c->data, -rect.x0, -rect.y0);
+        PopClipRect();
+        tracker->stats.replayed++;
+    }
+
+    PopClipScope(scope);
+    BeginRenderTarget(previous);
+    RenderTarget_MarkDirty(tracker->target, rect.x0, rect.y0, rect.x1, rect.y1);
+    tracker->stats.pixels += (uint64_t)DamageRect_Area(rect);
+}
+
+int DamageTracker_EndFrame(DamageTracker* tracker)
+{
+    DamageFrame* cur = &tracker->frames[tracker->current];
+    DamageFrame* prev = &tracker->frames[tracker->current ^ 1];
+    RenderTarget* target = tracker->target;
+
+    tracker->stats.frames++;
+    tracker->stats.commands += cur->count;
+    tracker->rectCount = 0;
+
+    for (int i = 0; i < cur->count; i++) {
+        cur->commands[i].key = DamageCommand_Hash(&cur->commands[i], cur->data);
+        cur->commands[i].match = -1;
+    }
+    for (int i = 0; i < prev->count; i++) prev->commands[i].match = -1;
+
+    if (tracker->full || tracker->failed || !DamageTracker_Match(tracker, cur, prev)) {
+        RenderRect all = { 0, 0, target->width, target->height };
+        DamageTracker_AddRect(tracker, all);
+    } else {
+        // Нові команди і команди, що змінили порядок відносно попередніх
+        // (з двох переставлених змінена пізніша, тож спільні пікселі перемалюються)
+        int lastMatch = -1;
+        for (int i = 0; i < cur->count; i++) {
+            const DamageCommand* c = &cur->commands[i];
+            if (c->match < 0 || c->match < lastMatch) DamageTracker_AddRect(tracker, c->bounds);
+            else lastMatch = c->match;
+        }
+        // Команди, яких більше немає
+        for (int i = 0; i < prev->count; i++) {
+            if (prev->commands[i].match < 0) DamageTracker_AddRect(tracker, prev->commands[i].bounds);
+        }
+    }
+
+    for (int i = 0; i < tracker->rectCount; i++) DamageTracker_Repaint(tracker, cur, tracker->rects[i]);
+
+    // Якщо команду не записано, цей кадр відтворено не повністю
+    tracker->full = tracker->failed;
+    tracker->current ^= 1;
+    return tracker->rectCount;
+}
+
+const RenderRect* DamageTracker_GetRects(const DamageTracker* tracker, int* count)
+{
+    if (count) *count = tracker->rectCount;
+    return tracker->rects;
+}
+
+void DamageTracker_Present(DamageTracker* tracker)
+{
+    RenderTarget* target = tracker->target;
+    if (target == gfx_backbuffer()) {
+        gfx_present_backbuffer_rects(tracker->rects, tracker->rectCount);
+        return;
+    }
+
+    for (int i = 0; i < tracker->rectCount; i++) {
+        RenderRect r = tracker->rects[i];
+        gfx_put_image(RenderTarget_Row(target, r.y0) + r.x0, r.x1 - r.x0, r.y1 - r.y0,
+                      target->stride, r.x0, r.y0);
+    }
+    RenderTarget_ResetDirty(target);
+}
+
+typedef struct {
+    int x, y, width, height;
+    uint32_t color;
+} RecordedRectangle;
+
+static void DrawRecordedRectangle(const void* data, int dx, int dy)
+{
+    const RecordedRectangle* r = (const RecordedRectangle*)data;
+    DrawRectangle(r->x + dx, r->y + dy, r->width, r->height, r->color);
+}
+
+static void DrawRecordedRectangleLines(const void* data, int dx, int dy)
+{
+    const RecordedRectangle* r = (const RecordedRectangle*)data;
+    DrawRectangleLines(r->x + dx, r->y + dy, r->width, r->height, r->color);
+}
+
+static void RecordRect(DamageTracker* tracker, RenderRect bounds, int x, int y, int width, int height,
+                       uint32_t color, DamageDrawFunc draw)
+{
+    RecordedRectangle* r = DamageTracker_Record(tracker, bounds, draw, sizeof(RecordedRectangle));
+    if (!r) return;
+    r->x = x;
+    r->y = y;
+    r->width = width;
+    r->height = height;
+    r->color = color;
+}
+
+void RecordRectangle(DamageTracker* tracker, int x, int y, int width, int height, uint32_t color)
+{
+    if (width <= 0 || height <= 0) return;
+
+    RenderRect bounds = { x, y, x + width, y + height };
+    RecordRect(tracker, bounds, x, y, width, height, color, DrawRecordedRectangle);
+}
+
+void RecordRectangleLines(DamageTracker* tracker, int x, int y, int width, int height, uint32_t color)
+{
+    // DrawRectangleLines малює горизонталі на y і y + height - 1 (якщо width > 0) і
+    // вертикалі на x і x + width - 1 (якщо height > 0), тож межі - за цими лініями
+    if (width <= 0 && height <= 0) return;
+
+    int left = (width > 0) ? x : x + width - 1;
+    int top = (height > 0) ? y : y + height - 1;
+    RenderRect bounds = { left, top, 0, 0 };
+    bounds.x1 = ((width > 0) ? x + width : x + 1);
+    bounds.y1 = ((height > 0) ? y + height : y + 1);
+    RecordRect(tracker, bounds, x, y, width, height, color, DrawRecordedRectangleLines);
+}
@@ -0,0 +1,105 @@
+#ifndef DAMAGE_H
+#define DAMAGE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "render_target.h"
+
+// Більше прямокутників змін за кадр не буває: решта зливається в один
+#define DAMAGE_MAX_RECTS 16
+
+// Малювання записаної команди: data - її параметри (DamageTracker_Record),
+// (dx, dy) - зсув, який треба додати до координат (кадр перемальовується частинами)
+typedef void (*DamageDrawFunc)(const void* data, int dx, int dy);
+
+// Записана команда малювання
+typedef struct {
+    RenderRect bounds;      // пікселі, які команда може змінити (відсічені по цілі)
+    DamageDrawFunc draw;    // функція малювання
+    size_t data;            // зсув параметрів у буфері кадру
+    size_t size;            // розмір параметрів
+    uint64_t key;           // хеш функції, меж і параметрів
+    int match;              // та сама команда в іншому кадрі або -1
+} DamageCommand;
+
+// Команди одного кадру і їх параметри
+typedef struct {
+    DamageCommand* commands;
+    int count;
+    int capacity;
+    uint8_t* data;
+    size_t dataSize;
+    size_t dataCapacity;
+} DamageFrame;
+
+// Статистика перемальовування
+typedef struct {
+    uint64_t frames;        // кадрів
+    uint64_t commands;      // записано команд
+    uint64_t replayed;      // команд перемальовано (команда в кількох прямокутниках - кілька разів)
+    uint64_t pixels;        // пікселів перемальовано
+} DamageStats;
+
+// Відстеження змін між кадрами. Кадр не малюється одразу, а записується командами
+// (DamageTracker_Record, RecordRectangle, RecordTextScaled, ...). DamageTracker_EndFrame
+// порівнює команди з попереднім кадром і перемальовує лише прямокутники, де щось
+// змінилось: фон clearColor і всі команди кадру, що їх перетинають, у тому ж порядку.
+// Незмінний кадр коштує лише запису і порівняння команд
+typedef struct {
+    RenderTarget* target;               // ціль, у якій живе кадр
+    uint32_t clearColor;                // фон під командами
+    DamageFrame frames[2];              // поточний і попередній кадри
+    int current;                        // індекс поточного кадру у frames
+    int full;                           // наступний кадр перемальовується повністю
+    int failed;                         // команду не вдалося записати
+    RenderRect rects[DAMAGE_MAX_RECTS]; // змінені прямокутники останнього кадру
+    int rectCount;
+    int* table;                         // хеш-таблиця команд попереднього кадру
+    int tableSize;
+    DamageStats stats;
+} DamageTracker;
+
+// Початковий стан: ціль target (наприклад, gfx_backbuffer()) з фоном clearColor.
+// Перший кадр перемальовується повністю
+void DamageTracker_Init(DamageTracker* tracker, RenderTarget* target, uint32_t clearColor);
+void DamageTracker_Free(DamageTracker* tracker);
+
+// Повне перемальовування наступного кадру (вміст цілі змінено поза трекером)
+void DamageTracker_Invalidate(DamageTracker* tracker);
+
+// Початок запису кадру
+void DamageTracker_BeginFrame(DamageTracker* tracker);
+
+// Запис команди: повертає обнулений буфер на size байтів для її параметрів (дійсний
+// до наступного запису) або NULL, якщо не вдалося виділити пам’ять. Параметри
+// порівнюються побайтово, тож вказівники в них мають вказувати на незмінні дані
+// (шрифти), а рядки копіюються в сам буфер. Межі обмежуються поточним прямокутником
+// відсікання (PushClipRect), і команда перемальовується з тим самим відсіканням
+void* DamageTracker_Record(DamageTracker* tracker, RenderRect bounds, DamageDrawFunc draw, size_t size);
+
+// Кінець кадру: порівняння з попереднім кадром і перемальовування змін у target.
+// Повертає кількість змінених прямокутників (0 - кадр не змінився)
+int DamageTracker_EndFrame(DamageTracker* tracker);
+
+// Змінені прямокутники останнього кадру (для виводу з власного буфера кадру)
+const RenderRect* DamageTracker_GetRects(const DamageTracker* tracker, int* count);
+
+// Вивід змінених прямокутників у вікно: з бекбуфера - gfx_present_backbuffer_rects,
+// з іншої цілі - gfx_put_image кожного прямокутника в ту саму позицію вікна
+void DamageTracker_Present(DamageTracker* tracker);
+
+// Заповнений прямокутник (як DrawRectangle), записаний у кадр
+void RecordRectangle(DamageTracker* tracker, int x, int y, int width, int height, uint32_t color);
+// Контур прямокутника (як DrawRectangleLines), записаний у кадр
+void RecordRectangleLines(DamageTracker* tracker, int x, int y, int width, int height, uint32_t color);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DAMAGE_H
@@ -0,0 +1,92 @@
+#ifndef DRAW_LIST_H
+#define DRAW_LIST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "render_target.h"
+#include "damage.h"
+
+// Скільки останніх пакетів переглядається, щоб приєднати команду до пакета з тим самим
+// станом (далі команда просто відкриває новий пакет)
+#define DRAW_LIST_LOOKBACK 64
+
+// Записана команда списку
+typedef struct {
+    RenderRect bounds;      // пікселі, які команда може змінити (з відсіканням на момент запису)
+    uint64_t state;         // стан малювання: шрифт і колір (DrawList_State)
+    DamageDrawFunc draw;    // функція малювання (та сама, що й для DamageTracker)
+    size_t data;            // зсув параметрів у буфері списку
+    int next;               // наступна команда того самого пакета або -1
+} DrawListCommand;
+
+// Пакет: команди з однаковим станом, що виконуються поспіль
+typedef struct {
+    uint64_t state;
+    RenderRect bounds;      // межі всіх команд пакета
+    int first, last;        // перша і остання команди (список через DrawListCommand.next)
+    int count;
+} DrawListBatch;
+
+// Статистика виконаних кадрів
+typedef struct {
+    uint64_t frames;        // викликів DrawList_Flush
+    uint64_t commands;      // виконано команд
+    uint64_t batches;       // пакетів (змін стану після сортування)
+    uint64_t recorded;      // змін стану в порядку запису (без сортування)
+} DrawListStats;
+
+// Список команд кадру. Текст, прямокутники і лінії не малюються одразу, а записуються
+// (DrawList_Record, QueueRectangle, QueueTextScaled, ...). DrawList_Flush групує команди
+// з однаковим станом (шрифт, колір) у пакети і виконує їх пакет за пакетом, тож
+// кольори в gfx перемикаються рідше. Команда переноситься раніше лише повз команди,
+// з якими не перетинається, тож результат той самий, що й при малюванні по порядку
+typedef struct {
+    DrawListCommand* commands;
+    int count;
+    int capacity;
+    uint8_t* data;
+    size_t dataSize;
+    size_t dataCapacity;
+    DrawListBatch* batches;
+    int batchCapacity;
+    DrawListStats stats;
+} DrawList;
+
+void DrawList_Init(DrawList* list);
+void DrawList_Free(DrawList* list);
+
+// Стан малювання для ключа сортування: шрифт (будь-який вказівник, що його визначає,
+// або NULL для прямокутників і ліній) і колір
+uint64_t DrawList_State(const void* font, uint32_t color);
+
+// Запис команди: повертає обнулений буфер на size байтів для її параметрів (дійсний
+// до наступного запису). Межі мають охоплювати всі пікселі команди; вони обмежуються
+// поточною видимою областю (GetVisibleRect), і команда виконується з ними як з
+// прямокутником відсікання. NULL - не вдалося виділити пам’ять: записані команди вже
+// виконано (DrawList_Flush), і цю команду треба намалювати одразу
+void* DrawList_Record(DrawList* list, RenderRect bounds, uint64_t state, DamageDrawFunc draw, size_t size);
+
+// Виконання записаних команд пакетами в поточну ціль (ту саму, що й при записі) і
+// очищення списку
+void DrawList_Flush(DrawList* list);
+
+// Очищення списку без виконання
+void DrawList_Clear(DrawList* list);
+
+// Заповнений прямокутник (як DrawRectangle), записаний у список
+void QueueRectangle(DrawList* list, int x, int y, int width, int height, uint32_t color);
+// Контур прямокутника (як DrawRectangleLines), записаний у список
+void QueueRectangleLines(DrawList* list, int x, int y, int width, int height, uint32_t color);
+// Лінія товщиною thickness (як DrawThickLine), записана у список
+void QueueLine(DrawList* list, int x1, int y1, int x2, int y2, int thickness, uint32_t color);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DRAW_LIST_H
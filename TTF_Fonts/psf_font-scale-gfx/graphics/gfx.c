@@ -10,12 +10,18 @@
  */
 
 #include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/XShm.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
 #include <unistd.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
 
 #include "gfx.h"
+#include "render_target.h"
+#include "clip.h"
 
 /*
  * gfx_open creates several X11 objects, and stores them in globals
@@ -28,6 +34,56 @@ static GC      gfx_gc;
 static Colormap gfx_colormap;
 static int      gfx_fast_color_mode = 0;
 
+static int      gfx_width = 0;
+static int      gfx_height = 0;
+
+/* Optional backbuffer: an XImage (in MIT-SHM memory when available) that all
+   drawing goes to while it is enabled; gfx_flush presents its damaged region. */
+
+static XImage          *gfx_back_image = 0;
+static XShmSegmentInfo  gfx_back_shm;
+static int              gfx_back_use_shm = 0;
+static RenderTarget     gfx_back_target;
+static uint32_t         gfx_back_clear_color = 0x000000;
+
+/* Batching of the direct (core X) drawing path. DrawPixel and DrawSpans queue
+   points and rectangles in per-pixel-value buckets; a bucket goes out as one
+   XFillRectangles plus one XDrawPoints. Drawing order is kept by flushing all
+   buckets whenever a new primitive overlaps the bounding box of a bucket of a
+   different color, so buckets never overlap each other and can be sent in any
+   order. Everything is flushed by gfx_flush and before immediate-mode calls. */
+
+#define GFX_BATCH_COLORS 16
+#define GFX_BATCH_POINTS 1024
+#define GFX_BATCH_RECTS  256
+
+typedef struct {
+  unsigned long pixel;
+  int npoints;
+  int nrects;
+  int x0, y0, x1, y1;   /* bounding box of the queued primitives, [x0,x1) x [y0,y1) */
+  XPoint points[GFX_BATCH_POINTS];
+  XRectangle rects[GFX_BATCH_RECTS];
+} gfx_batch_t;
+
+static gfx_batch_t gfx_batches[GFX_BATCH_COLORS];
+static int         gfx_batch_count = 0;
+static unsigned long gfx_current_pixel = 0;
+static unsigned long gfx_gc_pixel = 0;   /* foreground of gfx_gc as last sent to the server */
+
+/* Cache of colors allocated from the colormap on non-TrueColor visuals, so a
+   color costs one XAllocColor round trip instead of one per use. */
+
+#define GFX_COLOR_CACHE_SIZE 256
+
+typedef struct {
+  uint32_t rgb;
+  unsigned long pixel;
+  int valid;
+} gfx_color_entry_t;
+
+static gfx_color_entry_t gfx_color_cache[GFX_COLOR_CACHE_SIZE];
+
 /* These values are saved by gfx_wait then retrieved later by gfx_xpos and gfx_ypos. */
 
 static int saved_xpos = 0;
@@ -37,6 +93,9 @@ static int saved_ypos = 0;
 
 void gfx_open( int width, int height, const char *title )
 {
+  gfx_width = width;
+  gfx_height = height;
+
   gfx_display = XOpenDisplay(0);
   if(!gfx_display) {
     fprintf(stderr,"gfx_open: unable to open the graphics window.\n");
@@ -70,6 +129,8 @@ void gfx_open( int width, int height, const char *title )
 
   gfx_colormap = DefaultColormap(gfx_display,0);
 
+  gfx_current_pixel = whiteColor;
+  gfx_gc_pixel = whiteColor;
   XSetForeground(gfx_display, gfx_gc, whiteColor);
 
   // Wait for the MapNotify event
@@ -82,27 +143,195 @@ void gfx_open( int width, int height, const char *title )
   }
 }
 
+/* Pixel value for an 0xRRGGBB color. */
+
+static unsigned long gfx_pixel_for( uint32_t rgb )
+{
+  rgb &= 0xffffff;
+  if(gfx_fast_color_mode) return rgb;
+
+  unsigned slot = ((rgb * 2654435761u) >> 24) & (GFX_COLOR_CACHE_SIZE - 1);
+  gfx_color_entry_t *entry = &gfx_color_cache[slot];
+  if(entry->valid && entry->rgb == rgb) return entry->pixel;
+
+  XColor color;
+  color.pixel = 0;
+  color.red = ((rgb >> 16) & 0xff) << 8;
+  color.green = ((rgb >> 8) & 0xff) << 8;
+  color.blue = (rgb & 0xff) << 8;
+  XAllocColor(gfx_display,gfx_colormap,&color);
+
+  entry->rgb = rgb;
+  entry->pixel = color.pixel;
+  entry->valid = 1;
+  return color.pixel;
+}
+
+/* Set the foreground of gfx_gc, skipping the request when it already has
+   that pixel value. The GC keeps whatever color was sent last; immediate-mode
+   calls select gfx_current_pixel themselves before drawing. */
+
+static void gfx_set_foreground( unsigned long pixel )
+{
+  if(pixel == gfx_gc_pixel) return;
+  XSetForeground(gfx_display, gfx_gc, pixel);
+  gfx_gc_pixel = pixel;
+}
+
+/* Send one bucket to the server and empty it. */
+
+static void gfx_batch_send( gfx_batch_t *batch )
+{
+  if(batch->npoints == 0 && batch->nrects == 0) return;
+
+  gfx_set_foreground(batch->pixel);
+  if(batch->nrects > 0) XFillRectangles(gfx_display, gfx_window, gfx_gc, batch->rects, batch->nrects);
+  if(batch->npoints > 0) XDrawPoints(gfx_display, gfx_window, gfx_gc, batch->points, batch->npoints, CoordModeOrigin);
+
+  batch->npoints = 0;
+  batch->nrects = 0;
+}
+
+/* Send all queued primitives. */
+
+static void gfx_batch_flush()
+{
+  for(int i = 0; i < gfx_batch_count; i++) gfx_batch_send(&gfx_batches[i]);
+  gfx_batch_count = 0;
+}
+
+/* Bucket for pixel that may take a primitive covering [x0,x1) x [y0,y1). */
+
+static gfx_batch_t *gfx_batch_for( unsigned long pixel, int x0, int y0, int x1, int y1 )
+{
+  gfx_batch_t *found = 0;
+
+  for(int i = 0; i < gfx_batch_count; i++) {
+    gfx_batch_t *batch = &gfx_batches[i];
+    if(batch->pixel == pixel) {
+      found = batch;
+      continue;
+    }
+    if(batch->npoints == 0 && batch->nrects == 0) continue;
+    if(x0 < batch->x1 && batch->x0 < x1 && y0 < batch->y1 && batch->y0 < y1) {
+      /* Overlaps another color: keep the order by sending everything queued so far. */
+      gfx_batch_flush();
+      found = 0;
+      break;
+    }
+  }
+
+  if(!found) {
+    if(gfx_batch_count == GFX_BATCH_COLORS) gfx_batch_flush();
+    found = &gfx_batches[gfx_batch_count++];
+    found->pixel = pixel;
+    found->npoints = 0;
+    found->nrects = 0;
+  }
+
+  if(found->npoints == 0 && found->nrects == 0) {
+    found->x0 = x0; found->y0 = y0; found->x1 = x1; found->y1 = y1;
+  } else {
+    if(x0 < found->x0) found->x0 = x0;
+    if(y0 < found->y0) found->y0 = y0;
+    if(x1 > found->x1) found->x1 = x1;
+    if(y1 > found->y1) found->y1 = y1;
+  }
+  return found;
+}
+
 /* Draw a single point at (x,y) */
 
 void gfx_point( int x, int y )
 {
+  gfx_batch_flush();
+  gfx_set_foreground(gfx_current_pixel);
   XDrawPoint(gfx_display,gfx_window,gfx_gc,x,y);
 }
 
-void DrawPixel(uint16_t x, uint16_t y, uint32_t color)
+void DrawPixel(int x, int y, uint32_t color)
 {
-  uint8_t r,g,b;
-  r = (uint8_t)(color >> 16);
-  g = (uint8_t)(color >> 8);
-  b = (uint8_t)(color );
-  gfx_color(r, g, b);
-  XDrawPoint(gfx_display,gfx_window,gfx_gc,x,y);
+  /* Outside the clip rectangle, the target or the window: nothing to draw. */
+  RenderRect visible = GetVisibleRect();
+  if(x < visible.x0 || x >= visible.x1 || y < visible.y0 || y >= visible.y1) return;
+
+  RenderTarget *target = GetActiveRenderTarget();
+  if(target) {
+    RenderTarget_PutPixel(target, x, y, color);
+    return;
+  }
+
+  gfx_batch_t *batch = gfx_batch_for(gfx_pixel_for(color), x, y, x + 1, y + 1);
+  batch->points[batch->npoints].x = x;
+  batch->points[batch->npoints].y = y;
+  if(++batch->npoints == GFX_BATCH_POINTS) gfx_batch_send(batch);
+}
+
+/* Part of a span inside the visible rectangle; 0 if nothing is left. */
+
+static int gfx_clip_span( const PixelSpan *span, RenderRect visible, RenderRect *out )
+{
+  RenderRect rect = { span->x, span->y, span->x + span->width, span->y + span->height };
+  *out = ClipRect_Intersect(rect, visible);
+  return out->x0 < out->x1 && out->y0 < out->y1;
+}
+
+/* Fill spans with one color: the spans are queued as rectangles of one
+   pixel value and go out with XFillRectangles instead of one request per pixel.
+   Spans are clipped to the clip rectangle and the target (or window) first;
+   spans that end up empty are dropped without touching the queue. */
+
+void DrawSpans(const PixelSpan *spans, int count, uint32_t color)
+{
+  if(count <= 0) return;
+
+  RenderRect visible = GetVisibleRect();
+  if(visible.x0 >= visible.x1 || visible.y0 >= visible.y1) return;
+
+  RenderRect clipped;
+  RenderTarget *target = GetActiveRenderTarget();
+  if(target) {
+    for(int i = 0; i < count; i++) {
+      if(!gfx_clip_span(&spans[i], visible, &clipped)) continue;
+      RenderTarget_FillRect(target, clipped.x0, clipped.y0, clipped.x1 - clipped.x0, clipped.y1 - clipped.y0, color);
+    }
+    return;
+  }
+
+  /* One overlap test for the bounding box of the whole (clipped) set. */
+  int visibleCount = 0;
+  RenderRect box = { 0, 0, 0, 0 };
+  for(int i = 0; i < count; i++) {
+    if(!gfx_clip_span(&spans[i], visible, &clipped)) continue;
+    if(visibleCount++ == 0) {
+      box = clipped;
+      continue;
+    }
+    if(clipped.x0 < box.x0) box.x0 = clipped.x0;
+    if(clipped.y0 < box.y0) box.y0 = clipped.y0;
+    if(clipped.x1 > box.x1) box.x1 = clipped.x1;
+    if(clipped.y1 > box.y1) box.y1 = clipped.y1;
+  }
+  if(visibleCount == 0) return;
+
+  gfx_batch_t *batch = gfx_batch_for(gfx_pixel_for(color), box.x0, box.y0, box.x1, box.y1);
+  for(int i = 0; i < count; i++) {
+    if(!gfx_clip_span(&spans[i], visible, &clipped)) continue;
+    XRectangle *rect = &batch->rects[batch->nrects];
+    rect->x = clipped.x0;
+    rect->y = clipped.y0;
+    rect->width = clipped.x1 - clipped.x0;
+    rect->height = clipped.y1 - clipped.y0;
+    if(++batch->nrects == GFX_BATCH_RECTS) gfx_batch_send(batch);
+  }
 }
 
 /* Draw a line from (x1,y1) to (x2,y2) */
 
 void gfx_line( int x1, int y1, int x2, int y2 )
 {
+  gfx_batch_flush();
+  gfx_set_foreground(gfx_current_pixel);
   XDrawLine(gfx_display,gfx_window,gfx_gc,x1,y1,x2,y2);
 }
 
@@ -110,27 +339,21 @@ void gfx_line( int x1, int y1, int x2, int y2 )
 
 void gfx_color( int r, int g, int b )
 {
-  XColor color;
-
-  if(gfx_fast_color_mode) {
-    /* If this is a truecolor display, we can just pick the color directly. */
-    color.pixel = ((b&0xff) | ((g&0xff)<<8) | ((r&0xff)<<16) );
-  } else {
-    /* Otherwise, we have to allocate it from the colormap of the display. */
-    color.pixel = 0;
-    color.red = r<<8;
-    color.green = g<<8;
-    color.blue = b<<8;
-    XAllocColor(gfx_display,gfx_colormap,&color);
-  }
-
-  XSetForeground(gfx_display, gfx_gc, color.pixel);
+  /* Queued primitives carry their own pixel value, so no flush is needed here;
+     the GC gets the color when gfx_point or gfx_line next draws with it. */
+  gfx_current_pixel = gfx_pixel_for(((r&0xff)<<16) | ((g&0xff)<<8) | (b&0xff));
 }
 
 /* Clear the graphics window to the background color. */
 
 void gfx_clear()
 {
+  if(gfx_back_image) {
+    RenderTarget_Clear(&gfx_back_target, gfx_back_clear_color);
+    return;
+  }
+  /* Anything still queued would be drawn over the cleared window. */
+  gfx_batch_flush();
   XClearWindow(gfx_display,gfx_window);
 }
 
@@ -138,15 +361,10 @@ void gfx_clear()
 
 void gfx_clear_color( int r, int g, int b )
 {
-  XColor color;
-  color.pixel = 0;
-  color.red = r<<8;
-  color.green = g<<8;
-  color.blue = b<<8;
-  XAllocColor(gfx_display,gfx_colormap,&color);
+  gfx_back_clear_color = ((r&0xff)<<16) | ((g&0xff)<<8) | (b&0xff);
 
   XSetWindowAttributes attr;
-  attr.background_pixel = color.pixel;
+  attr.background_pixel = gfx_pixel_for(gfx_back_clear_color);
   XChangeWindowAttributes(gfx_display,gfx_window,CWBackPixel,&attr);
 }
 
@@ -208,10 +426,229 @@ int gfx_ypos()
   return saved_ypos;
 }
 
+/* Return the X and Y dimensions of the window. */
+
+int gfx_xsize()
+{
+  return gfx_width;
+}
+
+int gfx_ysize()
+{
+  return gfx_height;
+}
+
 /* Flush all previous output to the window. */
 
 void gfx_flush()
 {
+  gfx_batch_flush();
+  if(gfx_back_image) gfx_present_backbuffer();
   XFlush(gfx_display);
 }
 
+/* Backbuffer support. */
+
+static int gfx_shm_error = 0;
+
+static int gfx_shm_error_handler( Display *display, XErrorEvent *event )
+{
+  (void)display;
+  (void)event;
+  gfx_shm_error = 1;
+  return 0;
+}
+
+/* Try to create the backbuffer image in a shared memory segment. */
+
+static XImage *gfx_create_shm_image( Visual *visual, int depth )
+{
+  if(!XShmQueryExtension(gfx_display)) return 0;
+
+  XImage *image = XShmCreateImage(gfx_display, visual, depth, ZPixmap, 0, &gfx_back_shm, gfx_width, gfx_height);
+  if(!image) return 0;
+
+  gfx_back_shm.shmid = shmget(IPC_PRIVATE, (size_t)image->bytes_per_line * image->height, IPC_CREAT | 0600);
+  if(gfx_back_shm.shmid < 0) {
+    XDestroyImage(image);
+    return 0;
+  }
+
+  gfx_back_shm.shmaddr = image->data = shmat(gfx_back_shm.shmid, 0, 0);
+  if(gfx_back_shm.shmaddr == (char *)-1) {
+    shmctl(gfx_back_shm.shmid, IPC_RMID, 0);
+    XDestroyImage(image);
+    return 0;
+  }
+  gfx_back_shm.readOnly = False;
+
+  /* XShmAttach fails asynchronously (e.g. on a remote display), so trap the error. */
+  gfx_shm_error = 0;
+  XErrorHandler old_handler = XSetErrorHandler(gfx_shm_error_handler);
+  XShmAttach(gfx_display, &gfx_back_shm);
+  XSync(gfx_display, False);
+  XSetErrorHandler(old_handler);
+
+  /* The segment is freed automatically once both sides detach. */
+  shmctl(gfx_back_shm.shmid, IPC_RMID, 0);
+
+  if(gfx_shm_error) {
+    shmdt(gfx_back_shm.shmaddr);
+    image->data = 0;
+    XDestroyImage(image);
+    return 0;
+  }
+  return image;
+}
+
+int gfx_enable_backbuffer()
+{
+  if(gfx_back_image) return 1;
+
+  Visual *visual = DefaultVisual(gfx_display,0);
+  int depth = DefaultDepth(gfx_display,0);
+
+  /* Drawing stores 0xRRGGBB words directly, so only 24/32-bit TrueColor qualifies. */
+  if(!gfx_fast_color_mode || (depth != 24 && depth != 32) ||
+     visual->red_mask != 0xff0000 || visual->green_mask != 0x00ff00 || visual->blue_mask != 0x0000ff) {
+    return 0;
+  }
+
+  gfx_back_image = gfx_create_shm_image(visual, depth);
+  gfx_back_use_shm = gfx_back_image != 0;
+
+  if(!gfx_back_image) {
+    char *data = malloc((size_t)gfx_width * gfx_height * 4);
+    if(!data) return 0;
+    gfx_back_image = XCreateImage(gfx_display, visual, depth, ZPixmap, 0, data, gfx_width, gfx_height, 32, 0);
+    if(!gfx_back_image) {
+      free(data);
+      return 0;
+    }
+  }
+
+  if(gfx_back_image->bits_per_pixel != 32) {
+    gfx_disable_backbuffer();
+    return 0;
+  }
+
+  gfx_back_target = RenderTarget_Init((uint32_t *)gfx_back_image->data, gfx_width, gfx_height,
+                                      gfx_back_image->bytes_per_line);
+  RenderTarget_Clear(&gfx_back_target, gfx_back_clear_color);
+  SetDefaultRenderTarget(&gfx_back_target);
+  return 1;
+}
+
+void gfx_disable_backbuffer()
+{
+  if(!gfx_back_image) return;
+
+  /* Drawing goes back to the window. */
+  SetDefaultRenderTarget(0);
+
+  if(gfx_back_use_shm) {
+    XShmDetach(gfx_display, &gfx_back_shm);
+    XSync(gfx_display, False);
+    shmdt(gfx_back_shm.shmaddr);
+    gfx_back_image->data = 0;
+  }
+  XDestroyImage(gfx_back_image); /* also frees malloc'ed pixel data */
+  gfx_back_image = 0;
+  gfx_back_use_shm = 0;
+}
+
+RenderTarget *gfx_backbuffer()
+{
+  return gfx_back_image ? &gfx_back_target : 0;
+}
+
+/* Present the damaged part of the backbuffer with one request. */
+
+void gfx_present_backbuffer()
+{
+  RenderTarget *target = &gfx_back_target;
+  if(!gfx_back_image || target->dirty_x0 >= target->dirty_x1) return;
+
+  int x = target->dirty_x0;
+  int y = target->dirty_y0;
+  int w = target->dirty_x1 - target->dirty_x0;
+  int h = target->dirty_y1 - target->dirty_y0;
+
+  if(gfx_back_use_shm) {
+    XShmPutImage(gfx_display, gfx_window, gfx_gc, gfx_back_image, x, y, x, y, w, h, False);
+    /* Wait for the server to read the segment before the next frame overwrites it. */
+    XSync(gfx_display, False);
+  } else {
+    XPutImage(gfx_display, gfx_window, gfx_gc, gfx_back_image, x, y, x, y, w, h);
+  }
+  RenderTarget_ResetDirty(target);
+}
+
+/* Present several damaged rectangles; the SHM path waits for the server once. */
+
+void gfx_present_backbuffer_rects(const RenderRect *rects, int count)
+{
+  if(!gfx_back_image) return;
+
+  for(int i = 0; i < count; i++) {
+    int x = rects[i].x0 < 0 ? 0 : rects[i].x0;
+    int y = rects[i].y0 < 0 ? 0 : rects[i].y0;
+    int x1 = rects[i].x1 > gfx_width ? gfx_width : rects[i].x1;
+    int y1 = rects[i].y1 > gfx_height ? gfx_height : rects[i].y1;
+    if(x >= x1 || y >= y1) continue;
+
+    if(gfx_back_use_shm) {
+      XShmPutImage(gfx_display, gfx_window, gfx_gc, gfx_back_image, x, y, x, y, x1 - x, y1 - y, False);
+    } else {
+      XPutImage(gfx_display, gfx_window, gfx_gc, gfx_back_image, x, y, x, y, x1 - x, y1 - y);
+    }
+  }
+  if(gfx_back_use_shm && count > 0) XSync(gfx_display, False);
+  RenderTarget_ResetDirty(&gfx_back_target);
+}
+
+/* Copy a 0xAARRGGBB image to the window. On 24/32-bit TrueColor visuals the
+   caller's buffer is wrapped in an XImage without copying and sent with one
+   XPutImage; other visuals fall back to one rectangle per run of equal color. */
+
+void gfx_put_image(const uint32_t *pixels, int width, int height, int stride, int x, int y)
+{
+  Visual *visual = DefaultVisual(gfx_display,0);
+  int depth = DefaultDepth(gfx_display,0);
+
+  if(width <= 0 || height <= 0) return;
+
+  gfx_batch_flush();
+
+  if(gfx_fast_color_mode && (depth == 24 || depth == 32) &&
+     visual->red_mask == 0xff0000 && visual->green_mask == 0x00ff00 && visual->blue_mask == 0x0000ff) {
+    XImage *image = XCreateImage(gfx_display, visual, depth, ZPixmap, 0, (char *)pixels,
+                                 width, height, 32, stride);
+    if(image && image->bits_per_pixel == 32) {
+      /* The buffer holds native-endian 32-bit words; Xlib swaps if the server differs. */
+      uint32_t probe = 1;
+      image->byte_order = (*(uint8_t *)&probe == 1) ? LSBFirst : MSBFirst;
+      XPutImage(gfx_display, gfx_window, gfx_gc, image, 0, 0, x, y, width, height);
+      image->data = NULL; /* the pixels belong to the caller */
+      XDestroyImage(image);
+      return;
+    }
+    if(image) {
+      image->data = NULL;
+      XDestroyImage(image);
+    }
+  }
+
+  for(int row = 0; row < height; row++) {
+    const uint32_t *line = (const uint32_t *)((const uint8_t *)pixels + (size_t)row * stride);
+    int start = 0;
+    while(start < width) {
+      uint32_t color = line[start] & 0xffffff;
+      int end = start + 1;
+      while(end < width && (line[end] & 0xffffff) == color) end++;
+      gfx_set_foreground(gfx_pixel_for(color));
+      XFillRectangle(gfx_display, gfx_window, gfx_gc, x + start, y + row, end - start, 1);
+      start = end;
+    }
+  }
+}
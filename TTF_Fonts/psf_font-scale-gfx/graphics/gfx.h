@@ -15,13 +15,27 @@
 
 #include <stdint.h>
 
+#include "render_target.h"
+
 /* Open a new graphics window. */
 void gfx_open( int width, int height, const char *title );
 
 /* Draw a point at (x,y) */
 void gfx_point( int x, int y );
 
-void DrawPixel(uint16_t x, uint16_t y, uint32_t color);
+/* Draw a pixel; pixels outside the clip rectangle (see clip.h), the active
+   render target or the window are skipped (negative coordinates included) */
+void DrawPixel(int x, int y, uint32_t color);
+
+/* Rectangle of pixels (usually one horizontal run) for bulk fills */
+typedef struct {
+  int16_t x, y;
+  uint16_t width, height;
+} PixelSpan;
+
+/* Fill count spans with one color using a single X request per batch;
+   each span is clipped like DrawPixel */
+void DrawSpans(const PixelSpan *spans, int count, uint32_t color);
 
 /* Draw a line from (x1,y1) to (x2,y2) */
 void gfx_line( int x1, int y1, int x2, int y2 );
@@ -52,5 +66,23 @@ int gfx_event_waiting();
 /* Flush all previous output to the window. */
 void gfx_flush();
 
+/* Draw into a window-sized backbuffer (MIT-SHM when available, plain XPutImage
+   otherwise) instead of the window; gfx_flush presents the damaged region.
+   Returns 0 if the visual is not 24/32-bit TrueColor. */
+int gfx_enable_backbuffer();
+void gfx_disable_backbuffer();
+
+/* The backbuffer render target, or 0 when the backbuffer is off. */
+RenderTarget *gfx_backbuffer();
+
+/* Present the damaged region of the backbuffer now (gfx_flush does this too). */
+void gfx_present_backbuffer();
+
+/* Present only the given backbuffer rectangles (e.g. from a DamageTracker). */
+void gfx_present_backbuffer_rects(const RenderRect *rects, int count);
+
+/* Copy a 0xAARRGGBB image (stride in bytes) to the window at (x,y) in one request. */
+void gfx_put_image(const uint32_t *pixels, int width, int height, int stride, int x, int y);
+
 #endif
 
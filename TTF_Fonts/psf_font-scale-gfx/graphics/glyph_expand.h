@@ -0,0 +1,32 @@
+#ifndef GLYPH_EXPAND_H
+#define GLYPH_EXPAND_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Розгортання монохромного бітмапа (1 біт на піксель, старший біт зліва,
+// рядок - (width + 7) / 8 байтів) у 32-бітні пікселі з цілим масштабом scale.
+//
+// Вихідне зображення має розмір (width * scale) x (height * scale); записується
+// лише його частина [out_x0, out_x1) x [out_y0, out_y1) (для відсікання).
+// dst вказує на піксель (out_x0, out_y0) у буфері з кроком dst_stride байтів.
+// opaque = 0 - пишуться лише пікселі гліфа кольором fg (фон не змінюється),
+// opaque != 0 - кожен піксель отримує fg або bg.
+//
+// Ядро (AVX2/SSE2/NEON/скалярне) обирається при першому виклику за можливостями CPU.
+void ExpandGlyphBits(uint32_t* dst, int dst_stride,
+                     const uint8_t* bitmap, int width, int height, int scale,
+                     int out_x0, int out_y0, int out_x1, int out_y1,
+                     uint32_t fg, uint32_t bg, int opaque);
+
+// Назва обраного ядра: "avx2", "sse2", "neon" або "scalar"
+const char* GetGlyphExpandBackend(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GLYPH_EXPAND_H
@@ -1,7 +1,10 @@
 // lines.c
 
+#include <string.h>
+
 #include "graphics.h"
 #include "gfx.h"
+#include "clip.h"
 
 // малювання лінії окремими пікселями з передачою кольору в функцію.
 void DrawThinLine(int x1, int y1, int x2, int y2, int thickness, uint32_t color)
@@ -160,33 +163,187 @@ void DrawLineEx(Vector2 startPos, Vector2 endPos, float thickness, uint32_t colo
     }
 }
 
-// Малювання заповненого прямокутника кольором color (у форматі 0xRRGGBB)
-void DrawRectangle(int16_t x, int16_t y, int16_t width, int16_t height, uint32_t color)
+// Малювання заповненого прямокутника кольором color (у форматі 0xRRGGBB).
+// Прямокутник спершу відсікається по видимій області, тож великі і від’ємні
+// координати не переповнюють PixelSpan
+void DrawRectangle(int x, int y, int width, int height, uint32_t color)
+{
+    if (width <= 0 || height <= 0) return;
+
+    RenderRect rect = { x, y, x + width, y + height };
+    rect = ClipRect_Intersect(rect, GetVisibleRect());
+    if (rect.x0 >= rect.x1 || rect.y0 >= rect.y1) return;
+
+    PixelSpan span = { (int16_t)rect.x0, (int16_t)rect.y0,
+                       (uint16_t)(rect.x1 - rect.x0), (uint16_t)(rect.y1 - rect.y0) };
+    DrawSpans(&span, 1, color);
+}
+
+// Малювання не заповненого прямокутника кольором color (у форматі 0xRRGGBB):
+// чотири лінії товщиною 1 піксель, кожна - один відрізок (ті самі пікселі, що й
+// попіксельне малювання, зокрема при нульовій чи від’ємній ширині або висоті)
+void DrawRectangleLines(int x, int y, int width, int height, uint32_t color)
+{
+    // Верхня і нижня горизонтальні лінії
+    DrawRectangle(x, y, width, 1, color);
+    DrawRectangle(x, y + height - 1, width, 1, color);
+    // Ліва і права вертикальні лінії
+    DrawRectangle(x, y, 1, height, color);
+    DrawRectangle(x + width - 1, y, 1, height, color);
+}
+
+// Кількість відрізків, що накопичуються перед передачею в DrawSpans
+#define BITMAP_SPAN_BATCH 256
+
+// Малювання монохромного бітмапа горизонтальними відрізками (або прямо в RenderTarget).
+// Рядок бітмапа займає (width + 7) / 8 байтів, старший біт байта - лівий піксель.
+// Бітмап поза видимою областю (GetVisibleRect) відкидається до читання бітів, у
+// частково видимому читаються лише видимі рядки і стовпці.
+// Нульові байти пропускаються цілком, кожна серія одиниць дає один прямокутник
+// (довжина серії * scale) x scale, і всі вони малюються пакетами одного кольору.
+// Однакові сусідні рядки дають один ряд прямокутників висотою (кількість рядків * scale),
+// тож маска, вже розтягнута на масштаб (TextCache), малюється тими самими прямокутниками
+void DrawBitmapSpans(const uint8_t* bitmap, int width, int height,
+                     int x, int y, int scale, uint32_t color)
 {
-    for (int16_t py = y; py < y + height; py++) {
-        for (int16_t px = x; px < x + width; px++) {
-            DrawPixel(px, py, color);
+    if (!bitmap || width <= 0 || height <= 0 || scale < 1) return;
+
+    RenderRect visible = GetVisibleRect();
+    if (!ClipRect_Overlaps(visible, x, y, x + width * scale, y + height * scale)) return;
+
+    // Ціль у пам'яті: біти розгортаються векторними ядрами прямо в буфер
+    RenderTarget* target = GetActiveRenderTarget();
+    if (target) {
+        RenderTarget_DrawBitmapClipped(target, visible, bitmap, width, height, x, y, scale, color);
+        return;
+    }
+
+    // Видимі рядки [row0, row1) і стовпці [col0, col1) бітмапа
+    int row0 = (visible.y0 > y) ? (visible.y0 - y) / scale : 0;
+    int row1 = (visible.y1 < y + height * scale) ? (visible.y1 - y + scale - 1) / scale : height;
+    int col0 = (visible.x0 > x) ? (visible.x0 - x) / scale : 0;
+    int col1 = (visible.x1 < x + width * scale) ? (visible.x1 - x + scale - 1) / scale : width;
+
+    PixelSpan spans[BITMAP_SPAN_BATCH];
+    int count = 0;
+    int bytes_per_row = (width + 7) / 8;
+
+    for (int row = row0; row < row1; ++row) {
+        const uint8_t* line = bitmap + row * bytes_per_row;
+        int sy0 = y + row * scale;
+        // Наступні рядки, що збігаються з цим, малюються разом з ним
+        int last = row;
+        while (last + 1 < row1 &&
+               memcmp(line, line + (last + 1 - row) * bytes_per_row, bytes_per_row) == 0) last++;
+        int sy1 = y + (last + 1) * scale;
+        row = last;
+        if (sy0 < visible.y0) sy0 = visible.y0;
+        if (sy1 > visible.y1) sy1 = visible.y1;
+
+        int px = col0;
+        while (px < col1) {
+            uint8_t byte_val = line[px >> 3];
+            if (byte_val == 0 && (px & 7) == 0) { // порожній байт - 8 пікселів фону
+                px += 8;
+                continue;
+            }
+            if (!(byte_val & (0x80 >> (px & 7)))) {
+                px++;
+                continue;
+            }
+
+            // Шукаємо кінець серії встановлених бітів
+            int start = px;
+            while (px < col1 && (line[px >> 3] & (0x80 >> (px & 7)))) px++;
+
+            // Серія, відсічена по видимій області (крайні стовпці можуть бути видимі частково)
+            int sx0 = x + start * scale;
+            int sx1 = x + px * scale;
+            if (sx0 < visible.x0) sx0 = visible.x0;
+            if (sx1 > visible.x1) sx1 = visible.x1;
+
+            if (count == BITMAP_SPAN_BATCH) {
+                DrawSpans(spans, count, color);
+                count = 0;
+            }
+            spans[count].x = (int16_t)sx0;
+            spans[count].y = (int16_t)sy0;
+            spans[count].width = (uint16_t)(sx1 - sx0);
+            spans[count].height = (uint16_t)(sy1 - sy0);
+            count++;
         }
     }
+
+    if (count > 0) DrawSpans(spans, count, color);
 }
 
-// Малювання не заповненого прямокутника кольором color (у форматі 0xRRGGBB)
-void DrawRectangleLines(int16_t x, int16_t y, int16_t width, int16_t height, uint32_t color)
+// Додавання відрізка [x0, x1) x [y0, y1) до пакета spans кольору color (повний пакет
+// спершу малюється)
+static void PushBitmapSpan(PixelSpan* spans, int* count, uint32_t color, int x0, int y0, int x1, int y1)
 {
-    // Верхня горизонтальна лінія
-    for (int16_t px = x; px < x + width; px++) {
-        DrawPixel(px, y, color);
+    if (*count == BITMAP_SPAN_BATCH) {
+        DrawSpans(spans, *count, color);
+        *count = 0;
     }
-    // Нижня горизонтальна лінія
-    for (int16_t px = x; px < x + width; px++) {
-        DrawPixel(px, y + height - 1, color);
-    }
-    // Ліва вертикальна лінія
-    for (int16_t py = y; py < y + height; py++) {
-        DrawPixel(x, py, color);
+    spans[*count].x = (int16_t)x0;
+    spans[*count].y = (int16_t)y0;
+    spans[*count].width = (uint16_t)(x1 - x0);
+    spans[*count].height = (uint16_t)(y1 - y0);
+    (*count)++;
+}
+
+// Непрозорий бітмап: у цілі в пам'яті - одним розгортанням з фоном, у вікні - серії
+// встановлених бітів пакетами кольору fg, а серії нулів - пакетами кольору bg,
+// тож кожен піксель пишеться рівно один раз
+void DrawBitmapOpaque(const uint8_t* bitmap, int width, int height,
+                      int x, int y, int scale, uint32_t fg, uint32_t bg)
+{
+    if (!bitmap || width <= 0 || height <= 0 || scale < 1) return;
+
+    RenderRect visible = GetVisibleRect();
+    if (!ClipRect_Overlaps(visible, x, y, x + width * scale, y + height * scale)) return;
+
+    RenderTarget* target = GetActiveRenderTarget();
+    if (target) {
+        RenderTarget_DrawBitmapOpaqueClipped(target, visible, bitmap, width, height, x, y, scale, fg, bg);
+        return;
     }
-    // Права вертикальна лінія
-    for (int16_t py = y; py < y + height; py++) {
-        DrawPixel(x + width - 1, py, color);
+
+    // Видимі рядки [row0, row1) і стовпці [col0, col1) бітмапа
+    int row0 = (visible.y0 > y) ? (visible.y0 - y) / scale : 0;
+    int row1 = (visible.y1 < y + height * scale) ? (visible.y1 - y + scale - 1) / scale : height;
+    int col0 = (visible.x0 > x) ? (visible.x0 - x) / scale : 0;
+    int col1 = (visible.x1 < x + width * scale) ? (visible.x1 - x + scale - 1) / scale : width;
+
+    PixelSpan fgSpans[BITMAP_SPAN_BATCH];
+    PixelSpan bgSpans[BITMAP_SPAN_BATCH];
+    int fgCount = 0, bgCount = 0;
+    int bytes_per_row = (width + 7) / 8;
+
+    for (int row = row0; row < row1; ++row) {
+        const uint8_t* line = bitmap + row * bytes_per_row;
+        int sy0 = y + row * scale;
+        int sy1 = sy0 + scale;
+        if (sy0 < visible.y0) sy0 = visible.y0;
+        if (sy1 > visible.y1) sy1 = visible.y1;
+
+        int px = col0;
+        while (px < col1) {
+            // Серія однакових бітів: встановлених - піксель гліфа, нулів - фон
+            int set = (line[px >> 3] & (0x80 >> (px & 7))) != 0;
+            int start = px;
+            while (px < col1 && ((line[px >> 3] & (0x80 >> (px & 7))) != 0) == set) px++;
+
+            int sx0 = x + start * scale;
+            int sx1 = x + px * scale;
+            if (sx0 < visible.x0) sx0 = visible.x0;
+            if (sx1 > visible.x1) sx1 = visible.x1;
+
+            if (set) PushBitmapSpan(fgSpans, &fgCount, fg, sx0, sy0, sx1, sy1);
+            else PushBitmapSpan(bgSpans, &bgCount, bg, sx0, sy0, sx1, sy1);
+        }
     }
+
+    if (bgCount > 0) DrawSpans(bgSpans, bgCount, bg);
+    if (fgCount > 0) DrawSpans(fgSpans, fgCount, fg);
 }
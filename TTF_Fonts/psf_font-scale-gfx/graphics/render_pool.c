@@ -0,0 +1,197 @@
+// render_pool.c
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "render_pool.h"
+
+// Частина завдань кожного учасника [begin, end) в одному слові (begin - старші 32 біти):
+// власник бере завдання з початку, інші - з кінця, обидва через порівняння з обміном
+static _Atomic uint64_t g_ranges[RENDER_POOL_MAX_THREADS];
+
+// Стан пулу. Усе, крім g_ranges, захищено g_lock
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_workAvailable = PTHREAD_COND_INITIALIZER; // Новий виклик або зупинка
+static pthread_cond_t g_workDone = PTHREAD_COND_INITIALIZER;      // Робочий потік завершив виклик
+static pthread_mutex_t g_runLock = PTHREAD_MUTEX_INITIALIZER;     // Один RenderPool_Run за раз
+static pthread_t g_threads[RENDER_POOL_MAX_THREADS];
+static unsigned g_seen[RENDER_POOL_MAX_THREADS];  // Останній виклик, який бачив робочий потік
+static int g_threadCount = 0;       // Запущені робочі потоки (учасники 1..g_threadCount)
+static int g_requested = 0;         // RenderPool_SetThreadCount
+static int g_stop = 0;
+static unsigned g_generation = 0;   // Номер поточного виклику RenderPool_Run
+static int g_participants = 0;      // Учасники поточного виклику (з потоком, що викликає)
+static int g_active = 0;            // Робочі потоки, що ще виконують поточний виклик
+static RenderPoolJob g_job = NULL;
+static void* g_user = NULL;
+
+static inline uint64_t RenderPool_Range(uint32_t begin, uint32_t end)
+{
+    return ((uint64_t)begin << 32) | end;
+}
+
+// Наступне завдання зі своєї частини або -1
+static int RenderPool_TakeOwn(int slot)
+{
+    uint64_t range = atomic_load(&g_ranges[slot]);
+    for (;;) {
+        uint32_t begin = (uint32_t)(range >> 32);
+        uint32_t end = (uint32_t)range;
+        if (begin >= end) return -1;
+        if (atomic_compare_exchange_weak(&g_ranges[slot], &range, RenderPool_Range(begin + 1, end)))
+            return (int)begin;
+    }
+}
+
+// Останнє завдання з чужої частини або -1
+static int RenderPool_Steal(int slot)
+{
+    uint64_t range = atomic_load(&g_ranges[slot]);
+    for (;;) {
+        uint32_t begin = (uint32_t)(range >> 32);
+        uint32_t end = (uint32_t)range;
+        if (begin >= end) return -1;
+        if (atomic_compare_exchange_weak(&g_ranges[slot], &range, RenderPool_Range(begin, end - 1)))
+            return (int)end - 1;
+    }
+}
+
+// Виконання завдань учасником slot, доки вони є хоч у когось
+static void RenderPool_Work(int slot, int participants, RenderPoolJob job, void* user)
+{
+    for (;;) {
+        int index = RenderPool_TakeOwn(slot);
+        for (int i = 1; index < 0 && i < participants; i++) {
+            index = RenderPool_Steal((slot + i) % participants);
+        }
+        if (index < 0) return;
+        job(index, user);
+    }
+}
+
+static void* RenderPool_Worker(void* arg)
+{
+    int slot = (int)(intptr_t)arg;
+
+    pthread_mutex_lock(&g_lock);
+    for (;;) {
+        while (!g_stop && g_seen[slot] == g_generation) pthread_cond_wait(&g_workAvailable, &g_lock);
+        if (g_stop) break;
+        g_seen[slot] = g_generation;
+        if (slot >= g_participants) continue; // у цьому виклику потік не потрібен
+
+        int participants = g_participants;
+        RenderPoolJob job = g_job;
+        void* user = g_user;
+        pthread_mutex_unlock(&g_lock);
+
+        RenderPool_Work(slot, participants, job, user);
+
+        pthread_mutex_lock(&g_lock);
+        if (--g_active == 0) pthread_cond_broadcast(&g_workDone);
+    }
+    pthread_mutex_unlock(&g_lock);
+    return NULL;
+}
+
+// Дозапуск робочих потоків до workers; повертає кількість запущених
+static int RenderPool_StartThreads(int workers)
+{
+    pthread_mutex_lock(&g_lock);
+    while (g_threadCount < workers) {
+        int slot = g_threadCount + 1;
+        g_seen[slot] = g_generation;
+        if (pthread_create(&g_threads[slot], NULL, RenderPool_Worker, (void*)(intptr_t)slot) != 0) {
+            fprintf(stderr, "Не вдалося запустити потік малювання\n");
+            break;
+        }
+        g_threadCount++;
+    }
+    int started = g_threadCount;
+    pthread_mutex_unlock(&g_lock);
+    return started;
+}
+
+void RenderPool_Run(int count, RenderPoolJob job, void* user)
+{
+    if (count <= 0) return;
+
+    int participants = RenderPool_GetThreadCount();
+    if (participants > count) participants = count;
+    if (participants > 1) {
+        int workers = RenderPool_StartThreads(participants - 1);
+        if (participants > workers + 1) participants = workers + 1;
+    }
+    if (participants <= 1) {
+        for (int i = 0; i < count; i++) job(i, user);
+        return;
+    }
+
+    pthread_mutex_lock(&g_runLock);
+
+    // Суцільні частини: сусідні смуги дістаються одному потоку
+    for (int slot = 0; slot < participants; slot++) {
+        uint32_t begin = (uint32_t)((int64_t)count * slot / participants);
+        uint32_t end = (uint32_t)((int64_t)count * (slot + 1) / participants);
+        atomic_store(&g_ranges[slot], RenderPool_Range(begin, end));
+    }
+
+    pthread_mutex_lock(&g_lock);
+    g_job = job;
+    g_user = user;
+    g_participants = participants;
+    g_active = participants - 1;
+    g_generation++;
+    pthread_cond_broadcast(&g_workAvailable);
+    pthread_mutex_unlock(&g_lock);
+
+    RenderPool_Work(0, participants, job, user);
+
+    // Робочі потоки ще можуть виконувати вкрадені завдання - чекаємо всіх
+    pthread_mutex_lock(&g_lock);
+    while (g_active > 0) pthread_cond_wait(&g_workDone, &g_lock);
+    pthread_mutex_unlock(&g_lock);
+
+    pthread_mutex_unlock(&g_runLock);
+}
+
+void RenderPool_SetThreadCount(int threads)
+{
+    if (threads < 0) threads = 0;
+    if (threads > RENDER_POOL_MAX_THREADS) threads = RENDER_POOL_MAX_THREADS;
+    pthread_mutex_lock(&g_lock);
+    g_requested = threads;
+    pthread_mutex_unlock(&g_lock);
+}
+
+int RenderPool_GetThreadCount(void)
+{
+    pthread_mutex_lock(&g_lock);
+    int requested = g_requested;
+    pthread_mutex_unlock(&g_lock);
+    if (requested > 0) return requested;
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1) return 1;
+    return (cpus > RENDER_POOL_MAX_THREADS) ? RENDER_POOL_MAX_THREADS : (int)cpus;
+}
+
+void RenderPool_Shutdown(void)
+{
+    pthread_mutex_lock(&g_runLock);
+    pthread_mutex_lock(&g_lock);
+    g_stop = 1;
+    pthread_cond_broadcast(&g_workAvailable);
+    pthread_mutex_unlock(&g_lock);
+
+    for (int slot = 1; slot <= g_threadCount; slot++) pthread_join(g_threads[slot], NULL);
+
+    pthread_mutex_lock(&g_lock);
+    g_threadCount = 0;
+    g_stop = 0;
+    pthread_mutex_unlock(&g_lock);
+    pthread_mutex_unlock(&g_runLock);
+}
@@ -18,14 +18,17 @@ int main(void) {
     Display_Set_HEIGHT(screenHeight);
     gfx_color(128,127,255);
 
+    // Кадр малюється в бекбуфер (MIT-SHM) і виводиться у вікно в gfx_flush
+    gfx_enable_backbuffer();
+
     DrawRectangle(0, 0, screenWidth, screenHeight, WHITE);
     DrawRectangle(0, 0, osc_width, osc_height, BLACK);
 
     // Завантаження PSF шрифту (шлях до вашого файлу)
-    psfFont12 = LoadPSFFont("fonts/Uni3-Terminus12x6.psf");
-    psfFont20 = LoadPSFFont("fonts/Uni3-Terminus20x10.psf");
-    psfFont28 = LoadPSFFont("fonts/Uni3-Terminus28x14.psf");
-    psfFont32 = LoadPSFFont("fonts/Uni3-Terminus32x16.psf");
+    psfFont12 = LoadPSFFontMapped("fonts/Uni3-Terminus12x6.psf");
+    psfFont20 = LoadPSFFontMapped("fonts/Uni3-Terminus20x10.psf");
+    psfFont28 = LoadPSFFontMapped("fonts/Uni3-Terminus28x14.psf");
+    psfFont32 = LoadPSFFontMapped("fonts/Uni3-Terminus32x16.psf");
 
     int scale = 2; // масштаб 1x
     int spacing = 1; // простір між символами px
@@ -60,6 +63,7 @@ int main(void) {
     UnloadPSFFont(psfFont20);
     UnloadPSFFont(psfFont28);
     UnloadPSFFont(psfFont32);
+    gfx_disable_backbuffer();
 
     return 0;
 }
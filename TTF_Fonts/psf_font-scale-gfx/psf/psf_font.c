@@ -4,9 +4,18 @@
 #include "psf_font.h"       // Визначення структури PSF_Font і прототипів функцій
 #include <stdio.h>          // Для роботи з файлами (fopen, fread, fclose)
 #include <stdlib.h>         // Для динамічного виділення пам’яті (malloc, free)
-#include <string.h>         // Для роботи зі строками (strncpy, strtok)
+#include <string.h>         // Для strcspn
 #include "color_utils.h"
+#include "text_cache.h"       // Кеш розтеризованих рядків
+#include "render_pool.h"      // Пул потоків для DrawPSFGlyphRunParallel
+#include "clip.h"             // Відсікання: GetVisibleRect, GetClipRect
 #include <math.h>           // Для роботи з  математикою (fmaxf, fminf, fmodf, fabsf, тощо)
+#ifndef _WIN32
+#include <fcntl.h>          // Для open
+#include <unistd.h>         // Для close
+#include <sys/mman.h>       // Для mmap, munmap (відображення файлу шрифту у пам’ять)
+#include <sys/stat.h>       // Для fstat (розмір файлу)
+#endif
 
 #include "UnicodeGlyphMap.h"// Відповідність Unicode → індекс гліфа шрифту
 
@@ -45,33 +54,6 @@ static uint32_t ReadLE32(FILE* f) {
     return (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
 }
 
-// Функція декодування одного UTF-8 символу з рядка str
-// Записує Unicode код символу у out_codepoint
-// Повертає кількість байтів, які зайняв символ у UTF-8
-static int utf8_decode(const char* str, uint32_t* out_codepoint) {
-    unsigned char c = (unsigned char)str[0];
-    if (c < 0x80) {
-        // Однобайтовий ASCII символ
-        *out_codepoint = c;
-        return 1;
-    } else if ((c & 0xE0) == 0xC0) {
-        // Два байти UTF-8
-        *out_codepoint = ((str[0] & 0x1F) << 6) | (str[1] & 0x3F);
-        return 2;
-    } else if ((c & 0xF0) == 0xE0) {
-        // Три байти UTF-8
-        *out_codepoint = ((str[0] & 0x0F) << 12) | ((str[1] & 0x3F) << 6) | (str[2] & 0x3F);
-        return 3;
-    } else if ((c & 0xF8) == 0xF0) {
-        // Чотири байти UTF-8
-        *out_codepoint = ((str[0] & 0x07) << 18) | ((str[1] & 0x3F) << 12) | ((str[2] & 0x3F) << 6) | (str[3] & 0x3F);
-        return 4;
-    }
-    // Невідомий або некоректний символ — повертаємо 0
-    *out_codepoint = 0;
-    return 1;
-}
-
 // Розмір таблиці відповідності Unicode → індекс гліфа
 static int cyr_map_size = sizeof(cyr_map) / sizeof(cyr_map[0]);
 
@@ -90,6 +72,101 @@ static int UnicodeToGlyphIndex(uint32_t codepoint) {
     return 32;
 }
 
+// Прапорці наявності таблиці Unicode у заголовках PSF1/PSF2
+#define PSF1_MODEHASTAB 0x02
+#define PSF1_MODEHASSEQ 0x04
+#define PSF2_HAS_UNICODE_TABLE 0x01
+
+// Двохрівнева таблиця Unicode → гліф: каталог на всі 0x1100 сторінок по 256 кодів
+#define PSF_UNICODE_PAGE_SIZE  256
+#define PSF_UNICODE_PAGE_COUNT (0x110000 / PSF_UNICODE_PAGE_SIZE)
+#define PSF_UNICODE_NO_GLYPH   0xFFFF
+
+// Записує відповідність codepoint → glyph у таблицю сторінок шрифту.
+// Сторінка 0 у unicodePages завжди порожня, тому каталог без запису вказує на неї
+static void PSFUnicodeMapSet(PSF_Font* font, int* page_count, uint32_t codepoint, int glyph) {
+    if (codepoint >= 0x110000 || glyph >= PSF_UNICODE_NO_GLYPH) return;
+
+    uint16_t page = font->unicodePageDir[codepoint >> 8];
+    if (page == 0) {
+        // Нова сторінка: розширюємо пул і заповнюємо її "немає гліфа"
+        uint16_t* pages = (uint16_t*)realloc(font->unicodePages,
+                                             (size_t)(*page_count + 1) * PSF_UNICODE_PAGE_SIZE * sizeof(uint16_t));
+        if (!pages) return;
+        font->unicodePages = pages;
+        for (int i = 0; i < PSF_UNICODE_PAGE_SIZE; i++)
+            pages[*page_count * PSF_UNICODE_PAGE_SIZE + i] = PSF_UNICODE_NO_GLYPH;
+        page = (uint16_t)(*page_count)++;
+        font->unicodePageDir[codepoint >> 8] = page;
+    }
+    uint16_t* slot = &font->unicodePages[page * PSF_UNICODE_PAGE_SIZE + (codepoint & 0xFF)];
+    // Перший запис для коду має пріоритет (як у kbd/setfont)
+    if (*slot == PSF_UNICODE_NO_GLYPH) *slot = (uint16_t)glyph;
+}
+
+// Розбирає таблицю Unicode, що йде у файлі одразу після гліфів.
+// PSF1: 16-бітні коди LE, 0xFFFE - початок послідовності, 0xFFFF - кінець запису гліфа.
+// PSF2: коди у UTF-8, 0xFE - початок послідовності, 0xFF - кінець запису гліфа.
+// Послідовності (кілька кодів на один гліф) пропускаються — індексуються лише одиночні коди
+static void ParsePSFUnicodeTable(PSF_Font* font, const uint8_t* table, size_t size) {
+    font->unicodePageDir = (uint16_t*)calloc(PSF_UNICODE_PAGE_COUNT, sizeof(uint16_t));
+    font->unicodePages = (uint16_t*)malloc(PSF_UNICODE_PAGE_SIZE * sizeof(uint16_t));
+    if (!font->unicodePageDir || !font->unicodePages) {
+        free(font->unicodePageDir);
+        free(font->unicodePages);
+        font->unicodePageDir = NULL;
+        font->unicodePages = NULL;
+        return;
+    }
+    for (int i = 0; i < PSF_UNICODE_PAGE_SIZE; i++) font->unicodePages[i] = PSF_UNICODE_NO_GLYPH;
+    int page_count = 1;
+
+    size_t pos = 0;
+    for (int glyph = 0; glyph < font->glyph_count && pos < size; glyph++) {
+        int in_sequence = 0;
+        if (!font->isPSF2) {
+            while (pos + 1 < size) {
+                uint16_t uc = (uint16_t)(table[pos] | (table[pos + 1] << 8));
+                pos += 2;
+                if (uc == 0xFFFF) break;
+                if (uc == 0xFFFE) { in_sequence = 1; continue; }
+                if (!in_sequence) PSFUnicodeMapSet(font, &page_count, uc, glyph);
+            }
+        } else {
+            while (pos < size) {
+                uint8_t c = table[pos];
+                if (c == 0xFF) { pos++; break; }
+                if (c == 0xFE) { in_sequence = 1; pos++; continue; }
+
+                // Декодування UTF-8 з перевіркою меж таблиці
+                int len = (c < 0x80) ? 1 : ((c & 0xE0) == 0xC0) ? 2 :
+                          ((c & 0xF0) == 0xE0) ? 3 : ((c & 0xF8) == 0xF0) ? 4 : 1;
+                if (pos + len > size) { pos = size; break; }
+                uint32_t cp = (len == 1) ? c : (uint32_t)(c & (0x7F >> len));
+                for (int i = 1; i < len; i++) cp = (cp << 6) | (table[pos + i] & 0x3F);
+                pos += len;
+
+                if (!in_sequence) PSFUnicodeMapSet(font, &page_count, cp, glyph);
+            }
+        }
+    }
+}
+
+// Пошук індексу гліфа за Unicode кодом у таблиці конкретного шрифту — O(1).
+// Якщо шрифт не має таблиці Unicode, використовується вбудована UnicodeToGlyphIndex
+int GetPSFGlyphIndex(PSF_Font font, uint32_t codepoint) {
+    if (!font.unicodePageDir) return UnicodeToGlyphIndex(codepoint);
+
+    if (codepoint < 0x110000) {
+        uint16_t glyph = font.unicodePages[font.unicodePageDir[codepoint >> 8] * PSF_UNICODE_PAGE_SIZE +
+                                           (codepoint & 0xFF)];
+        if (glyph != PSF_UNICODE_NO_GLYPH && glyph < font.glyph_count) return glyph;
+    }
+    // Символ відсутній у шрифті — гліф пробілу
+    uint16_t space = font.unicodePages[font.unicodePageDir[0] * PSF_UNICODE_PAGE_SIZE + ' '];
+    return (space != PSF_UNICODE_NO_GLYPH && space < font.glyph_count) ? space : 32;
+}
+
 // Функція завантаження PSF шрифту з файлу filename
 PSF_Font LoadPSFFont(const char* filename) {
     FILE* f = fopen(filename, "rb");
@@ -102,6 +179,7 @@ PSF_Font LoadPSFFont(const char* filename) {
     fread(magic, 1, 4, f);  // Читаємо перші 4 байти для визначення формату
 
     PSF_Font font = {0};     // Ініціалізуємо структуру шрифту нулями
+    int has_table = 0;       // Чи містить файл таблицю Unicode після гліфів
 
     if (magic[0] == PSF1_MAGIC0 && magic[1] == PSF1_MAGIC1) {
         // Якщо формат PSF1
@@ -118,6 +196,7 @@ PSF_Font LoadPSFFont(const char* filename) {
         // Виділяємо пам’ять під гліфи та читаємо їх з файлу
         font.glyphBuffer = (unsigned char*)malloc(font.glyph_count * font.glyph_bytes);
         fread(font.glyphBuffer, font.glyph_bytes, font.glyph_count, f);
+        has_table = (header.mode & (PSF1_MODEHASTAB | PSF1_MODEHASSEQ)) != 0;
     }
     else if (magic[0] == PSF2_MAGIC0 && magic[1] == PSF2_MAGIC1 &&
         magic[2] == PSF2_MAGIC2 && magic[3] == PSF2_MAGIC3) {
@@ -147,6 +226,7 @@ PSF_Font LoadPSFFont(const char* filename) {
     // Виділяємо пам’ять і читаємо гліфи
     font.glyphBuffer = (unsigned char*)malloc(font.glyph_count * font.glyph_bytes);
     fread(font.glyphBuffer, 1, font.glyph_count * font.glyph_bytes, f);
+    has_table = (header.flags & PSF2_HAS_UNICODE_TABLE) != 0;
         }
         else {
             // Якщо формат не підтримується
@@ -155,130 +235,519 @@ PSF_Font LoadPSFFont(const char* filename) {
             exit(1);
         }
 
+        // Таблиця Unicode займає решту файлу після гліфів
+        if (has_table) {
+            long table_start = ftell(f);
+            fseek(f, 0, SEEK_END);
+            long table_size = ftell(f) - table_start;
+            if (table_start >= 0 && table_size > 0) {
+                uint8_t* table = (uint8_t*)malloc((size_t)table_size);
+                fseek(f, table_start, SEEK_SET);
+                if (table && fread(table, 1, (size_t)table_size, f) == (size_t)table_size)
+                    ParsePSFUnicodeTable(&font, table, (size_t)table_size);
+                free(table);
+            }
+        }
+
         fclose(f);
         return font;
 }
 
+// Функція читання 4 байтів з пам’яті у форматі little-endian
+static uint32_t ReadLE32Mem(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Найбільша допустима ширина/висота гліфа PSF2 у пікселях
+#define PSF2_MAX_GLYPH_DIM 4096
+
+// Перевіряє заголовок PSF1/PSF2 безпосередньо у буфері data розміром size
+// і заповнює поля font. glyphBuffer вказує всередину data (без копіювання).
+// У table_offset записується зсув таблиці Unicode (0, якщо її немає).
+// Повертає 1 при успіху, 0 якщо формат не підтримується або файл обрізаний.
+static int ParsePSFHeaderInPlace(const uint8_t* data, size_t size, PSF_Font* font,
+                                 size_t* table_offset) {
+    if (size >= 4 && data[0] == PSF1_MAGIC0 && data[1] == PSF1_MAGIC1) {
+        font->isPSF2 = 0;
+        font->glyph_width = 8;
+        font->glyph_height = data[3];
+        font->glyph_bytes = data[3];
+        font->glyph_count = (data[2] & 0x01) ? 512 : 256;
+        if (font->glyph_bytes == 0 ||
+            size < 4 + (size_t)font->glyph_count * font->glyph_bytes) return 0;
+        font->glyphBuffer = (unsigned char*)(data + 4);
+        *table_offset = (data[2] & (PSF1_MODEHASTAB | PSF1_MODEHASSEQ))
+                      ? 4 + (size_t)font->glyph_count * font->glyph_bytes : 0;
+        return 1;
+    }
+    if (size >= 32 && data[0] == PSF2_MAGIC0 && data[1] == PSF2_MAGIC1 &&
+        data[2] == PSF2_MAGIC2 && data[3] == PSF2_MAGIC3) {
+        uint32_t headersize  = ReadLE32Mem(data + 8);
+        uint32_t flags       = ReadLE32Mem(data + 12);
+        uint32_t length      = ReadLE32Mem(data + 16);
+        uint32_t glyph_bytes = ReadLE32Mem(data + 20);
+        uint32_t height      = ReadLE32Mem(data + 24);
+        uint32_t width       = ReadLE32Mem(data + 28);
+
+        // Розміри обмежені, щоб добуток не переповнювався і поля int лишались додатними;
+        // гліф має вміщати всі рядки, а таблиця гліфів — файл
+        if (headersize < 32 || glyph_bytes == 0 || length > INT32_MAX ||
+            width == 0 || width > PSF2_MAX_GLYPH_DIM ||
+            height == 0 || height > PSF2_MAX_GLYPH_DIM ||
+            (uint64_t)glyph_bytes < (uint64_t)height * ((width + 7) / 8)) return 0;
+        if (headersize > size || (size - headersize) / glyph_bytes < length) return 0;
+
+        font->isPSF2 = 1;
+        font->glyph_width = (int)width;
+        font->glyph_height = (int)height;
+        font->glyph_count = (int)length;
+        font->glyph_bytes = (int)glyph_bytes;
+        font->glyphBuffer = (unsigned char*)(data + headersize);
+        *table_offset = (flags & PSF2_HAS_UNICODE_TABLE)
+                      ? headersize + (size_t)length * glyph_bytes : 0;
+        return 1;
+    }
+    return 0;
+}
+
+// Функція завантаження PSF шрифту через mmap без копіювання гліфів.
+// Файл відображається у пам’ять лише для читання (MAP_SHARED), тому кілька процесів,
+// що використовують той самий шрифт, ділять сторінки кешу ОС,
+// а glyphBuffer вказує прямо у відображення.
+PSF_Font LoadPSFFontMapped(const char* filename) {
+#ifdef _WIN32
+    // Без POSIX mmap — звичайне завантаження з копіюванням
+    return LoadPSFFont(filename);
+#else
+    PSF_Font font = {0};
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        printf("Не вдалося відкрити файл шрифту: %s\n", filename);
+        exit(1);
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        printf("Не вдалося визначити розмір файлу шрифту: %s\n", filename);
+        close(fd);
+        exit(1);
+    }
+
+    size_t size = (size_t)st.st_size;
+    void* data = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // Відображення залишається дійсним і після закриття дескриптора
+    if (data == MAP_FAILED) {
+        printf("Не вдалося відобразити файл шрифту у пам’ять: %s\n", filename);
+        exit(1);
+    }
+
+    size_t table_offset = 0;
+    if (!ParsePSFHeaderInPlace((const uint8_t*)data, size, &font, &table_offset)) {
+        printf("Формат шрифту не підтримується або файл пошкоджено\n");
+        munmap(data, size);
+        exit(1);
+    }
+
+    // Таблиця Unicode читається прямо з відображення
+    if (table_offset > 0 && table_offset < size)
+        ParsePSFUnicodeTable(&font, (const uint8_t*)data + table_offset, size - table_offset);
+
+    font.mappedData = data;
+    font.mappedSize = size;
+    return font;
+#endif
+}
+
 // Функція звільнення пам’яті, виділеної під гліфи шрифту
 void UnloadPSFFont(PSF_Font font) {
+    TextCache_RemoveFont(font);
+    free(font.unicodePageDir);
+    free(font.unicodePages);
+#ifndef _WIN32
+    if (font.mappedData) {
+        // Шрифт завантажено через LoadPSFFontMapped: гліфи лежать у відображенні
+        munmap(font.mappedData, font.mappedSize);
+        return;
+    }
+#endif
     free(font.glyphBuffer);
 }
 
 // Функція малювання одного символу (гліфа) у позиції (x,y) кольором color
+// Рядки гліфа розбиваються на серії встановлених бітів, кожна серія - один прямокутник
 void DrawPSFChar(PSF_Font font, int x, int y, int c, uint32_t color) {
     if (c < 0 || c >= font.glyph_count) return; // Перевірка коректності індексу
 
-    int width = font.glyph_width;
-    int height = font.glyph_height;
-    int bytes_per_row = (width + 7) / 8; // Кількість байтів на один рядок гліфа
     unsigned char* glyph = font.glyphBuffer + c * font.glyph_bytes; // Вказівник на гліф
+    DrawBitmapSpans(glyph, font.glyph_width, font.glyph_height, x, y, 1, color);
+}
 
-    // Проходимо по кожному рядку гліфа
-    for (int row = 0; row < height; row++) {
-        // Проходимо по кожному байту в рядку
-        for (int byte = 0; byte < bytes_per_row; byte++) {
-            unsigned char bits = glyph[row * bytes_per_row + byte]; // Поточний байт
-            // Перевіряємо кожен біт у байті
-            for (int bit = 0; bit < 8; bit++) {
-                int px = byte * 8 + bit; // Позиція пікселя по горизонталі
-                if (px >= width) break;  // Якщо вийшли за ширину символу — зупиняємось
-                if (bits & (0x80 >> bit)) {
-                    // Якщо біт встановлений — малюємо піксель
-                    DrawPixel(x + px, y + row, color);
-                }
-            }
+// Малювання рядка [text, end) без '\n' з відкиданням невидимих символів: клітинки PSF
+// однакові, тож рядок вище або нижче видимої області не декодується зовсім, символи
+// ліворуч від неї лише зсувають позицію (без пошуку гліфа), а праворуч рядок закінчується
+static void DrawPSFLine(PSF_Font font, RenderRect visible, int x, int y, const char* text, const char* end,
+                        int spacing, int scale, uint32_t color) {
+    int cellWidth = font.glyph_width * scale;
+    if (y + font.glyph_height * scale <= visible.y0 || y >= visible.y1) return;
+
+    int advance = cellWidth + spacing;
+    const char* ascii = text;
+    int xpos = x;
+    while (text < end) {
+        if (xpos >= visible.x1 && advance >= 0) return;
+
+        uint32_t codepoint = 0;
+        int bytes = utf8_next(text, end, &ascii, &codepoint);
+        text += bytes;
+        if (xpos + cellWidth > visible.x0 && xpos < visible.x1) {
+            int glyph_index = GetPSFGlyphIndex(font, codepoint);
+            if (glyph_index < 0) glyph_index = 32; // Якщо символ не знайдено — замінюємо пробілом
+            DrawPSFCharScaled(font, xpos, y, glyph_index, scale, color);
         }
+        xpos += advance;
+    }
+}
+
+// Малювання тексту [text, ...) по рядках з відкиданням рядків поза видимою областю
+static void DrawPSFLines(PSF_Font font, int x, int y, const char* text, int spacing, int scale, uint32_t color) {
+    RenderRect visible = GetVisibleRect();
+    if (visible.x0 >= visible.x1 || visible.y0 >= visible.y1) return;
+
+    int lineStep = font.glyph_height * scale + spacing;
+    int ypos = y;
+    for (;;) {
+        // Рядки йдуть донизу: якщо цей нижче видимої області, то й решта
+        if (lineStep > 0 && ypos >= visible.y1) return;
+
+        const char* end = text + strcspn(text, "\n");
+        DrawPSFLine(font, visible, x, ypos, text, end, spacing, scale, color);
+        if (*end == '\0') return;
+        text = end + 1;
+        ypos += lineStep;
     }
 }
 
 // Функція малювання тексту UTF-8 шрифтом PSF з підтримкою переносу рядків '\n'
+// (після '\n' - початок по x і зсув y вниз на висоту символу + відступ)
 void DrawPSFText(PSF_Font font, int x, int y, const char* text, int spacing, uint32_t color) {
-    int xpos = x; // Поточна позиція по горизонталі
-    int ypos = y; // Поточна позиція по вертикалі
-    while (*text) {
-        if (*text == '\n') {
-            // Обробка переносу рядка:
-            // повертаємося в початок по x та зсуваємо y вниз на висоту символу + відступ
-            xpos = x;
-            ypos += font.glyph_height + spacing;
-            text++;
-            continue;
-        }
-        uint32_t codepoint = 0;
-        int bytes = utf8_decode(text, &codepoint); // Декодуємо один UTF-8 символ
-        int glyph_index = UnicodeToGlyphIndex(codepoint); // Знаходимо індекс гліфа
-        if (glyph_index < 0) glyph_index = 32; // Якщо символ не знайдено — замінюємо пробілом
-        DrawPSFChar(font, xpos, ypos, glyph_index, color); // Малюємо символ
-        xpos += font.glyph_width + spacing; // Зсуваємо позицію по x для наступного символу
-        text += bytes; // Переходимо до наступного символу у тексті
-    }
+    // Повторюваний рядок малюється однією маскою з кешу (якщо кеш увімкнено)
+    if (TextCache_DrawText(font, x, y, text, spacing, 1, color)) return;
+
+    DrawPSFLines(font, x, y, text, spacing, 1, color);
 }
 
 void DrawPSFCharScaled(PSF_Font font, int x, int y, int c, int scale, uint32_t color) {
     if (c < 0 || c >= font.glyph_count) return;
 
-    int width = font.glyph_width;
-    int height = font.glyph_height;
-    int bytes_per_row = (width + 7) / 8;
+    // Кожна серія пікселів рядка - один прямокутник (довжина * scale) x scale
     unsigned char* glyph = font.glyphBuffer + c * font.glyph_bytes;
+    DrawBitmapSpans(glyph, font.glyph_width, font.glyph_height, x, y, scale, color);
+}
 
-    for (int row = 0; row < height; row++) {
-        for (int byte = 0; byte < bytes_per_row; byte++) {
-            unsigned char bits = glyph[row * bytes_per_row + byte];
-            for (int bit = 0; bit < 8; bit++) {
-                int px = byte * 8 + bit;
-                if (px >= width) break;
-                if (bits & (0x80 >> bit)) {
-                    // Малюємо квадрат розміром scale x scale пікселів
-                    DrawRectangle(x + px * scale, y + row * scale, scale, scale, color);
-                }
-            }
-        }
+void DrawPSFTextScaled(PSF_Font font, int x, int y, const char* text, int spacing, int scale, uint32_t color) {
+    // Повторюваний рядок малюється однією маскою з кешу (якщо кеш увімкнено)
+    if (TextCache_DrawText(font, x, y, text, spacing, scale, color)) return;
+
+    DrawPSFLines(font, x, y, text, spacing, scale, color);
+}
+
+// Чи є в гліфі хоч один встановлений піксель
+static int PSFGlyphHasPixels(PSF_Font font, int c) {
+    const unsigned char* glyph = font.glyphBuffer + c * font.glyph_bytes;
+    for (int i = 0; i < font.glyph_bytes; i++) {
+        if (glyph[i]) return 1;
     }
+    return 0;
 }
 
-void DrawPSFTextScaled(PSF_Font font, int x, int y, const char* text, int spacing, int scale, uint32_t color) {
-    int xpos = x;
-    int ypos = y;
+GlyphRun CreatePSFGlyphRun(PSF_Font font, const char* text, int spacing, int scale) {
+    GlyphRun run = { 0 };
+    run.glyph_width = font.glyph_width;
+    run.glyph_height = font.glyph_height;
+    run.scale = scale;
+    run.metrics = MeasurePSFText(font, text, spacing, scale);
+
+    int maxGlyphs = utf8_strlen(text);
+    if (maxGlyphs <= 0) return run;
+    run.glyphs = (GlyphRunGlyph*)malloc(maxGlyphs * sizeof(GlyphRunGlyph));
+    if (!run.glyphs) {
+        fprintf(stderr, "Помилка виділення пам’яті для GlyphRun\n");
+        return run;
+    }
+
+    // Ті самі позиції, що й у DrawPSFTextScaled, але від (0, 0)
+    const char* end = text + strlen(text);
+    const char* ascii = text;
+    int xpos = 0;
+    int ypos = 0;
     while (*text) {
         if (*text == '\n') {
-            xpos = x;
+            xpos = 0;
             ypos += (font.glyph_height * scale) + spacing;
             text++;
             continue;
         }
         uint32_t codepoint = 0;
-        int bytes = utf8_decode(text, &codepoint);
-        int glyph_index = UnicodeToGlyphIndex(codepoint);
+        int bytes = utf8_next(text, end, &ascii, &codepoint);
+        int glyph_index = GetPSFGlyphIndex(font, codepoint);
         if (glyph_index < 0) glyph_index = 32;
-        DrawPSFCharScaled(font, xpos, ypos, glyph_index, scale, color);
+
+        // Порожні гліфи лише зсувають позицію
+        if (glyph_index < font.glyph_count && PSFGlyphHasPixels(font, glyph_index)) {
+            GlyphRunGlyph* placed = &run.glyphs[run.count++];
+            placed->bitmap = font.glyphBuffer + glyph_index * font.glyph_bytes;
+            placed->x = xpos;
+            placed->y = ypos;
+
+            RenderRect cell = { xpos, ypos, xpos + font.glyph_width * scale, ypos + font.glyph_height * scale };
+            if (run.count == 1) {
+                run.bounds = cell;
+            } else {
+                if (cell.x0 < run.bounds.x0) run.bounds.x0 = cell.x0;
+                if (cell.y0 < run.bounds.y0) run.bounds.y0 = cell.y0;
+                if (cell.x1 > run.bounds.x1) run.bounds.x1 = cell.x1;
+                if (cell.y1 > run.bounds.y1) run.bounds.y1 = cell.y1;
+            }
+        }
         xpos += (font.glyph_width * scale) + spacing;
         text += bytes;
     }
+    return run;
 }
 
-/* strlen рахує байти, а не символи UTF-8,
- * тому для кирилиці (2-3 байти на символ) ширина вважається завищеною.
- * Використання utf8_strlen поверне правильну кількість символів. */
-int utf8_strlen(const char* s) {
-    int len = 0;
-    while (*s) {
-        uint32_t codepoint = 0;
-        int bytes = utf8_decode(s, &codepoint); // ваша функція декодування UTF-8
-        s += bytes;
-        len++;
+void UnloadPSFGlyphRun(GlyphRun run) {
+    free(run.glyphs);
+}
+
+void DrawPSFGlyphRun(const GlyphRun* run, int x, int y, uint32_t color) {
+    RenderRect visible = GetVisibleRect();
+    if (run->count == 0 || !ClipRect_Overlaps(visible, x + run->bounds.x0, y + run->bounds.y0,
+                                              x + run->bounds.x1, y + run->bounds.y1)) return;
+
+    int cellWidth = run->glyph_width * run->scale;
+    int cellHeight = run->glyph_height * run->scale;
+    for (int i = 0; i < run->count; i++) {
+        const GlyphRunGlyph* glyph = &run->glyphs[i];
+        int gx = x + glyph->x;
+        int gy = y + glyph->y;
+        if (!ClipRect_Overlaps(visible, gx, gy, gx + cellWidth, gy + cellHeight)) continue;
+        DrawBitmapSpans(glyph->bitmap, run->glyph_width, run->glyph_height, gx, gy, run->scale, color);
+    }
+}
+
+// Смуги DrawPSFGlyphRunParallel: до PARALLEL_BANDS_PER_THREAD смуг на потік, щоб потоку,
+// що звільнився, було що забрати, але не нижчі за PARALLEL_MIN_BAND_ROWS рядків
+#define PARALLEL_BANDS_PER_THREAD 4
+#define PARALLEL_MIN_BAND_ROWS 16
+
+// Спільні дані смуг DrawPSFGlyphRunParallel (лише читаються потоками, крім bandTargets[band])
+typedef struct {
+    RenderTarget* target;
+    const GlyphRun* run;
+    int x, y;
+    uint32_t color;
+    RenderRect visible;         // Видима частина цілі (з прямокутником відсікання)
+    int top;                    // Перший рядок першої смуги
+    int bandRows;               // Висота смуги
+    const int* bandStart;       // Гліфи смуги b: bandGlyphs[bandStart[b] .. bandStart[b + 1])
+    const int* bandGlyphs;
+    RenderTarget* bandTargets;  // Ціль кожної смуги (змінена область потім переноситься в target)
+} GlyphRunBands;
+
+static void DrawPSFGlyphRunBand(int band, void* user) {
+    GlyphRunBands* p = (GlyphRunBands*)user;
+    const GlyphRun* run = p->run;
+    int y0 = p->top + band * p->bandRows;
+    RenderTarget* bandTarget = &p->bandTargets[band];
+    *bandTarget = RenderTarget_Band(p->target, y0, y0 + p->bandRows);
+
+    RenderRect clip = { p->visible.x0, p->visible.y0 - y0, p->visible.x1, p->visible.y1 - y0 };
+    for (int i = p->bandStart[band]; i < p->bandStart[band + 1]; i++) {
+        const GlyphRunGlyph* glyph = &run->glyphs[p->bandGlyphs[i]];
+        RenderTarget_DrawBitmapClipped(bandTarget, clip, glyph->bitmap, run->glyph_width, run->glyph_height,
+                                       p->x + glyph->x, p->y + glyph->y - y0, run->scale, p->color);
     }
-    return len;
+}
+
+// Смуги [first, last], які перетинає гліф, або 0, якщо гліф поза рядками [top, bottom)
+// або поза стовпцями видимої області
+static int GlyphRunGlyphBands(const GlyphRun* run, int i, int x, int y, RenderRect visible,
+                              int top, int bottom, int bandRows, int* first, int* last) {
+    int gx = x + run->glyphs[i].x;
+    if (gx >= visible.x1 || gx + run->glyph_width * run->scale <= visible.x0) return 0;
+
+    int gy0 = y + run->glyphs[i].y;
+    int gy1 = gy0 + run->glyph_height * run->scale;
+    if (gy0 < top) gy0 = top;
+    if (gy1 > bottom) gy1 = bottom;
+    if (gy0 >= gy1) return 0;
+    *first = (gy0 - top) / bandRows;
+    *last = (gy1 - 1 - top) / bandRows;
+    return 1;
+}
+
+void DrawPSFGlyphRunParallel(RenderTarget* target, const GlyphRun* run, int x, int y, uint32_t color) {
+    if (!target) target = GetActiveRenderTarget();
+    if (!target) {
+        DrawPSFGlyphRun(run, x, y, color);
+        return;
+    }
+
+    // Видима частина цілі і її рядки, які займає текст
+    RenderRect visible = { 0, 0, target->width, target->height };
+    visible = ClipRect_Intersect(visible, GetClipRect());
+    if (run->count == 0 || !ClipRect_Overlaps(visible, x + run->bounds.x0, y + run->bounds.y0,
+                                              x + run->bounds.x1, y + run->bounds.y1)) return;
+    int top = (y + run->bounds.y0 > visible.y0) ? y + run->bounds.y0 : visible.y0;
+    int bottom = (y + run->bounds.y1 < visible.y1) ? y + run->bounds.y1 : visible.y1;
+
+    int threads = RenderPool_GetThreadCount();
+    int rows = bottom - top;
+    int bandRows = (rows + threads * PARALLEL_BANDS_PER_THREAD - 1) / (threads * PARALLEL_BANDS_PER_THREAD);
+    if (bandRows < PARALLEL_MIN_BAND_ROWS) bandRows = PARALLEL_MIN_BAND_ROWS;
+    int bands = (rows + bandRows - 1) / bandRows;
+
+    // Гліфи по смугах (гліф на межі смуг потрапляє в кожну): підрахунок, зсуви, розкладка
+    int* bandStart = NULL;
+    int* bandGlyphs = NULL;
+    RenderTarget* bandTargets = NULL;
+    int first, last;
+    if (bands > 1 && threads > 1) {
+        bandStart = (int*)calloc(bands + 1, sizeof(int));
+        bandTargets = (RenderTarget*)malloc(bands * sizeof(RenderTarget));
+    }
+    if (bandStart && bandTargets) {
+        for (int i = 0; i < run->count; i++) {
+            if (!GlyphRunGlyphBands(run, i, x, y, visible, top, bottom, bandRows, &first, &last)) continue;
+            for (int b = first; b <= last; b++) bandStart[b + 1]++;
+        }
+        for (int b = 0; b < bands; b++) bandStart[b + 1] += bandStart[b];
+        bandGlyphs = (int*)malloc((bandStart[bands] + bands) * sizeof(int));
+    }
+
+    if (!bandGlyphs) {
+        // Одна смуга, один потік або немає пам’яті - малюємо в цьому потоці
+        for (int i = 0; i < run->count; i++) {
+            const GlyphRunGlyph* glyph = &run->glyphs[i];
+            RenderTarget_DrawBitmapClipped(target, visible, glyph->bitmap, run->glyph_width, run->glyph_height,
+                                           x + glyph->x, y + glyph->y, run->scale, color);
+        }
+        free(bandTargets);
+        free(bandStart);
+        return;
+    }
+
+    // Хвіст bandGlyphs - позиції заповнення кожної смуги
+    int* bandFill = bandGlyphs + bandStart[bands];
+    for (int b = 0; b < bands; b++) bandFill[b] = bandStart[b];
+    for (int i = 0; i < run->count; i++) {
+        if (!GlyphRunGlyphBands(run, i, x, y, visible, top, bottom, bandRows, &first, &last)) continue;
+        for (int b = first; b <= last; b++) bandGlyphs[bandFill[b]++] = i;
+    }
+
+    GlyphRunBands p = { target, run, x, y, color, visible, top, bandRows, bandStart, bandGlyphs, bandTargets };
+    RenderPool_Run(bands, DrawPSFGlyphRunBand, &p);
+
+    // Змінені області смуг - у змінену область цілі
+    for (int b = 0; b < bands; b++) {
+        const RenderTarget* band = &bandTargets[b];
+        if (band->dirty_x0 >= band->dirty_x1) continue;
+        int y0 = top + b * bandRows;
+        RenderTarget_MarkDirty(target, band->dirty_x0, y0 + band->dirty_y0, band->dirty_x1, y0 + band->dirty_y1);
+    }
+
+    free(bandGlyphs);
+    free(bandTargets);
+    free(bandStart);
+}
+
+void DrawPSFTextScaledParallel(RenderTarget* target, PSF_Font font, int x, int y, const char* text,
+                               int spacing, int scale, uint32_t color) {
+    GlyphRun run = CreatePSFGlyphRun(font, text, spacing, scale);
+    DrawPSFGlyphRunParallel(target, &run, x, y, color);
+    UnloadPSFGlyphRun(run);
+}
+
+// Один прохід по тексту: межі і ширина кожного рядка (у lines та/або lineWidths,
+// не більше maxLines) і найбільша ширина (у maxWidth). Гліфи PSF однакової ширини
+// (відсутні замінюються гліфом 32), тож таблиця ширин не потрібна і гліфи не шукаються -
+// досить порахувати символи рядка так само, як їх декодує малювання
+static int MeasurePSFLines(PSF_Font font, const char* text, int spacing, int scale,
+                           TextLine* lines, int* lineWidths, int maxLines, int* maxWidth)
+{
+    *maxWidth = 0;
+    if (!text || !*text) return 0;
+
+    int advance = font.glyph_width * scale + spacing;
+    const char* base = text;
+    int lineCount = 0;
+
+    for (;;) {
+        // Символи рядка рахуються одним викликом: ASCII - по 16 байтів за раз
+        size_t length = strcspn(text, "\n");
+        int chars = (int)utf8_length(text, length);
+        int lineWidth = chars > 0 ? chars * advance - spacing : 0;
+
+        if (lineCount < maxLines) {
+            if (lines) {
+                lines[lineCount].start = (int)(text - base);
+                lines[lineCount].length = (int)length;
+                lines[lineCount].width = lineWidth;
+            }
+            if (lineWidths) lineWidths[lineCount] = lineWidth;
+        }
+        if (lineWidth > *maxWidth) *maxWidth = lineWidth;
+        lineCount++;
+
+        text += length;
+        if (*text == '\0') break;
+        text++;
+    }
+    return lineCount;
+}
+
+int MeasurePSFTextLines(PSF_Font font, const char* text, int spacing, int scale,
+                        int* lineWidths, int maxLines)
+{
+    int maxWidth;
+    return MeasurePSFLines(font, text, spacing, scale, NULL, lineWidths, maxLines, &maxWidth);
+}
+
+TextMetrics MeasurePSFText(PSF_Font font, const char* text, int spacing, int scale)
+{
+    TextMetrics metrics = { 0, 0, 0 };
+    metrics.lineCount = MeasurePSFLines(font, text, spacing, scale, NULL, NULL, 0, &metrics.width);
+    if (metrics.lineCount > 0)
+        metrics.height = metrics.lineCount * font.glyph_height * scale + (metrics.lineCount - 1) * spacing;
+    return metrics;
+}
+
+int LayoutPSFTextLines(PSF_Font font, const char* text, int spacing, int scale,
+                       TextLine* lines, int maxLines)
+{
+    int maxWidth;
+    return MeasurePSFLines(font, text, spacing, scale, lines, NULL, maxLines, &maxWidth);
+}
+
+// Малює рядок довжиною length байтів (без '\n') прямо з вихідного тексту
+void DrawPSFTextLine(PSF_Font font, int x, int y, const char* text, int length, int spacing, int scale, uint32_t color) {
+    RenderRect visible = GetVisibleRect();
+    if (visible.x0 >= visible.x1 || visible.y0 >= visible.y1) return;
+
+    DrawPSFLine(font, visible, x, y, text, text + length, spacing, scale, color);
 }
 
 // Малює рядок тексту без масштабування з пробілами та кирилицею
 void DrawPSFCharLine(PSF_Font font, int x, int y, const char* text, int spacing, uint32_t color) {
     int xpos = x;
     const char* p = text;
+    const char* end = text + strlen(text);
+    const char* ascii = text;
     while (*p) {
         uint32_t codepoint = 0;
-        int bytes = utf8_decode(p, &codepoint);
-        int glyph_index = UnicodeToGlyphIndex(codepoint);
+        int bytes = utf8_next(p, end, &ascii, &codepoint);
+        int glyph_index = GetPSFGlyphIndex(font, codepoint);
         if (glyph_index < 0) glyph_index = 32;
         DrawPSFChar(font, xpos, y, glyph_index, color);
         xpos += font.glyph_width + spacing;
@@ -290,10 +759,12 @@ void DrawPSFCharLine(PSF_Font font, int x, int y, const char* text, int spacing,
 void DrawPSFCharLineScaled(PSF_Font font, int x, int y, const char* text, int spacing, int scale, uint32_t color) {
     int xpos = x;
     const char* p = text;
+    const char* end = text + strlen(text);
+    const char* ascii = text;
     while (*p) {
         uint32_t codepoint = 0;
-        int bytes = utf8_decode(p, &codepoint);
-        int glyph_index = UnicodeToGlyphIndex(codepoint);
+        int bytes = utf8_next(p, end, &ascii, &codepoint);
+        int glyph_index = GetPSFGlyphIndex(font, codepoint);
         if (glyph_index < 0) glyph_index = 32;
         DrawPSFCharScaled(font, xpos, y, glyph_index, scale, color);
         xpos += (font.glyph_width * scale) + spacing;
@@ -301,53 +772,117 @@ void DrawPSFCharLineScaled(PSF_Font font, int x, int y, const char* text, int sp
     }
 }
 
+// Непрозорий рядок [text, end) без '\n': кожна клітинка малюється з фоном за один прохід
+// (DrawBitmapOpaque), проміжки spacing між клітинками і залишок рядка до right
+// заливаються фоном. Невидимі клітинки відкидаються так само, як у DrawPSFLine
+static void DrawPSFLineOpaque(PSF_Font font, RenderRect visible, int x, int y, int right,
+                              const char* text, const char* end, int spacing, int scale,
+                              uint32_t fg, uint32_t bg) {
+    int cellWidth = font.glyph_width * scale;
+    int cellHeight = font.glyph_height * scale;
+    if (y + cellHeight <= visible.y0 || y >= visible.y1) return;
+
+    int advance = cellWidth + spacing;
+    int xpos = x;
+    int filled = x; // рядок уже залито до цього стовпця
+    const char* ascii = text;
+    while (text < end) {
+        if (xpos >= visible.x1 && advance >= 0) break;
+
+        uint32_t codepoint = 0;
+        int bytes = utf8_next(text, end, &ascii, &codepoint);
+        text += bytes;
+        if (xpos + cellWidth > visible.x0) {
+            int glyph_index = GetPSFGlyphIndex(font, codepoint);
+            if (glyph_index < 0) glyph_index = 32; // Якщо символ не знайдено — замінюємо пробілом
+            if (xpos > filled) DrawRectangle(filled, y, xpos - filled, cellHeight, bg);
+            if (glyph_index < font.glyph_count) {
+                DrawBitmapOpaque(font.glyphBuffer + glyph_index * font.glyph_bytes,
+                                 font.glyph_width, font.glyph_height, xpos, y, scale, fg, bg);
+            } else {
+                DrawRectangle(xpos, y, cellWidth, cellHeight, bg);
+            }
+        }
+        filled = xpos + cellWidth;
+        xpos += advance;
+    }
+    if (right > filled) DrawRectangle(filled, y, right - filled, cellHeight, bg);
+}
+
+// Непрозорий блок тексту [x, x + width) x [y, y + висота тексту): рядки клітинками,
+// проміжки spacing між рядками - фоном
+static void DrawPSFBlockOpaque(PSF_Font font, int x, int y, int width, const char* text,
+                               int spacing, int scale, uint32_t fg, uint32_t bg) {
+    RenderRect visible = GetVisibleRect();
+    if (visible.x0 >= visible.x1 || visible.y0 >= visible.y1) return;
+
+    int cellHeight = font.glyph_height * scale;
+    int lineStep = cellHeight + spacing;
+    int ypos = y;
+    for (;;) {
+        if (lineStep > 0 && ypos >= visible.y1) return;
+
+        const char* end = text + strcspn(text, "\n");
+        DrawPSFLineOpaque(font, visible, x, ypos, x + width, text, end, spacing, scale, fg, bg);
+        if (*end == '\0') return;
+        if (spacing > 0) DrawRectangle(x, ypos + cellHeight, width, spacing, bg);
+        text = end + 1;
+        ypos += lineStep;
+    }
+}
+
+// Непрозорий текст, як у терміналі: кожен піксель прямокутника тексту (MeasurePSFText)
+// отримує колір fg або bg за один прохід по клітинках, без окремої заливки фону.
+// З від’ємним spacing клітинки перекриваються, і пізніша затирає попередню
+void DrawPSFTextOpaque(PSF_Font font, int x, int y, const char* text, int spacing, int scale,
+                       uint32_t fg, uint32_t bg) {
+    if (!text || !*text || scale < 1) return;
+
+    TextMetrics metrics = MeasurePSFText(font, text, spacing, scale);
+    DrawPSFBlockOpaque(font, x, y, metrics.width, text, spacing, scale, fg, bg);
+}
+
 // Малюємо текст з інверсним фоном та додатковою товщиною рамки (borderThickness)
 // фоновий прямокутник має враховувати padding і borderThickness для точного розміру
 // font - структура PSF шрифту
 // (x, y) - координати початку тексту
-// text - текст для малювання (підтримує '\n')
+// text - текст для малювання (підтримує '\n', довжина і кількість рядків не обмежені)
 // spacing - відступ між символами
 // textColor - колір тексту
 // padding - внутрішній відступ (зовнішній запас від тексту до рамки)
 // borderThickness - товщина рамки (кількість проходів для малювання рамки)
 void DrawPSFTextWithInvertedBackground(PSF_Font font, int x, int y, const char* text, int spacing, uint32_t textColor, int padding, int borderThickness)
 {
-    const char* lines[20];   // Масив рядків для обробки багаторядкового тексту
-    int lineCount = 0;       // Лічильник рядків
-    char tempText[512];      // Буфер для копіювання тексту без втрати оригіналу
-
-    // Копіюємо текст, щоб безпечно розбивати
-    strncpy(tempText, text, sizeof(tempText) - 1);
-    tempText[sizeof(tempText) - 1] = '\0';
-
-    // Розбиваємо текст за '\n' на окремі рядки
-    char* line = strtok(tempText, "\n");
-    while (line != NULL && lineCount < 20)
-    {
-        lines[lineCount++] = line;
-        line = strtok(NULL, "\n");
-    }
-
-    // Знаходимо максимальну кількість символів у рядках (для ширини фону)
-    int maxLineChars = 0;
-    for (int i = 0; i < lineCount; i++)
-    {
-        int len = utf8_strlen(lines[i]); // Підрахунок символів у рядку
-        if (len > maxLineChars)
-            maxLineChars = len;
-    }
+    DrawPSFTextScaledWithInvertedBackground(font, x, y, text, spacing, 1, textColor, padding, borderThickness);
+}
 
-    // Обчислюємо ширину фону з урахуванням символів, відступів, padding та borderThickness
-    float bgWidth  = maxLineChars * (font.glyph_width + spacing) - spacing + 2 * padding + 2 * borderThickness;
+// Аналогічно масштабована версія з урахуванням borderThickness
+void DrawPSFTextScaledWithInvertedBackground(PSF_Font font, int x, int y, const char* text, int spacing, int scale, uint32_t textColor, int padding, int borderThickness)
+{
+    // Розмір тексту одним проходом: ширина найширшого рядка і висота всіх рядків
+    TextMetrics metrics = MeasurePSFText(font, text, spacing, scale);
 
-    // Обчислюємо висоту фону з урахуванням кількості рядків, відступів, padding та borderThickness
-    float bgHeight = lineCount * font.glyph_height + (lineCount - 1) * spacing + 2 * padding + 2 * borderThickness;
+    // Обчислюємо ширину і висоту з урахуванням padding та borderThickness
+    int bgWidth  = metrics.width + 2 * padding + 2 * borderThickness;
+    int bgHeight = metrics.height + 2 * padding + 2 * borderThickness;
 
     // Визначаємо колір фону як контрастний та інверсний до кольору тексту
     uint32_t bgColor = GetContrastInvertColor(textColor);
 
-    // Малюємо залитий прямокутник фону, враховуючи borderThickness та padding
-    DrawRectangle(x - padding - borderThickness, y - padding - borderThickness, bgWidth, bgHeight, bgColor);
+    // Непрозорий текст (DrawPSFTextOpaque) сам заливає свій прямокутник, тож фоном
+    // заливається лише поле padding навколо нього, і кожен піксель пишеться один раз.
+    // Від’ємні відступи перекривають текст - тоді фон під текстом і текст поверх нього
+    int opaque = text && spacing >= 0 && padding >= 0 && borderThickness >= 0 && scale >= 1;
+    if (opaque) {
+        int innerWidth = metrics.width + 2 * padding;
+        DrawRectangle(x - padding, y - padding, innerWidth, padding, bgColor);
+        DrawRectangle(x - padding, y + metrics.height, innerWidth, padding, bgColor);
+        DrawRectangle(x - padding, y, padding, metrics.height, bgColor);
+        DrawRectangle(x + metrics.width, y, padding, metrics.height, bgColor);
+    } else {
+        // Малюємо залитий прямокутник фону, враховуючи borderThickness та padding
+        DrawRectangle(x - padding - borderThickness, y - padding - borderThickness, bgWidth, bgHeight, bgColor);
+    }
 
     // Малюємо рамку товщиною borderThickness, роблячи кілька проходів для товщини
     for (int i = 0; i < borderThickness; i++)
@@ -356,68 +891,248 @@ void DrawPSFTextWithInvertedBackground(PSF_Font font, int x, int y, const char*
                            bgWidth - 2 * i, bgHeight - 2 * i, textColor);
     }
 
-    // Малюємо текстовий рядок поверх фону
-    int xpos = x;
-    int ypos = y;
-    for (int i = 0; i < lineCount; i++)
-    {
-        DrawPSFCharLine(font, xpos, ypos, lines[i], spacing, textColor);
-        ypos += font.glyph_height + spacing; // Переходимо до наступного рядка
+    if (opaque) {
+        DrawPSFBlockOpaque(font, x, y, metrics.width, text, spacing, scale, textColor, bgColor);
+        return;
     }
+
+    // Малюємо масштабований текст (через DrawPSFTextScaled, щоб постійні підписи
+    // бралися з кешу рядків)
+    DrawPSFTextScaled(font, x, y, text, spacing, scale, textColor);
 }
 
-// Аналогічно масштабована версія з урахуванням borderThickness
-void DrawPSFTextScaledWithInvertedBackground(PSF_Font font, int x, int y, const char* text, int spacing, int scale, uint32_t textColor, int padding, int borderThickness)
+
+// Поля PSF_Font, потрібні для малювання, без байтів вирівнювання: DamageTracker
+// порівнює команди memcmp, а присвоєння цілої структури не визначає вміст її
+// вирівнювання. Спершу вказівники, потім int (з явним доповненням до парної кількості)
+typedef struct {
+    unsigned char* glyphBuffer;
+    uint16_t* unicodePageDir;
+    uint16_t* unicodePages;
+    int isPSF2, glyph_width, glyph_height, glyph_count, glyph_bytes;
+    int reserved;                       // завжди 0
+} RecordedPSFFont;
+
+_Static_assert(sizeof(RecordedPSFFont) == 3 * sizeof(void*) + 6 * sizeof(int),
+               "RecordedPSFFont must not contain padding");
+
+static void RecordPSFFont(RecordedPSFFont* r, const PSF_Font* font)
 {
-    const char* lines[20];   // Масив рядків
-    int lineCount = 0;       // Лічильник
-    char tempText[512];      // Буфер для копіювання
+    r->glyphBuffer = font->glyphBuffer;
+    r->unicodePageDir = font->unicodePageDir;
+    r->unicodePages = font->unicodePages;
+    r->isPSF2 = font->isPSF2;
+    r->glyph_width = font->glyph_width;
+    r->glyph_height = font->glyph_height;
+    r->glyph_count = font->glyph_count;
+    r->glyph_bytes = font->glyph_bytes;
+    r->reserved = 0;
+}
 
-    // Копіюємо текст
-    strncpy(tempText, text, sizeof(tempText) -1);
-    tempText[sizeof(tempText) -1] = '\0';
+static PSF_Font RecordedPSFFont_Get(const RecordedPSFFont* r)
+{
+    PSF_Font font = { 0 };
+    font.glyphBuffer = r->glyphBuffer;
+    font.unicodePageDir = r->unicodePageDir;
+    font.unicodePages = r->unicodePages;
+    font.isPSF2 = r->isPSF2;
+    font.glyph_width = r->glyph_width;
+    font.glyph_height = r->glyph_height;
+    font.glyph_count = r->glyph_count;
+    font.glyph_bytes = r->glyph_bytes;
+    return font;
+}
 
-    // Розбиваємо по '\n'
-    char* line = strtok(tempText, "\n");
-    while (line != NULL && lineCount < 20)
-    {
-        lines[lineCount++] = line;
-        line = strtok(NULL, "\n");
-    }
+// Параметри тексту, записаного в кадр DamageTracker (рядок копіюється слідом)
+typedef struct {
+    RecordedPSFFont font;
+    int x, y;
+    int spacing, scale;
+    uint32_t textColor, bgColor;
+    int padding, borderThickness;
+    char text[];
+} RecordedPSFText;
 
-    // Знаходимо максимальну кількість символів
-    int maxLineChars = 0;
-    for (int i = 0; i < lineCount; i++)
-    {
-        int len = utf8_strlen(lines[i]);
-        if (len > maxLineChars)
-            maxLineChars = len;
+static void DrawRecordedPSFText(const void* data, int dx, int dy)
+{
+    const RecordedPSFText* t = (const RecordedPSFText*)data;
+    DrawPSFTextScaled(RecordedPSFFont_Get(&t->font), t->x + dx, t->y + dy, t->text, t->spacing, t->scale, t->textColor);
+}
+
+static void DrawRecordedPSFTextOpaque(const void* data, int dx, int dy)
+{
+    const RecordedPSFText* t = (const RecordedPSFText*)data;
+    DrawPSFTextOpaque(RecordedPSFFont_Get(&t->font), t->x + dx, t->y + dy, t->text, t->spacing, t->scale, t->textColor, t->bgColor);
+}
+
+static void DrawRecordedPSFTextWithInvertedBackground(const void* data, int dx, int dy)
+{
+    const RecordedPSFText* t = (const RecordedPSFText*)data;
+    DrawPSFTextScaledWithInvertedBackground(RecordedPSFFont_Get(&t->font), t->x + dx, t->y + dy, t->text, t->spacing, t->scale,
+                                            t->textColor, t->padding, t->borderThickness);
+}
+
+// Межі клітинок усіх символів тексту так, як їх розставляє DrawPSFTextScaled
+// (з від’ємним spacing клітинки можуть виходити ліворуч і вгору від (x, y))
+static RenderRect PSFTextBounds(PSF_Font font, int x, int y, const char* text, int spacing, int scale)
+{
+    RenderRect bounds = { 0, 0, 0, 0 };
+    int cellWidth = font.glyph_width * scale;
+    int cellHeight = font.glyph_height * scale;
+    if (!text || cellWidth <= 0 || cellHeight <= 0) return bounds;
+
+    int empty = 1;
+    int ypos = y;
+    for (;;) {
+        size_t length = strcspn(text, "\n");
+        int count = (int)utf8_length(text, length);
+        if (count > 0) {
+            // Перша і остання клітинки рядка визначають його межі
+            int last = x + (count - 1) * (cellWidth + spacing);
+            RenderRect line = { x < last ? x : last, ypos, 0, ypos + cellHeight };
+            line.x1 = (x > last ? x : last) + cellWidth;
+            if (empty) {
+                bounds = line;
+                empty = 0;
+            } else {
+                if (line.x0 < bounds.x0) bounds.x0 = line.x0;
+                if (line.y0 < bounds.y0) bounds.y0 = line.y0;
+                if (line.x1 > bounds.x1) bounds.x1 = line.x1;
+                if (line.y1 > bounds.y1) bounds.y1 = line.y1;
+            }
+        }
+        if (text[length] != '\n') break;
+        text += length + 1;
+        ypos += cellHeight + spacing;
     }
+    return bounds;
+}
 
-    // Обчислюємо ширину і висоту з урахуванням масштабу та borderThickness
-    float bgWidth  = maxLineChars * (font.glyph_width * scale + spacing) - spacing + 2 * padding + 2 * borderThickness;
-    float bgHeight = lineCount * (font.glyph_height * scale) + (lineCount -1) * spacing + 2 * padding + 2 * borderThickness;
+// Параметри тексту і копія рядка (length байтів без нуля) у буфері команди
+static void FillRecordedPSFText(RecordedPSFText* t, PSF_Font font, int x, int y, const char* text,
+                                size_t length, int spacing, int scale, uint32_t textColor)
+{
+    RecordPSFFont(&t->font, &font);
+    t->x = x;
+    t->y = y;
+    t->spacing = spacing;
+    t->scale = scale;
+    t->textColor = textColor;
+    memcpy(t->text, text, length + 1);
+}
 
-    // Колір фону
-    uint32_t bgColor = GetContrastInvertColor(textColor);
+// Запис тексту в кадр: параметри і копія рядка
+static RecordedPSFText* RecordPSFText(DamageTracker* tracker, RenderRect bounds, DamageDrawFunc draw,
+                                      PSF_Font font, int x, int y, const char* text,
+                                      int spacing, int scale, uint32_t textColor)
+{
+    size_t length = strlen(text);
+    RecordedPSFText* t = DamageTracker_Record(tracker, bounds, draw, sizeof(RecordedPSFText) + length + 1);
+    if (!t) return NULL;
+    FillRecordedPSFText(t, font, x, y, text, length, spacing, scale, textColor);
+    return t;
+}
+
+// Запис тексту в список малювання. NULL - список уже виконано, і текст треба намалювати одразу
+static RecordedPSFText* QueuePSFText(DrawList* list, RenderRect bounds, uint64_t state, DamageDrawFunc draw,
+                                     PSF_Font font, int x, int y, const char* text,
+                                     int spacing, int scale, uint32_t textColor)
+{
+    size_t length = strlen(text);
+    RecordedPSFText* t = DrawList_Record(list, bounds, state, draw, sizeof(RecordedPSFText) + length + 1);
+    if (!t) return NULL;
+    FillRecordedPSFText(t, font, x, y, text, length, spacing, scale, textColor);
+    return t;
+}
 
-    // Малюємо фон
-    DrawRectangle(x - padding - borderThickness, y - padding - borderThickness, bgWidth, bgHeight, bgColor);
+void RecordPSFTextScaled(DamageTracker* tracker, PSF_Font font, int x, int y, const char* text,
+                         int spacing, int scale, uint32_t color)
+{
+    RenderRect bounds = PSFTextBounds(font, x, y, text, spacing, scale);
+    if (bounds.x0 >= bounds.x1) return; // у тексті немає символів
 
-    // Малюємо рамку
-    for (int i = 0; i < borderThickness; i++)
-    {
-        DrawRectangleLines(x - padding - borderThickness + i, y - padding - borderThickness + i,
-                           bgWidth - 2 * i, bgHeight - 2 * i, textColor);
+    RecordPSFText(tracker, bounds, DrawRecordedPSFText, font, x, y, text, spacing, scale, color);
+}
+
+// Межі непрозорого тексту: прямокутник тексту разом з клітинками, що можуть за нього
+// виходити (від’ємний spacing)
+static RenderRect PSFOpaqueTextBounds(PSF_Font font, int x, int y, const char* text, int spacing, int scale)
+{
+    TextMetrics metrics = MeasurePSFText(font, text, spacing, scale);
+    RenderRect bounds = { x, y, x + metrics.width, y + metrics.height };
+    RenderRect cells = PSFTextBounds(font, x, y, text, spacing, scale);
+    if (cells.x0 < cells.x1) {
+        if (cells.x0 < bounds.x0) bounds.x0 = cells.x0;
+        if (cells.y0 < bounds.y0) bounds.y0 = cells.y0;
+        if (cells.x1 > bounds.x1) bounds.x1 = cells.x1;
+        if (cells.y1 > bounds.y1) bounds.y1 = cells.y1;
     }
+    return bounds;
+}
 
-    // Малюємо масштабований текст по рядках
-    int xpos = x;
-    int ypos = y;
-    for (int i=0; i<lineCount; i++)
-    {
-        DrawPSFCharLineScaled(font, xpos, ypos, lines[i], spacing, scale, textColor);
-        ypos += font.glyph_height * scale + spacing;
+void RecordPSFTextOpaque(DamageTracker* tracker, PSF_Font font, int x, int y, const char* text,
+                         int spacing, int scale, uint32_t fg, uint32_t bg)
+{
+    if (!text || !*text || scale < 1) return;
+
+    RenderRect bounds = PSFOpaqueTextBounds(font, x, y, text, spacing, scale);
+    if (bounds.x0 >= bounds.x1 || bounds.y0 >= bounds.y1) return;
+
+    RecordedPSFText* t = RecordPSFText(tracker, bounds, DrawRecordedPSFTextOpaque, font, x, y, text, spacing, scale, fg);
+    if (t) t->bgColor = bg;
+}
+
+void RecordPSFTextScaledWithInvertedBackground(DamageTracker* tracker, PSF_Font font, int x, int y,
+                                               const char* text, int spacing, int scale,
+                                               uint32_t textColor, int padding, int borderThickness)
+{
+    if (!text) return;
+
+    // Фон з рамкою (як у DrawPSFTextScaledWithInvertedBackground) разом з клітинками,
+    // що можуть за нього виходити
+    TextMetrics metrics = MeasurePSFText(font, text, spacing, scale);
+    RenderRect bounds = { x - padding - borderThickness, y - padding - borderThickness, 0, 0 };
+    bounds.x1 = bounds.x0 + metrics.width + 2 * padding + 2 * borderThickness;
+    bounds.y1 = bounds.y0 + metrics.height + 2 * padding + 2 * borderThickness;
+
+    RenderRect ink = PSFTextBounds(font, x, y, text, spacing, scale);
+    if (ink.x0 < ink.x1) {
+        if (ink.x0 < bounds.x0) bounds.x0 = ink.x0;
+        if (ink.y0 < bounds.y0) bounds.y0 = ink.y0;
+        if (ink.x1 > bounds.x1) bounds.x1 = ink.x1;
+        if (ink.y1 > bounds.y1) bounds.y1 = ink.y1;
     }
+
+    RecordedPSFText* t = RecordPSFText(tracker, bounds, DrawRecordedPSFTextWithInvertedBackground,
+                                       font, x, y, text, spacing, scale, textColor);
+    if (!t) return;
+    t->padding = padding;
+    t->borderThickness = borderThickness;
 }
 
+void QueuePSFTextScaled(DrawList* list, PSF_Font font, int x, int y, const char* text,
+                        int spacing, int scale, uint32_t color)
+{
+    RenderRect bounds = PSFTextBounds(font, x, y, text, spacing, scale);
+    if (bounds.x0 >= bounds.x1) return; // у тексті немає символів
+
+    if (!QueuePSFText(list, bounds, DrawList_State(font.glyphBuffer, color), DrawRecordedPSFText,
+                      font, x, y, text, spacing, scale, color))
+        DrawPSFTextScaled(font, x, y, text, spacing, scale, color);
+}
+
+void QueuePSFTextOpaque(DrawList* list, PSF_Font font, int x, int y, const char* text,
+                        int spacing, int scale, uint32_t fg, uint32_t bg)
+{
+    if (!text || !*text || scale < 1) return;
+
+    RenderRect bounds = PSFOpaqueTextBounds(font, x, y, text, spacing, scale);
+    if (bounds.x0 >= bounds.x1 || bounds.y0 >= bounds.y1) return;
+
+    // Обидва кольори - частина стану
+    uint64_t state = DrawList_State(font.glyphBuffer, fg) ^ ((uint64_t)(bg & 0xFFFFFF) << 32);
+    RecordedPSFText* t = QueuePSFText(list, bounds, state, DrawRecordedPSFTextOpaque,
+                                      font, x, y, text, spacing, scale, fg);
+    if (t) t->bgColor = bg;
+    else DrawPSFTextOpaque(font, x, y, text, spacing, scale, fg, bg);
+}
@@ -3,9 +3,12 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include "utf8.h"
 #include "graphics.h"
 #include "gfx.h"
 #include "display.h"
+#include "damage.h"
+#include "draw_list.h"
 
 // Структура шрифту PSF1/PSF2
 typedef struct {
@@ -15,14 +18,58 @@ typedef struct {
     int glyph_count;            // Кількість гліфів (символів) у шрифті
     int glyph_bytes;            // Розмір одного гліфа в байтах
     unsigned char* glyphBuffer; // Вказівник на буфер з бінарними даними гліфів
+    void* mappedData;           // Відображення файлу у пам’ять (LoadPSFFontMapped) або NULL
+    size_t mappedSize;          // Розмір відображення в байтах
+    uint16_t* unicodePageDir;   // Каталог сторінок таблиці Unicode (NULL - таблиці немає)
+    uint16_t* unicodePages;     // Сторінки по 256 індексів гліфів; сторінка 0 порожня
 } PSF_Font;
 
+// Розмір тексту в пікселях
+typedef struct {
+    int width;      // ширина найширшого рядка
+    int height;     // висота всіх рядків разом з інтервалами між ними
+    int lineCount;  // кількість рядків
+} TextMetrics;
+
+// Рядок розкладеного тексту (LayoutPSFTextLines)
+typedef struct {
+    int start;      // зсув першого байта рядка в тексті
+    int length;     // довжина рядка в байтах (без '\n')
+    int width;      // ширина рядка в пікселях
+} TextLine;
+
+// Гліф заздалегідь розібраного тексту (GlyphRun)
+typedef struct {
+    const unsigned char* bitmap;    // Бітмап гліфа в glyphBuffer шрифту
+    int x, y;                       // Зсув від початку тексту (з масштабом)
+} GlyphRunGlyph;
+
+// Текст, розібраний один раз (CreatePSFGlyphRun): UTF-8 декодовано, гліфи знайдено,
+// позиції пораховано. Для незмінних підписів, які малюються кожен кадр.
+// Посилається на гліфи шрифту, тож дійсний до UnloadPSFFont
+typedef struct {
+    GlyphRunGlyph* glyphs;  // Гліфи для малювання (порожні гліфи, як пробіл, пропущено)
+    int count;              // Кількість гліфів
+    int glyph_width;        // Розмір гліфа шрифту
+    int glyph_height;
+    int scale;              // Масштаб
+    TextMetrics metrics;    // Розмір тексту, як у MeasurePSFText
+    RenderRect bounds;      // Межі клітинок усіх гліфів відносно точки малювання
+} GlyphRun;
+
 // Функція завантаження PSF шрифту з файлу за шляхом filename
 PSF_Font LoadPSFFont(const char* filename);
 
+// Завантаження PSF шрифту через mmap: гліфи не копіюються, сторінки файлу
+// спільні між процесами. Звільняється тією ж UnloadPSFFont
+PSF_Font LoadPSFFontMapped(const char* filename);
+
 // Функція звільнення пам’яті, виділеної під шрифт
 void UnloadPSFFont(PSF_Font font);
 
+// Індекс гліфа за Unicode кодом із таблиці Unicode шрифту (O(1))
+int GetPSFGlyphIndex(PSF_Font font, uint32_t codepoint);
+
 // Функція для відображення одного символу (гліфа) у позиції (x,y) заданим кольором
 void DrawPSFChar(PSF_Font font, int x, int y, int c, uint32_t color);
 
@@ -32,15 +79,57 @@ void DrawPSFText(PSF_Font font, int x, int y, const char* text, int spacing, uin
 void DrawPSFCharScaled(PSF_Font font, int x, int y, int c, int scale, uint32_t color);
 void DrawPSFTextScaled(PSF_Font font, int x, int y, const char* text, int spacing, int scale, uint32_t color);
 
-// Підрахунок кількості UTF-8 символів у рядку
-int utf8_strlen(const char* s);
+// Розмір тексту (з '\n') так, як його малює DrawPSFTextScaled (scale = 1 - як DrawPSFText).
+// Шрифт PSF моноширинний: ширина рядка - кількість символів * (glyph_width * scale + spacing) - spacing
+TextMetrics MeasurePSFText(PSF_Font font, const char* text, int spacing, int scale);
+
+// Ширини окремих рядків тексту (не більше maxLines у lineWidths), повертає кількість рядків
+int MeasurePSFTextLines(PSF_Font font, const char* text, int spacing, int scale,
+                        int* lineWidths, int maxLines);
+
+// Розкладка тексту на рядки за один прохід: зсув, довжина і ширина кожного рядка
+// (не більше maxLines у lines), повертає повну кількість рядків
+int LayoutPSFTextLines(PSF_Font font, const char* text, int spacing, int scale,
+                       TextLine* lines, int maxLines);
+
+// Малювання рядка довжиною length байтів без '\n' (наприклад, text + TextLine.start)
+void DrawPSFTextLine(PSF_Font font, int x, int y, const char* text, int length, int spacing, int scale, uint32_t color);
+
+// Розбір тексту в GlyphRun (з '\n'); малюється так само, як DrawPSFTextScaled
+// (scale = 1 - як DrawPSFText)
+GlyphRun CreatePSFGlyphRun(PSF_Font font, const char* text, int spacing, int scale);
+
+// Звільнення пам’яті GlyphRun
+void UnloadPSFGlyphRun(GlyphRun run);
+
+// Малювання GlyphRun з лівим верхнім кутом у (x, y) без декодування і пошуку гліфів.
+// GlyphRun, межі якого (bounds) поза прямокутником відсікання (PushClipRect), відкидається
+// без перебору гліфів
+void DrawPSFGlyphRun(const GlyphRun* run, int x, int y, uint32_t color);
+
+// Малювання GlyphRun у ціль target (NULL - активна ціль) горизонтальними смугами на
+// пулі потоків RenderPool: кожну смугу малює один потік, тож блокувань немає.
+// Для великих блоків тексту (журнали, довідка на весь екран) з масштабом 3-4.
+// Відсікається по PushClipRect так само, як DrawPSFGlyphRun; без активної цілі малює
+// так само, як DrawPSFGlyphRun
+void DrawPSFGlyphRunParallel(RenderTarget* target, const GlyphRun* run, int x, int y, uint32_t color);
+
+// DrawPSFTextScaled через DrawPSFGlyphRunParallel
+void DrawPSFTextScaledParallel(RenderTarget* target, PSF_Font font, int x, int y, const char* text,
+                               int spacing, int scale, uint32_t color);
 
 // Функція малювання одного символу (гліфа) у позиції (x,y) кольором color
 void DrawPSFChar(PSF_Font font, int x, int y, int c, uint32_t color);
 
 void DrawPSFCharLine(PSF_Font font, int x, int y, const char* text, int spacing, uint32_t color);
 
-// Малюємо текст з інверсним фоном та додатковою товщиною рамки (borderThickness)
+// Непрозорий текст (як у терміналі): кожен піксель прямокутника тексту (MeasurePSFText)
+// отримує колір fg або bg за один прохід по клітинках, без окремої заливки фону
+void DrawPSFTextOpaque(PSF_Font font, int x, int y, const char* text, int spacing, int scale,
+                       uint32_t fg, uint32_t bg);
+
+// Малюємо текст з інверсним фоном та додатковою товщиною рамки (borderThickness).
+// Текст малюється непрозоро (DrawPSFTextOpaque), фоном заливається лише поле padding
 void DrawPSFTextWithInvertedBackground(PSF_Font font, int x, int y, const char* text,
                                        int spacing, uint32_t textColor, int padding, int borderThickness);
 
@@ -48,4 +137,24 @@ void DrawPSFTextWithInvertedBackground(PSF_Font font, int x, int y, const char*
 void DrawPSFTextScaledWithInvertedBackground(PSF_Font font, int x, int y, const char* text,
                                              int spacing, int scale, uint32_t textColor, int padding, int borderThickness);
 
+// Те саме, що DrawPSFTextScaled, DrawPSFTextOpaque і DrawPSFTextScaledWithInvertedBackground,
+// але текст записується в кадр DamageTracker і малюється лише там, де кадр змінився
+void RecordPSFTextScaled(DamageTracker* tracker, PSF_Font font, int x, int y, const char* text,
+                         int spacing, int scale, uint32_t color);
+
+void RecordPSFTextOpaque(DamageTracker* tracker, PSF_Font font, int x, int y, const char* text,
+                         int spacing, int scale, uint32_t fg, uint32_t bg);
+
+void RecordPSFTextScaledWithInvertedBackground(DamageTracker* tracker, PSF_Font font, int x, int y,
+                                               const char* text, int spacing, int scale,
+                                               uint32_t textColor, int padding, int borderThickness);
+
+// Те саме, що DrawPSFTextScaled і DrawPSFTextOpaque, але текст записується в список
+// DrawList і малюється пакетами за шрифтом і кольором при DrawList_Flush
+void QueuePSFTextScaled(DrawList* list, PSF_Font font, int x, int y, const char* text,
+                        int spacing, int scale, uint32_t color);
+
+void QueuePSFTextOpaque(DrawList* list, PSF_Font font, int x, int y, const char* text,
+                        int spacing, int scale, uint32_t fg, uint32_t bg);
+
 #endif // PSF_FONT_H
@@ -0,0 +1,41 @@
+#ifndef TEXT_CACHE_H
+#define TEXT_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "psf_font.h"
+
+// Статистика кешу розтеризованих рядків
+typedef struct {
+    uint64_t hits;      // рядок намальовано з кешу
+    uint64_t misses;    // рядка ще не було в кеші
+    uint64_t evictions; // витіснено рядків через ліміт пам’яті
+    size_t bytes;       // пам’ять усіх записів
+    int entries;        // кількість записів
+} TextCacheStats;
+
+// Кеш рядків, розтеризованих цілком у маску 1 біт на піксель (вже з масштабом).
+// Ключ - шрифт (його гліфи), масштаб, відступ і сам рядок; колір не входить у ключ, бо маска
+// малюється будь-яким кольором. Рядок розтеризується, коли зустрічається вдруге,
+// тож змінний текст (лічильники, час) не витісняє постійні підписи
+
+// Ліміт пам’яті кешу в байтах. 0 - кеш вимкнено (за замовчуванням).
+// Зменшення ліміту одразу витісняє найдавніше використані рядки
+void TextCache_SetBudget(size_t bytes);
+
+// Видалення всіх рядків з кешу (лічильники зберігаються)
+void TextCache_Clear(void);
+
+// Статистика кешу
+TextCacheStats TextCache_GetStats(void);
+
+// Видалення рядків шрифту (викликається з UnloadPSFFont, щоб новий шрифт за тією
+// самою адресою не отримав чужих рядків)
+void TextCache_RemoveFont(PSF_Font font);
+
+// Малювання рядка з кешу (викликається з DrawPSFText і DrawPSFTextScaled).
+// Повертає 1, якщо рядок намальовано, 0 - його треба малювати по гліфах
+int TextCache_DrawText(PSF_Font font, int x, int y, const char* text,
+                       int spacing, int scale, uint32_t color);
+
+#endif // TEXT_CACHE_H
@@ -0,0 +1,47 @@
+#ifndef UTF8_H
+#define UTF8_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Код, яким замінюється некоректна або обрізана послідовність UTF-8 (U+FFFD)
+#define UTF8_REPLACEMENT 0xFFFD
+
+/*
+ * Декодування одного UTF-8 символу з початку рядка str у out_codepoint.
+ * Повертає довжину символу в байтах (1-4).
+ * Некоректна послідовність (зайві байти продовження, надлишкове кодування, сурогати,
+ * коди понад U+10FFFF, обрізаний символ) дає UTF8_REPLACEMENT і довжину 1.
+ * Байти читаються по одному, доки вони є продовженням символу, тож завершальний
+ * нуль не перескакується і пам’ять за ним не читається.
+ */
+int utf8_decode(const char* str, uint32_t* out_codepoint);
+
+// Кількість символів у рядку - стільки разів його декодує utf8_decode
+int utf8_strlen(const char* s);
+
+// Кількість символів у length байтах (так само, як utf8_strlen, але без завершального нуля)
+size_t utf8_length(const char* s, size_t length);
+
+// Довжина ASCII-префікса з length байтів (перевіряється по 16 байтів за раз)
+size_t utf8_ascii_prefix(const char* s, size_t length);
+
+/*
+ * Декодування наступного символу в циклі по тексту [str, end).
+ * *ascii_end - межа ділянки, яку utf8_ascii_prefix уже визнав ASCII (на початку циклу
+ * дорівнює початку тексту): у ній код береться прямо з байта, без виклику utf8_decode,
+ * а межа шукається по 16 байтів за раз лише тоді, коли її досягнуто.
+ * Повертає довжину символу в байтах, як utf8_decode.
+ */
+static inline int utf8_next(const char* str, const char* end, const char** ascii_end,
+                            uint32_t* out_codepoint)
+{
+    if (str >= *ascii_end) *ascii_end = str + utf8_ascii_prefix(str, (size_t)(end - str));
+    if (str < *ascii_end) {
+        *out_codepoint = (unsigned char)*str;
+        return 1;
+    }
+    return utf8_decode(str, out_codepoint);
+}
+
+#endif // UTF8_H
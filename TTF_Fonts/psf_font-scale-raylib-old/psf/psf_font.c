@@ -7,6 +7,12 @@
 #include <stdlib.h>         // Для динамічного виділення пам’яті (malloc, free)
 #include <string.h>         // Для роботи зі строками (strncpy, strtok)
 #include <math.h>           // Для роботи з  математикою (fmaxf, fminf, fmodf, fabsf, тощо)
+#ifndef _WIN32
+#include <fcntl.h>          // Для open
+#include <unistd.h>         // Для close
+#include <sys/mman.h>       // Для mmap, munmap (відображення файлу шрифту у пам’ять)
+#include <sys/stat.h>       // Для fstat (розмір файлу)
+#endif
 #include "UnicodeGlyphMap.h"// Відповідність Unicode → індекс гліфа шрифту
 
 // Магічні числа для ідентифікації форматів PSF1 і PSF2
@@ -45,33 +51,6 @@ static uint32_t ReadLE32(FILE* f) {
     return (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
 }
 
-// Функція декодування одного UTF-8 символу з рядка str
-// Записує Unicode код символу у out_codepoint
-// Повертає кількість байтів, які зайняв символ у UTF-8
-static int utf8_decode(const char* str, uint32_t* out_codepoint) {
-    unsigned char c = (unsigned char)str[0];
-    if (c < 0x80) {
-        // Однобайтовий ASCII символ
-        *out_codepoint = c;
-        return 1;
-    } else if ((c & 0xE0) == 0xC0) {
-        // Два байти UTF-8
-        *out_codepoint = ((str[0] & 0x1F) << 6) | (str[1] & 0x3F);
-        return 2;
-    } else if ((c & 0xF0) == 0xE0) {
-        // Три байти UTF-8
-        *out_codepoint = ((str[0] & 0x0F) << 12) | ((str[1] & 0x3F) << 6) | (str[2] & 0x3F);
-        return 3;
-    } else if ((c & 0xF8) == 0xF0) {
-        // Чотири байти UTF-8
-        *out_codepoint = ((str[0] & 0x07) << 18) | ((str[1] & 0x3F) << 12) | ((str[2] & 0x3F) << 6) | (str[3] & 0x3F);
-        return 4;
-    }
-    // Невідомий або некоректний символ — повертаємо 0
-    *out_codepoint = 0;
-    return 1;
-}
-
 // Розмір таблиці відповідності Unicode → індекс гліфа
 static int cyr_map_size = sizeof(cyr_map) / sizeof(cyr_map[0]);
 
@@ -90,6 +69,101 @@ static int UnicodeToGlyphIndex(uint32_t codepoint) {
     return 32;
 }
 
+// Прапорці наявності таблиці Unicode у заголовках PSF1/PSF2
+#define PSF1_MODEHASTAB 0x02
+#define PSF1_MODEHASSEQ 0x04
+#define PSF2_HAS_UNICODE_TABLE 0x01
+
+// Двохрівнева таблиця Unicode → гліф: каталог на всі 0x1100 сторінок по 256 кодів
+#define PSF_UNICODE_PAGE_SIZE  256
+#define PSF_UNICODE_PAGE_COUNT (0x110000 / PSF_UNICODE_PAGE_SIZE)
+#define PSF_UNICODE_NO_GLYPH   0xFFFF
+
+// Записує відповідність codepoint → glyph у таблицю сторінок шрифту.
+// Сторінка 0 у unicodePages завжди порожня, тому каталог без запису вказує на неї
+static void PSFUnicodeMapSet(PSF_Font* font, int* page_count, uint32_t codepoint, int glyph) {
+    if (codepoint >= 0x110000 || glyph >= PSF_UNICODE_NO_GLYPH) return;
+
+    uint16_t page = font->unicodePageDir[codepoint >> 8];
+    if (page == 0) {
+        // Нова сторінка: розширюємо пул і заповнюємо її "немає гліфа"
+        uint16_t* pages = (uint16_t*)realloc(font->unicodePages,
+                                             (size_t)(*page_count + 1) * PSF_UNICODE_PAGE_SIZE * sizeof(uint16_t));
+        if (!pages) return;
+        font->unicodePages = pages;
+        for (int i = 0; i < PSF_UNICODE_PAGE_SIZE; i++)
+            pages[*page_count * PSF_UNICODE_PAGE_SIZE + i] = PSF_UNICODE_NO_GLYPH;
+        page = (uint16_t)(*page_count)++;
+        font->unicodePageDir[codepoint >> 8] = page;
+    }
+    uint16_t* slot = &font->unicodePages[page * PSF_UNICODE_PAGE_SIZE + (codepoint & 0xFF)];
+    // Перший запис для коду має пріоритет (як у kbd/setfont)
+    if (*slot == PSF_UNICODE_NO_GLYPH) *slot = (uint16_t)glyph;
+}
+
+// Розбирає таблицю Unicode, що йде у файлі одразу після гліфів.
+// PSF1: 16-бітні коди LE, 0xFFFE - початок послідовності, 0xFFFF - кінець запису гліфа.
+// PSF2: коди у UTF-8, 0xFE - початок послідовності, 0xFF - кінець запису гліфа.
+// Послідовності (кілька кодів на один гліф) пропускаються — індексуються лише одиночні коди
+static void ParsePSFUnicodeTable(PSF_Font* font, const uint8_t* table, size_t size) {
+    font->unicodePageDir = (uint16_t*)calloc(PSF_UNICODE_PAGE_COUNT, sizeof(uint16_t));
+    font->unicodePages = (uint16_t*)malloc(PSF_UNICODE_PAGE_SIZE * sizeof(uint16_t));
+    if (!font->unicodePageDir || !font->unicodePages) {
+        free(font->unicodePageDir);
+        free(font->unicodePages);
+        font->unicodePageDir = NULL;
+        font->unicodePages = NULL;
+        return;
+    }
+    for (int i = 0; i < PSF_UNICODE_PAGE_SIZE; i++) font->unicodePages[i] = PSF_UNICODE_NO_GLYPH;
+    int page_count = 1;
+
+    size_t pos = 0;
+    for (int glyph = 0; glyph < font->glyph_count && pos < size; glyph++) {
+        int in_sequence = 0;
+        if (!font->isPSF2) {
+            while (pos + 1 < size) {
+                uint16_t uc = (uint16_t)(table[pos] | (table[pos + 1] << 8));
+                pos += 2;
+                if (uc == 0xFFFF) break;
+                if (uc == 0xFFFE) { in_sequence = 1; continue; }
+                if (!in_sequence) PSFUnicodeMapSet(font, &page_count, uc, glyph);
+            }
+        } else {
+            while (pos < size) {
+                uint8_t c = table[pos];
+                if (c == 0xFF) { pos++; break; }
+                if (c == 0xFE) { in_sequence = 1; pos++; continue; }
+
+                // Декодування UTF-8 з перевіркою меж таблиці
+                int len = (c < 0x80) ? 1 : ((c & 0xE0) == 0xC0) ? 2 :
+                          ((c & 0xF0) == 0xE0) ? 3 : ((c & 0xF8) == 0xF0) ? 4 : 1;
+                if (pos + len > size) { pos = size; break; }
+                uint32_t cp = (len == 1) ? c : (uint32_t)(c & (0x7F >> len));
+                for (int i = 1; i < len; i++) cp = (cp << 6) | (table[pos + i] & 0x3F);
+                pos += len;
+
+                if (!in_sequence) PSFUnicodeMapSet(font, &page_count, cp, glyph);
+            }
+        }
+    }
+}
+
+// Пошук індексу гліфа за Unicode кодом у таблиці конкретного шрифту — O(1).
+// Якщо шрифт не має таблиці Unicode, використовується вбудована UnicodeToGlyphIndex
+int GetPSFGlyphIndex(PSF_Font font, uint32_t codepoint) {
+    if (!font.unicodePageDir) return UnicodeToGlyphIndex(codepoint);
+
+    if (codepoint < 0x110000) {
+        uint16_t glyph = font.unicodePages[font.unicodePageDir[codepoint >> 8] * PSF_UNICODE_PAGE_SIZE +
+                                           (codepoint & 0xFF)];
+        if (glyph != PSF_UNICODE_NO_GLYPH && glyph < font.glyph_count) return glyph;
+    }
+    // Символ відсутній у шрифті — гліф пробілу
+    uint16_t space = font.unicodePages[font.unicodePageDir[0] * PSF_UNICODE_PAGE_SIZE + ' '];
+    return (space != PSF_UNICODE_NO_GLYPH && space < font.glyph_count) ? space : 32;
+}
+
 // Функція завантаження PSF шрифту з файлу filename
 PSF_Font LoadPSFFont(const char* filename) {
     FILE* f = fopen(filename, "rb");
@@ -102,6 +176,7 @@ PSF_Font LoadPSFFont(const char* filename) {
     fread(magic, 1, 4, f);  // Читаємо перші 4 байти для визначення формату
 
     PSF_Font font = {0};     // Ініціалізуємо структуру шрифту нулями
+    int has_table = 0;       // Чи містить файл таблицю Unicode після гліфів
 
     if (magic[0] == PSF1_MAGIC0 && magic[1] == PSF1_MAGIC1) {
         // Якщо формат PSF1
@@ -118,6 +193,7 @@ PSF_Font LoadPSFFont(const char* filename) {
         // Виділяємо пам’ять під гліфи та читаємо їх з файлу
         font.glyphBuffer = (unsigned char*)malloc(font.glyph_count * font.glyph_bytes);
         fread(font.glyphBuffer, font.glyph_bytes, font.glyph_count, f);
+        has_table = (header.mode & (PSF1_MODEHASTAB | PSF1_MODEHASSEQ)) != 0;
     }
     else if (magic[0] == PSF2_MAGIC0 && magic[1] == PSF2_MAGIC1 &&
              magic[2] == PSF2_MAGIC2 && magic[3] == PSF2_MAGIC3) {
@@ -147,6 +223,7 @@ PSF_Font LoadPSFFont(const char* filename) {
         // Виділяємо пам’ять і читаємо гліфи
         font.glyphBuffer = (unsigned char*)malloc(font.glyph_count * font.glyph_bytes);
         fread(font.glyphBuffer, 1, font.glyph_count * font.glyph_bytes, f);
+        has_table = (header.flags & PSF2_HAS_UNICODE_TABLE) != 0;
     }
     else {
         // Якщо формат не підтримується
@@ -155,12 +232,141 @@ PSF_Font LoadPSFFont(const char* filename) {
         exit(1);
     }
 
+    // Таблиця Unicode займає решту файлу після гліфів
+    if (has_table) {
+        long table_start = ftell(f);
+        fseek(f, 0, SEEK_END);
+        long table_size = ftell(f) - table_start;
+        if (table_start >= 0 && table_size > 0) {
+            uint8_t* table = (uint8_t*)malloc((size_t)table_size);
+            fseek(f, table_start, SEEK_SET);
+            if (table && fread(table, 1, (size_t)table_size, f) == (size_t)table_size)
+                ParsePSFUnicodeTable(&font, table, (size_t)table_size);
+            free(table);
+        }
+    }
+
     fclose(f);
     return font;
 }
 
+// Функція читання 4 байтів з пам’яті у форматі little-endian
+static uint32_t ReadLE32Mem(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Найбільша допустима ширина/висота гліфа PSF2 у пікселях
+#define PSF2_MAX_GLYPH_DIM 4096
+
+// Перевіряє заголовок PSF1/PSF2 безпосередньо у буфері data розміром size
+// і заповнює поля font. glyphBuffer вказує всередину data (без копіювання).
+// У table_offset записується зсув таблиці Unicode (0, якщо її немає).
+// Повертає 1 при успіху, 0 якщо формат не підтримується або файл обрізаний.
+static int ParsePSFHeaderInPlace(const uint8_t* data, size_t size, PSF_Font* font,
+                                 size_t* table_offset) {
+    if (size >= 4 && data[0] == PSF1_MAGIC0 && data[1] == PSF1_MAGIC1) {
+        font->isPSF2 = 0;
+        font->glyph_width = 8;
+        font->glyph_height = data[3];
+        font->glyph_bytes = data[3];
+        font->glyph_count = (data[2] & 0x01) ? 512 : 256;
+        if (font->glyph_bytes == 0 ||
+            size < 4 + (size_t)font->glyph_count * font->glyph_bytes) return 0;
+        font->glyphBuffer = (unsigned char*)(data + 4);
+        *table_offset = (data[2] & (PSF1_MODEHASTAB | PSF1_MODEHASSEQ))
+                      ? 4 + (size_t)font->glyph_count * font->glyph_bytes : 0;
+        return 1;
+    }
+    if (size >= 32 && data[0] == PSF2_MAGIC0 && data[1] == PSF2_MAGIC1 &&
+        data[2] == PSF2_MAGIC2 && data[3] == PSF2_MAGIC3) {
+        uint32_t headersize  = ReadLE32Mem(data + 8);
+        uint32_t flags       = ReadLE32Mem(data + 12);
+        uint32_t length      = ReadLE32Mem(data + 16);
+        uint32_t glyph_bytes = ReadLE32Mem(data + 20);
+        uint32_t height      = ReadLE32Mem(data + 24);
+        uint32_t width       = ReadLE32Mem(data + 28);
+
+        // Розміри обмежені, щоб добуток не переповнювався і поля int лишались додатними;
+        // гліф має вміщати всі рядки, а таблиця гліфів — файл
+        if (headersize < 32 || glyph_bytes == 0 || length > INT32_MAX ||
+            width == 0 || width > PSF2_MAX_GLYPH_DIM ||
+            height == 0 || height > PSF2_MAX_GLYPH_DIM ||
+            (uint64_t)glyph_bytes < (uint64_t)height * ((width + 7) / 8)) return 0;
+        if (headersize > size || (size - headersize) / glyph_bytes < length) return 0;
+
+        font->isPSF2 = 1;
+        font->glyph_width = (int)width;
+        font->glyph_height = (int)height;
+        font->glyph_count = (int)length;
+        font->glyph_bytes = (int)glyph_bytes;
+        font->glyphBuffer = (unsigned char*)(data + headersize);
+        *table_offset = (flags & PSF2_HAS_UNICODE_TABLE)
+                      ? headersize + (size_t)length * glyph_bytes : 0;
+        return 1;
+    }
+    return 0;
+}
+
+// Функція завантаження PSF шрифту через mmap без копіювання гліфів.
+// Файл відображається у пам’ять лише для читання (MAP_SHARED), тому кілька процесів,
+// що використовують той самий шрифт, ділять сторінки кешу ОС,
+// а glyphBuffer вказує прямо у відображення.
+PSF_Font LoadPSFFontMapped(const char* filename) {
+#ifdef _WIN32
+    // Без POSIX mmap — звичайне завантаження з копіюванням
+    return LoadPSFFont(filename);
+#else
+    PSF_Font font = {0};
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        printf("Не вдалося відкрити файл шрифту: %s\n", filename);
+        exit(1);
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        printf("Не вдалося визначити розмір файлу шрифту: %s\n", filename);
+        close(fd);
+        exit(1);
+    }
+
+    size_t size = (size_t)st.st_size;
+    void* data = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // Відображення залишається дійсним і після закриття дескриптора
+    if (data == MAP_FAILED) {
+        printf("Не вдалося відобразити файл шрифту у пам’ять: %s\n", filename);
+        exit(1);
+    }
+
+    size_t table_offset = 0;
+    if (!ParsePSFHeaderInPlace((const uint8_t*)data, size, &font, &table_offset)) {
+        printf("Формат шрифту не підтримується або файл пошкоджено\n");
+        munmap(data, size);
+        exit(1);
+    }
+
+    // Таблиця Unicode читається прямо з відображення
+    if (table_offset > 0 && table_offset < size)
+        ParsePSFUnicodeTable(&font, (const uint8_t*)data + table_offset, size - table_offset);
+
+    font.mappedData = data;
+    font.mappedSize = size;
+    return font;
+#endif
+}
+
 // Функція звільнення пам’яті, виділеної під гліфи шрифту
 void UnloadPSFFont(PSF_Font font) {
+    free(font.unicodePageDir);
+    free(font.unicodePages);
+#ifndef _WIN32
+    if (font.mappedData) {
+        // Шрифт завантажено через LoadPSFFontMapped: гліфи лежать у відображенні
+        munmap(font.mappedData, font.mappedSize);
+        return;
+    }
+#endif
     free(font.glyphBuffer);
 }
 
@@ -195,6 +401,8 @@ void DrawPSFChar(PSF_Font font, int x, int y, int c, Color color) {
 void DrawPSFText(PSF_Font font, int x, int y, const char* text, int spacing, Color color) {
     int xpos = x; // Поточна позиція по горизонталі
     int ypos = y; // Поточна позиція по вертикалі
+    const char* end = text + strlen(text);
+    const char* ascii = text;
     while (*text) {
         if (*text == '\n') {
             // Обробка переносу рядка:
@@ -205,8 +413,8 @@ void DrawPSFText(PSF_Font font, int x, int y, const char* text, int spacing, Col
             continue;
         }
         uint32_t codepoint = 0;
-        int bytes = utf8_decode(text, &codepoint); // Декодуємо один UTF-8 символ
-        int glyph_index = UnicodeToGlyphIndex(codepoint); // Знаходимо індекс гліфа
+        int bytes = utf8_next(text, end, &ascii, &codepoint); // Декодуємо один UTF-8 символ
+        int glyph_index = GetPSFGlyphIndex(font, codepoint); // Знаходимо індекс гліфа
         if (glyph_index < 0) glyph_index = 32; // Якщо символ не знайдено — замінюємо пробілом
         DrawPSFChar(font, xpos, ypos, glyph_index, color); // Малюємо символ
         xpos += font.glyph_width + spacing; // Зсуваємо позицію по x для наступного символу
@@ -240,6 +448,8 @@ void DrawPSFCharScaled(PSF_Font font, int x, int y, int c, int scale, Color colo
 void DrawPSFTextScaled(PSF_Font font, int x, int y, const char* text, int spacing, int scale, Color color) {
     int xpos = x;
     int ypos = y;
+    const char* end = text + strlen(text);
+    const char* ascii = text;
     while (*text) {
         if (*text == '\n') {
             xpos = x;
@@ -248,8 +458,8 @@ void DrawPSFTextScaled(PSF_Font font, int x, int y, const char* text, int spacin
             continue;
         }
         uint32_t codepoint = 0;
-        int bytes = utf8_decode(text, &codepoint);
-        int glyph_index = UnicodeToGlyphIndex(codepoint);
+        int bytes = utf8_next(text, end, &ascii, &codepoint);
+        int glyph_index = GetPSFGlyphIndex(font, codepoint);
         if (glyph_index < 0) glyph_index = 32;
         DrawPSFCharScaled(font, xpos, ypos, glyph_index, scale, color);
         xpos += (font.glyph_width * scale) + spacing;
@@ -257,28 +467,16 @@ void DrawPSFTextScaled(PSF_Font font, int x, int y, const char* text, int spacin
     }
 }
 
-/* strlen рахує байти, а не символи UTF-8,
- * тому для кирилиці (2-3 байти на символ) ширина вважається завищеною.
- * Використання utf8_strlen поверне правильну кількість символів. */
-int utf8_strlen(const char* s) {
-    int len = 0;
-    while (*s) {
-        uint32_t codepoint = 0;
-        int bytes = utf8_decode(s, &codepoint); // ваша функція декодування UTF-8
-        s += bytes;
-        len++;
-    }
-    return len;
-}
-
 // Малює рядок тексту без масштабування з пробілами та кирилицею
 void DrawPSFCharLine(PSF_Font font, int x, int y, const char* text, int spacing, Color color) {
     int xpos = x;
     const char* p = text;
+    const char* end = text + strlen(text);
+    const char* ascii = text;
     while (*p) {
         uint32_t codepoint = 0;
-        int bytes = utf8_decode(p, &codepoint);
-        int glyph_index = UnicodeToGlyphIndex(codepoint);
+        int bytes = utf8_next(p, end, &ascii, &codepoint);
+        int glyph_index = GetPSFGlyphIndex(font, codepoint);
         if (glyph_index < 0) glyph_index = 32;
         DrawPSFChar(font, xpos, y, glyph_index, color);
         xpos += font.glyph_width + spacing;
@@ -290,10 +488,12 @@ void DrawPSFCharLine(PSF_Font font, int x, int y, const char* text, int spacing,
 void DrawPSFCharLineScaled(PSF_Font font, int x, int y, const char* text, int spacing, int scale, Color color) {
     int xpos = x;
     const char* p = text;
+    const char* end = text + strlen(text);
+    const char* ascii = text;
     while (*p) {
         uint32_t codepoint = 0;
-        int bytes = utf8_decode(p, &codepoint);
-        int glyph_index = UnicodeToGlyphIndex(codepoint);
+        int bytes = utf8_next(p, end, &ascii, &codepoint);
+        int glyph_index = GetPSFGlyphIndex(font, codepoint);
         if (glyph_index < 0) glyph_index = 32;
         DrawPSFCharScaled(font, xpos, y, glyph_index, scale, color);
         xpos += (font.glyph_width * scale) + spacing;
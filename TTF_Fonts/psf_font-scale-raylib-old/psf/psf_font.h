@@ -4,6 +4,7 @@
 #include "raylib.h"
 #include <stdint.h>
 #include <stddef.h>
+#include "utf8.h"
 
 // Структура шрифту PSF1/PSF2
 typedef struct {
@@ -13,14 +14,25 @@ typedef struct {
     int glyph_count;            // Кількість гліфів (символів) у шрифті
     int glyph_bytes;            // Розмір одного гліфа в байтах
     unsigned char* glyphBuffer; // Вказівник на буфер з бінарними даними гліфів
+    void* mappedData;           // Відображення файлу у пам’ять (LoadPSFFontMapped) або NULL
+    size_t mappedSize;          // Розмір відображення в байтах
+    uint16_t* unicodePageDir;   // Каталог сторінок таблиці Unicode (NULL - таблиці немає)
+    uint16_t* unicodePages;     // Сторінки по 256 індексів гліфів; сторінка 0 порожня
 } PSF_Font;
 
 // Функція завантаження PSF шрифту з файлу за шляхом filename
 PSF_Font LoadPSFFont(const char* filename);
 
+// Завантаження PSF шрифту через mmap: гліфи не копіюються, сторінки файлу
+// спільні між процесами. Звільняється тією ж UnloadPSFFont
+PSF_Font LoadPSFFontMapped(const char* filename);
+
 // Функція звільнення пам’яті, виділеної під шрифт
 void UnloadPSFFont(PSF_Font font);
 
+// Індекс гліфа за Unicode кодом із таблиці Unicode шрифту (O(1))
+int GetPSFGlyphIndex(PSF_Font font, uint32_t codepoint);
+
 // Функція для відображення одного символу (гліфа) у позиції (x,y) заданим кольором
 void DrawPSFChar(PSF_Font font, int x, int y, int c, Color color);
 
@@ -30,9 +42,6 @@ void DrawPSFText(PSF_Font font, int x, int y, const char* text, int spacing, Col
 void DrawPSFCharScaled(PSF_Font font, int x, int y, int c, int scale, Color color);
 void DrawPSFTextScaled(PSF_Font font, int x, int y, const char* text, int spacing, int scale, Color color);
 
-// Підрахунок кількості UTF-8 символів у рядку
-int utf8_strlen(const char* s);
-
 // Функція малювання одного символу (гліфа) у позиції (x,y) кольором color
 void DrawPSFChar(PSF_Font font, int x, int y, int c, Color color);
 
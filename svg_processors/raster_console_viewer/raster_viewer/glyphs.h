@@ -13,6 +13,9 @@ typedef struct {
     const int* glyph_heights;
     const int* glyph_vertical_offsets;
     const int* glyph_horizontal_offsets;
+    const int16_t* glyph_ascii_lookup;
+    const uint16_t* glyph_sorted_lookup;
+    int glyph_sorted_count;
 } RasterFont;
 
 #endif // GLYPHS_H
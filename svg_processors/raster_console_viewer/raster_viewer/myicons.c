@@ -63,6 +63,23 @@ const GlyphPointerMap myicons_glyph_ptr_map[] = {
     {0x0027, myicons_glyph_0027},
 };
 
+const int16_t myicons_glyph_ascii_lookup[128] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+    0, 1, 2, 3, 4, 5, 6, 7, -1, -1, -1, -1, -1, -1, -1, -1, 
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+const uint16_t myicons_glyph_sorted_lookup[1] = {
+    0
+};
+
+const int myicons_glyph_sorted_lookup_count = 0;
+
 const int myicons_glyph_widths[8] = {
     16,
     12,
@@ -119,5 +136,8 @@ const RasterFont myicons_font = {
     .glyph_widths = myicons_glyph_widths,
     .glyph_heights = myicons_glyph_heights,
     .glyph_vertical_offsets = myicons_glyph_vertical_offsets,
-    .glyph_horizontal_offsets = myicons_glyph_horizontal_offsets
+    .glyph_horizontal_offsets = myicons_glyph_horizontal_offsets,
+    .glyph_ascii_lookup = myicons_glyph_ascii_lookup,
+    .glyph_sorted_lookup = myicons_glyph_sorted_lookup,
+    .glyph_sorted_count = myicons_glyph_sorted_lookup_count
 };
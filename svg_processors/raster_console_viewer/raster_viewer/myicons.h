@@ -12,6 +12,10 @@ extern const int myicons_glyph_bytes;
 extern const GlyphPointerMap myicons_glyph_ptr_map[];
 extern const int myicons_glyph_ptr_map_count;
 
+extern const int16_t myicons_glyph_ascii_lookup[];
+extern const uint16_t myicons_glyph_sorted_lookup[];
+extern const int myicons_glyph_sorted_lookup_count;
+
 extern const int myicons_glyph_widths[];
 extern const int myicons_glyph_heights[];
 extern const int myicons_glyph_vertical_offsets[];
@@ -82,11 +82,28 @@ void print_single_glyph(const RasterFont* font, uint32_t unicode, int scale) {
     const uint8_t* glyph_data = NULL;
     int index = -1;
     
-    for (int i = 0; i < font->glyph_count; i++) {
-        if (font->glyph_map[i].unicode == unicode) {
-            glyph_data = font->glyph_map[i].glyph;
-            index = i;
-            break;
+    if (font->glyph_ascii_lookup && font->glyph_sorted_lookup) {
+        // Згенеровані таблиці: ASCII напряму, решта - бінарний пошук
+        if (unicode < 128) {
+            index = font->glyph_ascii_lookup[unicode];
+        } else {
+            int lo = 0, hi = font->glyph_sorted_count - 1;
+            while (lo <= hi) {
+                int mid = (lo + hi) / 2;
+                int i = font->glyph_sorted_lookup[mid];
+                if (font->glyph_map[i].unicode == unicode) { index = i; break; }
+                if (font->glyph_map[i].unicode < unicode) lo = mid + 1;
+                else hi = mid - 1;
+            }
+        }
+        if (index >= 0) glyph_data = font->glyph_map[index].glyph;
+    } else {
+        for (int i = 0; i < font->glyph_count; i++) {
+            if (font->glyph_map[i].unicode == unicode) {
+                glyph_data = font->glyph_map[i].glyph;
+                index = i;
+                break;
+            }
         }
     }
     